@@ -0,0 +1,69 @@
+#include "bench_columnaccumulator.h"
+
+//2048x2048 frame with a 400x800 roi, a typical setup for a tall b-scan
+#define BENCH_SAMPLES_PER_LINE 2048
+#define BENCH_LINES_PER_FRAME 2048
+
+void BenchColumnAccumulator::benchAccumulate_data()
+{
+	QTest::addColumn<int>("bitDepth");
+	QTest::addColumn<int>("kernel");
+	QList<int> bitDepths = {8, 16, 32};
+	for (int bitDepth : bitDepths) {
+		QTest::newRow(qPrintable(QString("%1 bit scalar").arg(bitDepth))) << bitDepth << static_cast<int>(KERNEL_SCALAR);
+		QTest::newRow(qPrintable(QString("%1 bit sse2").arg(bitDepth))) << bitDepth << static_cast<int>(KERNEL_SSE2);
+		QTest::newRow(qPrintable(QString("%1 bit avx2").arg(bitDepth))) << bitDepth << static_cast<int>(KERNEL_AVX2);
+		QTest::newRow(qPrintable(QString("%1 bit avx512").arg(bitDepth))) << bitDepth << static_cast<int>(KERNEL_AVX512);
+	}
+}
+
+void BenchColumnAccumulator::benchAccumulate()
+{
+	QFETCH(int, bitDepth);
+	QFETCH(int, kernel);
+	if (!CpuFeatures::isSupported(static_cast<SIMD_KERNEL>(kernel))) {
+		QSKIP("Kernel not supported on this CPU");
+	}
+	
+	QByteArray frame(BENCH_SAMPLES_PER_LINE*BENCH_LINES_PER_FRAME*(bitDepth/8), 0);
+	for (int i = 0; i < frame.size(); i++) {
+		frame[i] = static_cast<char>(i % 251);
+	}
+	QRect roi(100, 600, 400, 800);
+	QVector<quint64> columnSums(roi.width());
+	
+	QBENCHMARK {
+		ColumnAccumulator::accumulate(frame.constData(), bitDepth, BENCH_SAMPLES_PER_LINE, roi, columnSums.data(), static_cast<SIMD_KERNEL>(kernel));
+	}
+}
+
+void BenchColumnAccumulator::benchFindPeak_data()
+{
+	QTest::addColumn<int>("bitDepth");
+	QTest::newRow("8 bit") << 8;
+	QTest::newRow("16 bit") << 16;
+	QTest::newRow("32 bit") << 32;
+}
+
+void BenchColumnAccumulator::benchFindPeak()
+{
+	QFETCH(int, bitDepth);
+	
+	PeakFinder peakFinder;
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.minThreshold = 0.0;
+	params.roi = QRect(100, 600, 400, 800);
+	params.showMinThreshold = false;
+	params.autoScalingEnabled = true;
+	peakFinder.setParams(params);
+	
+	QByteArray frame(BENCH_SAMPLES_PER_LINE*BENCH_LINES_PER_FRAME*(bitDepth/8), 0);
+	for (int i = 0; i < frame.size(); i++) {
+		frame[i] = static_cast<char>(i % 251);
+	}
+	
+	QBENCHMARK {
+		peakFinder.findPeak(frame.data(), bitDepth, BENCH_SAMPLES_PER_LINE, BENCH_LINES_PER_FRAME);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef BENCH_COLUMNACCUMULATOR_H
+#define BENCH_COLUMNACCUMULATOR_H
+
+#include <QtTest>
+#include "columnaccumulator.h"
+#include "peakfinder.h"
+
+class BenchColumnAccumulator : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void benchAccumulate_data();
+	void benchAccumulate();
+	void benchFindPeak_data();
+	void benchFindPeak();
+};
+
+#endif // BENCH_COLUMNACCUMULATOR_H
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "bench_columnintegraltable.h"
+
+//same frame and roi as the column accumulator benchmark, the build is paid once per frame, the readout once per roi
+#define BENCH_SAMPLES_PER_LINE 2048
+#define BENCH_LINES_PER_FRAME 2048
+
+void BenchColumnIntegralTable::benchBuild_data()
+{
+	QTest::addColumn<int>("bitDepth");
+	QTest::newRow("8 bit") << 8;
+	QTest::newRow("16 bit") << 16;
+	QTest::newRow("32 bit") << 32;
+}
+
+void BenchColumnIntegralTable::benchBuild()
+{
+	QFETCH(int, bitDepth);
+	
+	QByteArray frame(BENCH_SAMPLES_PER_LINE*BENCH_LINES_PER_FRAME*(bitDepth/8), 0);
+	for (int i = 0; i < frame.size(); i++) {
+		frame[i] = static_cast<char>(i % 251);
+	}
+	ColumnIntegralTable table;
+	FrameView view = FrameView::fullFrame(frame.constData(), bitDepth, BENCH_SAMPLES_PER_LINE, BENCH_LINES_PER_FRAME);
+	
+	QBENCHMARK {
+		table.build(view);
+	}
+}
+
+void BenchColumnIntegralTable::benchReadout()
+{
+	QByteArray frame(BENCH_SAMPLES_PER_LINE*BENCH_LINES_PER_FRAME*2, 0);
+	for (int i = 0; i < frame.size(); i++) {
+		frame[i] = static_cast<char>(i % 251);
+	}
+	ColumnIntegralTable table;
+	table.build(FrameView::fullFrame(frame.constData(), 16, BENCH_SAMPLES_PER_LINE, BENCH_LINES_PER_FRAME));
+	QRect roi(100, 600, 400, 800);
+	QVector<quint64> columnSums(roi.width());
+	
+	QBENCHMARK {
+		table.columnSums(roi, columnSums.data());
+	}
+}
\ No newline at end of file
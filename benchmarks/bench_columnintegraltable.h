@@ -0,0 +1,17 @@
+#ifndef BENCH_COLUMNINTEGRALTABLE_H
+#define BENCH_COLUMNINTEGRALTABLE_H
+
+#include <QtTest>
+#include "columnintegraltable.h"
+
+class BenchColumnIntegralTable : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void benchBuild_data();
+	void benchBuild();
+	void benchReadout();
+};
+
+#endif // BENCH_COLUMNINTEGRALTABLE_H
\ No newline at end of file
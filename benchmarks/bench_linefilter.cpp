@@ -0,0 +1,44 @@
+#include "bench_linefilter.h"
+
+//the filter runs once per averaged line, so its cost per frame only depends on the roi width and the kernel width
+#define BENCH_LINE_LENGTH 2048
+
+void BenchLineFilter::benchFilter_data()
+{
+	QTest::addColumn<int>("filter");
+	QTest::addColumn<int>("halfWidth");
+	QTest::addColumn<int>("kernel");
+	QList<LINE_FILTER> filters = {FILTER_BOXCAR, FILTER_SAVITZKY_GOLAY, FILTER_GAUSSIAN};
+	QStringList filterNames = {"boxcar", "savitzky-golay", "gaussian"};
+	QList<int> halfWidths = {3, 15};
+	QList<SIMD_KERNEL> kernels = {KERNEL_SCALAR, KERNEL_SSE2, KERNEL_AVX2, KERNEL_AVX512};
+	for (int i = 0; i < filters.size(); i++) {
+		for (int halfWidth : halfWidths) {
+			for (SIMD_KERNEL kernel : kernels) {
+				QString name = QString("%1 %2 %3").arg(filterNames.at(i)).arg(halfWidth).arg(CpuFeatures::getKernelName(kernel));
+				QTest::newRow(qPrintable(name)) << static_cast<int>(filters.at(i)) << halfWidth << static_cast<int>(kernel);
+			}
+		}
+	}
+}
+
+void BenchLineFilter::benchFilter()
+{
+	QFETCH(int, filter);
+	QFETCH(int, halfWidth);
+	QFETCH(int, kernel);
+	if (!CpuFeatures::isSupported(static_cast<SIMD_KERNEL>(kernel))) {
+		QSKIP("Kernel not supported on this CPU");
+	}
+	
+	LineFilter lineFilter;
+	lineFilter.setFilter(static_cast<LINE_FILTER>(filter), halfWidth);
+	QVector<qreal> line(BENCH_LINE_LENGTH);
+	for (int i = 0; i < line.size(); i++) {
+		line[i] = static_cast<qreal>(i % 251);
+	}
+	
+	QBENCHMARK {
+		lineFilter.apply(line.data(), line.size(), static_cast<SIMD_KERNEL>(kernel));
+	}
+}
\ No newline at end of file
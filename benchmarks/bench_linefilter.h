@@ -0,0 +1,16 @@
+#ifndef BENCH_LINEFILTER_H
+#define BENCH_LINEFILTER_H
+
+#include <QtTest>
+#include "linefilter.h"
+
+class BenchLineFilter : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void benchFilter_data();
+	void benchFilter();
+};
+
+#endif // BENCH_LINEFILTER_H
\ No newline at end of file
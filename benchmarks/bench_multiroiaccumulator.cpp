@@ -0,0 +1,40 @@
+#include "bench_multiroiaccumulator.h"
+
+//same frame as the column accumulator benchmark with a reference and a sample roi that share part of their rows
+#define BENCH_SAMPLES_PER_LINE 2048
+#define BENCH_LINES_PER_FRAME 2048
+
+static QVector<QRect> benchRois()
+{
+	return {QRect(100, 200, 400, 800), QRect(300, 600, 600, 1000), QRect(1200, 0, 300, 2048)};
+}
+
+void BenchMultiRoiAccumulator::benchSingleSweep()
+{
+	QByteArray frame(BENCH_SAMPLES_PER_LINE*BENCH_LINES_PER_FRAME*2, 0);
+	for (int i = 0; i < frame.size(); i++) {
+		frame[i] = static_cast<char>(i % 251);
+	}
+	QVector<QRect> rois = benchRois();
+	MultiRoiAccumulator accumulator;
+	
+	QBENCHMARK {
+		accumulator.accumulate(frame.constData(), 16, BENCH_SAMPLES_PER_LINE, rois);
+	}
+}
+
+void BenchMultiRoiAccumulator::benchSeparateRois()
+{
+	QByteArray frame(BENCH_SAMPLES_PER_LINE*BENCH_LINES_PER_FRAME*2, 0);
+	for (int i = 0; i < frame.size(); i++) {
+		frame[i] = static_cast<char>(i % 251);
+	}
+	QVector<QRect> rois = benchRois();
+	QVector<quint64> columnSums(BENCH_SAMPLES_PER_LINE);
+	
+	QBENCHMARK {
+		for (const QRect& roi : rois) {
+			ColumnAccumulator::accumulate(frame.constData(), 16, BENCH_SAMPLES_PER_LINE, roi, columnSums.data());
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#ifndef BENCH_MULTIROIACCUMULATOR_H
+#define BENCH_MULTIROIACCUMULATOR_H
+
+#include <QtTest>
+#include "multiroiaccumulator.h"
+#include "columnaccumulator.h"
+
+class BenchMultiRoiAccumulator : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void benchSingleSweep();
+	void benchSeparateRois();
+};
+
+#endif // BENCH_MULTIROIACCUMULATOR_H
\ No newline at end of file
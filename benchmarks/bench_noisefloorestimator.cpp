@@ -0,0 +1,43 @@
+#include "bench_noisefloorestimator.h"
+#include <algorithm>
+
+//averaged line of a full A-scan, the estimate runs once for every analyzed frame
+#define BENCH_LINE_LENGTH 2048
+
+static QVector<qreal> benchLine()
+{
+	QVector<qreal> line(BENCH_LINE_LENGTH);
+	for (int i = 0; i < line.size(); i++) {
+		line[i] = static_cast<qreal>((i*7919) % 1021);
+	}
+	return line;
+}
+
+void BenchNoiseFloorEstimator::benchSelection()
+{
+	QVector<qreal> line = benchLine();
+	NoiseFloorEstimator estimator;
+	
+	QBENCHMARK {
+		estimator.estimate(line.constData(), line.size(), DEFAULT_NOISE_FACTOR);
+	}
+}
+
+void BenchNoiseFloorEstimator::benchSort()
+{
+	//same estimate with two full sorts as reference for the selection
+	QVector<qreal> line = benchLine();
+	QVector<qreal> values(line.size());
+	
+	QBENCHMARK {
+		std::copy(line.constBegin(), line.constEnd(), values.begin());
+		std::sort(values.begin(), values.end());
+		qreal median = 0.5*(values.at(BENCH_LINE_LENGTH/2-1) + values.at(BENCH_LINE_LENGTH/2));
+		for (int i = 0; i < values.size(); i++) {
+			values[i] = qAbs(values.at(i) - median);
+		}
+		std::sort(values.begin(), values.end());
+		qreal mad = 0.5*(values.at(BENCH_LINE_LENGTH/2-1) + values.at(BENCH_LINE_LENGTH/2));
+		QVERIFY(median + DEFAULT_NOISE_FACTOR*mad > 0);
+	}
+}
\ No newline at end of file
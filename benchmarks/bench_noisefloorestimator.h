@@ -0,0 +1,16 @@
+#ifndef BENCH_NOISEFLOORESTIMATOR_H
+#define BENCH_NOISEFLOORESTIMATOR_H
+
+#include <QtTest>
+#include "noisefloorestimator.h"
+
+class BenchNoiseFloorEstimator : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void benchSelection();
+	void benchSort();
+};
+
+#endif // BENCH_NOISEFLOORESTIMATOR_H
\ No newline at end of file
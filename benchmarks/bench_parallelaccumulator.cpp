@@ -0,0 +1,38 @@
+#include "bench_parallelaccumulator.h"
+
+//tall 16-bit b-scan with a roi covering most of it
+#define BENCH_SAMPLES_PER_LINE 2048
+#define BENCH_LINES_PER_FRAME 4096
+
+void BenchParallelAccumulator::benchScaling_data()
+{
+	QTest::addColumn<int>("threads");
+	int idealThreadCount = qMax(1, QThread::idealThreadCount());
+	for (int threads = 1; threads < idealThreadCount; threads *= 2) {
+		QTest::newRow(qPrintable(QString("%1 threads").arg(threads))) << threads;
+	}
+	QTest::newRow(qPrintable(QString("%1 threads").arg(idealThreadCount))) << idealThreadCount;
+}
+
+void BenchParallelAccumulator::benchScaling()
+{
+	QFETCH(int, threads);
+	
+	QVector<quint16> frame(BENCH_SAMPLES_PER_LINE*BENCH_LINES_PER_FRAME);
+	for (int i = 0; i < frame.size(); i++) {
+		frame[i] = static_cast<quint16>(i % 4093);
+	}
+	QRect roi(24, 64, 2000, 3968);
+	QVector<quint64> expected(roi.width());
+	ColumnAccumulator::accumulate(frame.constData(), 16, BENCH_SAMPLES_PER_LINE, roi, expected.data());
+	
+	ParallelAccumulator parallelAccumulator(threads);
+	QVector<quint64> columnSums(roi.width());
+	int usedThreads = parallelAccumulator.accumulate(frame.constData(), 16, BENCH_SAMPLES_PER_LINE, roi, columnSums.data());
+	QCOMPARE(usedThreads, ParallelAccumulator::calculateThreadCount(roi, 16, threads));
+	QCOMPARE(columnSums, expected);
+	
+	QBENCHMARK {
+		parallelAccumulator.accumulate(frame.constData(), 16, BENCH_SAMPLES_PER_LINE, roi, columnSums.data());
+	}
+}
\ No newline at end of file
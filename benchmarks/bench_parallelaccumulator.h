@@ -0,0 +1,16 @@
+#ifndef BENCH_PARALLELACCUMULATOR_H
+#define BENCH_PARALLELACCUMULATOR_H
+
+#include <QtTest>
+#include "parallelaccumulator.h"
+
+class BenchParallelAccumulator : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void benchScaling_data();
+	void benchScaling();
+};
+
+#endif // BENCH_PARALLELACCUMULATOR_H
\ No newline at end of file
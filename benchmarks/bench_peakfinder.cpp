@@ -0,0 +1,62 @@
+#include "bench_peakfinder.h"
+
+//one full rate buffer of small frames, where the per frame overhead is in the same range as the analysis itself
+#define BENCH_SAMPLES_PER_LINE 512
+#define BENCH_LINES_PER_FRAME 64
+#define BENCH_FRAMES 256
+
+static QByteArray benchFrames()
+{
+	QByteArray frames(BENCH_SAMPLES_PER_LINE*BENCH_LINES_PER_FRAME*BENCH_FRAMES*2, 0);
+	for (int i = 0; i < frames.size(); i++) {
+		frames[i] = static_cast<char>(i % 251);
+	}
+	return frames;
+}
+
+static PeakDetectorParameters benchParams()
+{
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.minThreshold = 0.0;
+	params.roi = QRect(0, 0, BENCH_SAMPLES_PER_LINE, BENCH_LINES_PER_FRAME);
+	return params;
+}
+
+void BenchPeakFinder::benchFramesInOneCall()
+{
+	QByteArray frames = benchFrames();
+	PeakFinder peakFinder;
+	peakFinder.setParams(benchParams());
+	QVector<double> positions(BENCH_FRAMES);
+	QVector<double> amplitudes(BENCH_FRAMES);
+	QVector<quint8> flags(BENCH_FRAMES);
+	FrameView firstFrame = FrameView::fullFrame(frames.constData(), 16, BENCH_SAMPLES_PER_LINE, BENCH_LINES_PER_FRAME);
+	size_t frameStride = static_cast<size_t>(BENCH_SAMPLES_PER_LINE)*BENCH_LINES_PER_FRAME*2;
+	
+	QBENCHMARK {
+		peakFinder.findPeaksInFrames(firstFrame, BENCH_FRAMES, frameStride, positions.data(), amplitudes.data(), flags.data());
+	}
+}
+
+void BenchPeakFinder::benchFramePerSignal()
+{
+	//every frame is analyzed with findPeak and its results are delivered through queued connections like to the gui
+	QByteArray frames = benchFrames();
+	PeakFinder peakFinder;
+	peakFinder.setParams(benchParams());
+	QObject receiver;
+	double lastPosition = -1;
+	connect(&peakFinder, &PeakFinder::peakPositionFound, &receiver, [&lastPosition](double position) {lastPosition = position;}, Qt::QueuedConnection);
+	connect(&peakFinder, &PeakFinder::averagedLineCalculated, &receiver, [](QVector<qreal>) {}, Qt::QueuedConnection);
+	connect(&peakFinder, &PeakFinder::peakResultFound, &receiver, [](PeakResult) {}, Qt::QueuedConnection);
+	size_t frameStride = static_cast<size_t>(BENCH_SAMPLES_PER_LINE)*BENCH_LINES_PER_FRAME*2;
+	
+	QBENCHMARK {
+		for (int i = 0; i < BENCH_FRAMES; i++) {
+			peakFinder.findPeak(frames.data() + i*frameStride, 16, BENCH_SAMPLES_PER_LINE, BENCH_LINES_PER_FRAME);
+			QCoreApplication::processEvents();
+		}
+	}
+	QVERIFY(lastPosition >= 0);
+}
\ No newline at end of file
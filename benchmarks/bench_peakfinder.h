@@ -0,0 +1,16 @@
+#ifndef BENCH_PEAKFINDER_H
+#define BENCH_PEAKFINDER_H
+
+#include <QtTest>
+#include "peakfinder.h"
+
+class BenchPeakFinder : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void benchFramesInOneCall();
+	void benchFramePerSignal();
+};
+
+#endif // BENCH_PEAKFINDER_H
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "bench_processingchain.h"
+
+static const QList<int> benchBitDepths = {8, 12, 16, 32};
+static const QList<QSize> benchGeometries = {QSize(1024, 512), QSize(2048, 1024), QSize(4096, 2048)};
+static const QList<QSize> benchRoiSizes = {QSize(16, 16), QSize(256, 256), QSize(1024, 512), QSize(4096, 2048)};
+
+//b-scan with a reflector, speckle and noise floor like the processed buffers of OCTproZ
+static QByteArray benchFrame(int bitDepth, const QSize& geometry)
+{
+	SyntheticFrameGenerator generator(SyntheticFrameParameters::defaults(bitDepth, geometry.width(), geometry.height()));
+	return generator.generateBuffer();
+}
+
+static QString sizeName(const QSize& size)
+{
+	return QString("%1x%2").arg(size.width()).arg(size.height());
+}
+
+void BenchProcessingChain::benchAveragedLine_data()
+{
+	QTest::addColumn<int>("bitDepth");
+	QTest::addColumn<QSize>("geometry");
+	QTest::addColumn<QSize>("roiSize");
+	for (int bitDepth : benchBitDepths) {
+		for (const QSize& geometry : benchGeometries) {
+			for (const QSize& roiSize : benchRoiSizes) {
+				if (roiSize.width() > geometry.width() || roiSize.height() > geometry.height()) {
+					continue;
+				}
+				QTest::newRow(qPrintable(QString("%1 bit frame %2 roi %3").arg(bitDepth).arg(sizeName(geometry)).arg(sizeName(roiSize)))) << bitDepth << geometry << roiSize;
+			}
+		}
+	}
+}
+
+void BenchProcessingChain::benchAveragedLine()
+{
+	//the averaged line is private to PeakFinder, a single frame call of the batched entry point is the closest public
+	//path and adds only the max search and the interpolation of one line
+	QFETCH(int, bitDepth);
+	QFETCH(QSize, geometry);
+	QFETCH(QSize, roiSize);
+
+	QByteArray frame = benchFrame(bitDepth, geometry);
+	PeakFinder peakFinder;
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.minThreshold = 0.0;
+	params.roi = QRect(QPoint((geometry.width()-roiSize.width())/2, (geometry.height()-roiSize.height())/2), roiSize);
+	peakFinder.setParams(params);
+	FrameView view = FrameView::fullFrame(frame.constData(), bitDepth, geometry.width(), geometry.height());
+	double position = 0.0;
+	double amplitude = 0.0;
+	quint8 flags = 0;
+
+	BenchmarkMeasurement measurement;
+	QBENCHMARK {
+		peakFinder.findPeaksInFrames(view, 1, 0, &position, &amplitude, &flags);
+		measurement.addIteration();
+	}
+	BenchmarkReport::record(measurement, static_cast<qint64>(roiSize.width())*roiSize.height(), 1);
+}
+
+void BenchProcessingChain::benchFindMaxValuePosition_data()
+{
+	QTest::addColumn<int>("length");
+	QList<int> lengths = {16, 256, 1024, 2048, 4096};
+	for (int length : lengths) {
+		QTest::newRow(qPrintable(QString("%1 samples").arg(length))) << length;
+	}
+}
+
+void BenchProcessingChain::benchFindMaxValuePosition()
+{
+	QFETCH(int, length);
+
+	QVector<qreal> line(length);
+	for (int i = 0; i < length; i++) {
+		line[i] = static_cast<qreal>((i*7919) % 1021);
+	}
+	volatile int position = 0;
+
+	BenchmarkMeasurement measurement;
+	QBENCHMARK {
+		position = MaxSearch::findMaxValuePosition(line.constData(), length, 0.0);
+		measurement.addIteration();
+	}
+	Q_UNUSED(position)
+	BenchmarkReport::record(measurement, length, 1);
+}
+
+void BenchProcessingChain::benchConvertTo8bit_data()
+{
+	QTest::addColumn<int>("bitDepth");
+	QTest::addColumn<QSize>("geometry");
+	QList<QSize> geometries = {QSize(16, 16), QSize(256, 256)};
+	geometries.append(benchGeometries);
+	for (int bitDepth : benchBitDepths) {
+		for (const QSize& geometry : geometries) {
+			QTest::newRow(qPrintable(QString("%1 bit frame %2").arg(bitDepth).arg(sizeName(geometry)))) << bitDepth << geometry;
+		}
+	}
+}
+
+void BenchProcessingChain::benchConvertTo8bit()
+{
+	QFETCH(int, bitDepth);
+	QFETCH(QSize, geometry);
+
+	QByteArray frame = benchFrame(bitDepth, geometry);
+	int length = geometry.width()*geometry.height();
+	QVector<uchar> output(length);
+
+	BenchmarkMeasurement measurement;
+	QBENCHMARK {
+		BitDepthConverter::convertTo8bit(frame.constData(), output.data(), length, bitDepth);
+		measurement.addIteration();
+	}
+	BenchmarkReport::record(measurement, length, 1);
+}
\ No newline at end of file
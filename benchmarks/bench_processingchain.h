@@ -0,0 +1,26 @@
+#ifndef BENCH_PROCESSINGCHAIN_H
+#define BENCH_PROCESSINGCHAIN_H
+
+#include <QtTest>
+#include "peakfinder.h"
+#include "maxsearch.h"
+#include "bitdepthconverter.h"
+#include "benchmarkreport.h"
+#include "syntheticframegenerator.h"
+
+//Throughput of the per frame hot path (averaged line, max search, conversion for the display) across bit depths, roi
+//sizes and frame geometries. Results are also recorded in the BenchmarkReport, so they can be compared with a baseline.
+class BenchProcessingChain : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void benchAveragedLine_data();
+	void benchAveragedLine();
+	void benchFindMaxValuePosition_data();
+	void benchFindMaxValuePosition();
+	void benchConvertTo8bit_data();
+	void benchConvertTo8bit();
+};
+
+#endif // BENCH_PROCESSINGCHAIN_H
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include "bench_rowaggregator.h"
+
+//same frame and roi as the column accumulator benchmark, so the mean rows are the reference for the other modes
+#define BENCH_SAMPLES_PER_LINE 2048
+#define BENCH_LINES_PER_FRAME 2048
+
+void BenchRowAggregator::benchAggregate_data()
+{
+	QTest::addColumn<int>("bitDepth");
+	QTest::addColumn<int>("mode");
+	QList<int> bitDepths = {8, 16, 32};
+	for (int bitDepth : bitDepths) {
+		QTest::newRow(qPrintable(QString("%1 bit mean").arg(bitDepth))) << bitDepth << static_cast<int>(AGGREGATION_MEAN);
+		QTest::newRow(qPrintable(QString("%1 bit median").arg(bitDepth))) << bitDepth << static_cast<int>(AGGREGATION_MEDIAN);
+		QTest::newRow(qPrintable(QString("%1 bit trimmed mean").arg(bitDepth))) << bitDepth << static_cast<int>(AGGREGATION_TRIMMED_MEAN);
+		QTest::newRow(qPrintable(QString("%1 bit max").arg(bitDepth))) << bitDepth << static_cast<int>(AGGREGATION_MAX);
+	}
+}
+
+void BenchRowAggregator::benchAggregate()
+{
+	QFETCH(int, bitDepth);
+	QFETCH(int, mode);
+	
+	QByteArray frame(BENCH_SAMPLES_PER_LINE*BENCH_LINES_PER_FRAME*(bitDepth/8), 0);
+	for (int i = 0; i < frame.size(); i++) {
+		frame[i] = static_cast<char>(i % 251);
+	}
+	QRect roi(100, 600, 400, 800);
+	QVector<qreal> line(roi.width());
+	RowAggregator aggregator;
+	
+	QBENCHMARK {
+		aggregator.aggregate(frame.constData(), bitDepth, BENCH_SAMPLES_PER_LINE, roi, static_cast<ROW_AGGREGATION>(mode), DEFAULT_TRIM_FRACTION, line.data());
+	}
+}
\ No newline at end of file
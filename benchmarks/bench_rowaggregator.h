@@ -0,0 +1,16 @@
+#ifndef BENCH_ROWAGGREGATOR_H
+#define BENCH_ROWAGGREGATOR_H
+
+#include <QtTest>
+#include "rowaggregator.h"
+
+class BenchRowAggregator : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void benchAggregate_data();
+	void benchAggregate();
+};
+
+#endif // BENCH_ROWAGGREGATOR_H
\ No newline at end of file
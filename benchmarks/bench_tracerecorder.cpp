@@ -0,0 +1,31 @@
+#include "bench_tracerecorder.h"
+
+//number of traced scopes per iteration, in the range of the traced calls of one second at full rate
+#define BENCH_SCOPES 10000
+
+void BenchTraceRecorder::benchDisabledScope()
+{
+	TraceRecorder::setEnabled(false);
+	
+	QBENCHMARK {
+		for (int i = 0; i < BENCH_SCOPES; i++) {
+			TRACE_SCOPE("BenchTraceRecorder::benchDisabledScope");
+		}
+	}
+}
+
+void BenchTraceRecorder::benchEnabledScope()
+{
+	TraceRecorder::setEnabled(true);
+	
+	QBENCHMARK {
+		for (int i = 0; i < BENCH_SCOPES; i++) {
+			TRACE_SCOPE("BenchTraceRecorder::benchEnabledScope");
+		}
+	}
+}
+
+void BenchTraceRecorder::cleanup()
+{
+	TraceRecorder::setEnabled(false);
+}
\ No newline at end of file
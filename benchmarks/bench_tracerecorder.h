@@ -0,0 +1,17 @@
+#ifndef BENCH_TRACERECORDER_H
+#define BENCH_TRACERECORDER_H
+
+#include <QtTest>
+#include "tracerecorder.h"
+
+class BenchTraceRecorder : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void benchDisabledScope();
+	void benchEnabledScope();
+	void cleanup();
+};
+
+#endif // BENCH_TRACERECORDER_H
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "benchmarkreport.h"
+#include <QtTest>
+#include <QFile>
+#include <QStringList>
+#include <algorithm>
+
+QVector<BenchmarkEntry> BenchmarkReport::entries;
+QMap<QString, BenchmarkEntry> BenchmarkReport::baseline;
+
+
+void BenchmarkReport::record(const BenchmarkMeasurement& measurement, qint64 samplesPerIteration, qint64 framesPerIteration) {
+	qint64 iterations = measurement.getIterations();
+	qint64 elapsedNs = measurement.getElapsedNs();
+	if (iterations <= 0 || elapsedNs <= 0 || framesPerIteration <= 0) {
+		return;
+	}
+	QString name = QString(QTest::currentTestFunction());
+	if (QTest::currentDataTag() != nullptr) {
+		name += QString("/") + QTest::currentDataTag();
+	}
+	double nsPerIteration = static_cast<double>(elapsedNs)/static_cast<double>(iterations);
+	record(name, nsPerIteration/framesPerIteration, static_cast<double>(samplesPerIteration)/framesPerIteration);
+}
+
+void BenchmarkReport::record(const QString& name, double nsPerFrame, double samplesPerFrame) {
+	//every pass of a benchmark is kept, the reported time is the median of all passes
+	BenchmarkEntry* entry = nullptr;
+	for (BenchmarkEntry& existingEntry : entries) {
+		if (existingEntry.name == name) {
+			entry = &existingEntry;
+			break;
+		}
+	}
+	if (entry == nullptr) {
+		entries.append(BenchmarkEntry());
+		entry = &entries.last();
+		entry->name = name;
+	}
+	entry->passNsPerFrame.append(nsPerFrame);
+	entry->nsPerFrame = median(entry->passNsPerFrame);
+	entry->samplesPerSecond = entry->nsPerFrame > 0.0 ? samplesPerFrame*1.0e9/entry->nsPerFrame : 0.0;
+}
+
+double BenchmarkReport::median(QVector<double> values) {
+	if (values.isEmpty()) {
+		return 0.0;
+	}
+	std::sort(values.begin(), values.end());
+	int middle = values.size()/2;
+	return values.size() % 2 != 0 ? values.at(middle) : 0.5*(values.at(middle-1) + values.at(middle));
+}
+
+QVector<BenchmarkEntry> BenchmarkReport::getEntries() {
+	return entries;
+}
+
+void BenchmarkReport::clear() {
+	entries.clear();
+	baseline.clear();
+}
+
+bool BenchmarkReport::loadBaseline(const QString& fileName) {
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		return false;
+	}
+	baseline.clear();
+	QTextStream stream(&file);
+	stream.readLine(); //header
+	while (!stream.atEnd()) {
+		QStringList fields = stream.readLine().split(';');
+		if (fields.size() < 3) {
+			continue;
+		}
+		bool nsValid = false;
+		bool samplesValid = false;
+		BenchmarkEntry entry;
+		entry.name = fields.at(0);
+		entry.nsPerFrame = fields.at(1).toDouble(&nsValid);
+		entry.samplesPerSecond = fields.at(2).toDouble(&samplesValid);
+		if (nsValid && samplesValid) {
+			baseline.insert(entry.name, entry);
+		}
+	}
+	return true;
+}
+
+bool BenchmarkReport::saveBaseline(const QString& fileName) {
+	QFile file(fileName);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+		return false;
+	}
+	QTextStream stream(&file);
+	stream << "Benchmark;ns per frame;samples/s\n";
+	for (const BenchmarkEntry& entry : entries) {
+		stream << entry.name << ";" << QString::number(entry.nsPerFrame, 'f', 1) << ";" << QString::number(entry.samplesPerSecond, 'e', 4) << "\n";
+	}
+	return true;
+}
+
+bool BenchmarkReport::hasBaseline() {
+	return !baseline.isEmpty();
+}
+
+int BenchmarkReport::printSummary(QTextStream& stream, double tolerancePercent) {
+	int regressions = 0;
+	stream << "\n" << QString("Benchmark").leftJustified(56) << QString("ns/frame").rightJustified(14) << QString("Msamples/s").rightJustified(14);
+	if (hasBaseline()) {
+		stream << QString("baseline").rightJustified(14) << QString("change").rightJustified(10);
+	}
+	stream << "\n";
+
+	for (const BenchmarkEntry& entry : entries) {
+		stream << entry.name.leftJustified(56) << QString::number(entry.nsPerFrame, 'f', 0).rightJustified(14) << QString::number(entry.samplesPerSecond/1.0e6, 'f', 1).rightJustified(14);
+		if (baseline.contains(entry.name)) {
+			double baselineNs = baseline.value(entry.name).nsPerFrame;
+			double changePercent = baselineNs > 0.0 ? 100.0*(entry.nsPerFrame - baselineNs)/baselineNs : 0.0;
+			stream << QString::number(baselineNs, 'f', 0).rightJustified(14) << QString("%1%").arg(changePercent, 0, 'f', 1).rightJustified(10);
+			if (changePercent > tolerancePercent) {
+				stream << "  REGRESSION";
+				regressions++;
+			}
+		} else if (hasBaseline()) {
+			stream << QString("-").rightJustified(14) << QString("new").rightJustified(10);
+		}
+		stream << "\n";
+	}
+
+	if (hasBaseline()) {
+		stream << regressions << " of " << entries.size() << " benchmarks are more than " << tolerancePercent << "% slower than the baseline\n";
+	}
+	stream.flush();
+	return regressions;
+}
\ No newline at end of file
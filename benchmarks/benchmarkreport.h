@@ -0,0 +1,69 @@
+#ifndef BENCHMARKREPORT_H
+#define BENCHMARKREPORT_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QVector>
+#include <QMap>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+//a benchmark is reported as a regression if its time per frame is this many percent above the baseline
+#define DEFAULT_REGRESSION_TOLERANCE 10.0
+
+
+//Times one pass of a QBENCHMARK loop. The first iteration runs with cold caches and is only used to start the timer, so
+//the time is taken from its end to the end of the last iteration. A pass with a single iteration has no measurement.
+class BenchmarkMeasurement
+{
+public:
+	BenchmarkMeasurement() : iterations(-1) {}
+	void addIteration() {
+		if (Q_UNLIKELY(this->iterations < 0)) {
+			this->timer.start();
+		}
+		this->iterations++;
+	}
+	qint64 getIterations() const {return qMax(this->iterations, Q_INT64_C(0));}
+	qint64 getElapsedNs() const {return this->timer.isValid() ? this->timer.nsecsElapsed() : 0;}
+
+private:
+	QElapsedTimer timer;
+	qint64 iterations;
+};
+
+//nsPerFrame is the median of the passes, so a single slow pass does not turn into a regression
+struct BenchmarkEntry {
+	QString name;
+	double nsPerFrame;
+	double samplesPerSecond;
+	QVector<double> passNsPerFrame;
+};
+
+
+//Collects the throughput of all benchmarks that call record() and prints them as a table at the end of the run. QtTest
+//runs a benchmark function several times until the result is stable, every run is recorded as a pass. A
+//baseline file written by saveBaseline() can be loaded with loadBaseline(), then every entry is compared against it and
+//entries that got slower than the tolerance are marked as regressions. The file is a ';' separated table with one
+//benchmark per line, so baselines of different machines or commits can also be compared in a spreadsheet.
+class BenchmarkReport
+{
+public:
+	static void record(const BenchmarkMeasurement& measurement, qint64 samplesPerIteration, qint64 framesPerIteration);
+	static void record(const QString& name, double nsPerFrame, double samplesPerFrame);
+	static QVector<BenchmarkEntry> getEntries();
+	static void clear();
+
+	static bool loadBaseline(const QString& fileName);
+	static bool saveBaseline(const QString& fileName);
+	static bool hasBaseline();
+	static int printSummary(QTextStream& stream, double tolerancePercent);
+
+private:
+	static QVector<BenchmarkEntry> entries;
+	static QMap<QString, BenchmarkEntry> baseline;
+
+	static double median(QVector<double> values);
+};
+
+#endif // BENCHMARKREPORT_H
\ No newline at end of file
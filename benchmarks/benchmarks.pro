@@ -0,0 +1,33 @@
+QT += core gui widgets testlib
+TARGET = peakdetector-benchmarks
+TEMPLATE = app
+
+include($$PWD/../src/processing.pri)
+include($$PWD/../tests/common/common.pri)
+
+SOURCES += \
+	main.cpp \
+	benchmarkreport.cpp \
+	bench_columnaccumulator.cpp \
+	bench_parallelaccumulator.cpp \
+	bench_linefilter.cpp \
+	bench_rowaggregator.cpp \
+	bench_columnintegraltable.cpp \
+	bench_multiroiaccumulator.cpp \
+	bench_peakfinder.cpp \
+	bench_noisefloorestimator.cpp \
+	bench_tracerecorder.cpp \
+	bench_processingchain.cpp
+
+HEADERS += \
+	benchmarkreport.h \
+	bench_columnaccumulator.h \
+	bench_parallelaccumulator.h \
+	bench_linefilter.h \
+	bench_rowaggregator.h \
+	bench_columnintegraltable.h \
+	bench_multiroiaccumulator.h \
+	bench_peakfinder.h \
+	bench_noisefloorestimator.h \
+	bench_tracerecorder.h \
+	bench_processingchain.h
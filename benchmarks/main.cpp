@@ -0,0 +1,111 @@
+#include <QtTest>
+#include <QApplication>
+#include <QStringList>
+#include "benchmarkreport.h"
+#include "peakresult.h"
+#include "bench_columnaccumulator.h"
+#include "bench_parallelaccumulator.h"
+#include "bench_linefilter.h"
+#include "bench_rowaggregator.h"
+#include "bench_columnintegraltable.h"
+#include "bench_multiroiaccumulator.h"
+#include "bench_peakfinder.h"
+#include "bench_noisefloorestimator.h"
+#include "bench_tracerecorder.h"
+#include "bench_processingchain.h"
+
+//Usage: peakdetector-benchmarks [--baseline <file>] [--save-baseline <file>] [--tolerance <percent>] [QtTest options]
+//The own options are removed before the remaining arguments are passed to every QTest::qExec call.
+int main(int argc, char *argv[])
+{
+	QApplication app(argc, argv);
+	qRegisterMetaType<PeakResult>("PeakResult");
+	
+	QString baselineFile;
+	QString saveBaselineFile;
+	double tolerance = DEFAULT_REGRESSION_TOLERANCE;
+	QVector<char*> testArgs;
+	testArgs.append(argv[0]);
+	for (int i = 1; i < argc; i++) {
+		QString arg = QString::fromLocal8Bit(argv[i]);
+		if (arg == "--baseline" && i+1 < argc) {
+			baselineFile = QString::fromLocal8Bit(argv[++i]);
+		} else if (arg == "--save-baseline" && i+1 < argc) {
+			saveBaselineFile = QString::fromLocal8Bit(argv[++i]);
+		} else if (arg == "--tolerance" && i+1 < argc) {
+			tolerance = QString::fromLocal8Bit(argv[++i]).toDouble();
+		} else {
+			testArgs.append(argv[i]);
+		}
+	}
+	int testArgc = testArgs.size();
+	char** testArgv = testArgs.data();
+	
+	if (!baselineFile.isEmpty() && !BenchmarkReport::loadBaseline(baselineFile)) {
+		qWarning() << "Could not read baseline file" << baselineFile;
+		return 1;
+	}
+	
+	int status = 0;
+	
+	{
+		BenchColumnAccumulator tc;
+		status |= QTest::qExec(&tc, testArgc, testArgv);
+	}
+	
+	{
+		BenchParallelAccumulator tc;
+		status |= QTest::qExec(&tc, testArgc, testArgv);
+	}
+	
+	{
+		BenchLineFilter tc;
+		status |= QTest::qExec(&tc, testArgc, testArgv);
+	}
+	
+	{
+		BenchRowAggregator tc;
+		status |= QTest::qExec(&tc, testArgc, testArgv);
+	}
+	
+	{
+		BenchColumnIntegralTable tc;
+		status |= QTest::qExec(&tc, testArgc, testArgv);
+	}
+	
+	{
+		BenchMultiRoiAccumulator tc;
+		status |= QTest::qExec(&tc, testArgc, testArgv);
+	}
+	
+	{
+		BenchPeakFinder tc;
+		status |= QTest::qExec(&tc, testArgc, testArgv);
+	}
+	
+	{
+		BenchNoiseFloorEstimator tc;
+		status |= QTest::qExec(&tc, testArgc, testArgv);
+	}
+	
+	{
+		BenchTraceRecorder tc;
+		status |= QTest::qExec(&tc, testArgc, testArgv);
+	}
+	
+	{
+		BenchProcessingChain tc;
+		status |= QTest::qExec(&tc, testArgc, testArgv);
+	}
+	
+	QTextStream out(stdout);
+	if (BenchmarkReport::printSummary(out, tolerance) > 0) {
+		status |= 1;
+	}
+	if (!saveBaselineFile.isEmpty() && !BenchmarkReport::saveBaseline(saveBaselineFile)) {
+		qWarning() << "Could not write baseline file" << saveBaselineFile;
+		status |= 1;
+	}
+	
+	return status;
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef OCTPROZ_DEVKIT_H
+#define OCTPROZ_DEVKIT_H
+
+#include <QObject>
+#include <QString>
+#include <QVariantMap>
+#include <QWidget>
+#include <QtPlugin>
+
+
+//Stand-in for the OCTproZ_DevKit, so the extension can be built and driven without the OCTproZ host. Only the part of the
+//Plugin and Extension interfaces that extensions use is declared, with the same names and signatures as the DevKit.
+//Grabbing is disabled until the host enables it, like in OCTproZ.
+
+enum PLUGIN_TYPE {
+	SYSTEM,
+	EXTENSION
+};
+
+enum DISPLAY_STYLE {
+	SEPARATE_WINDOW,
+	DOCK
+};
+
+class Plugin : public QObject
+{
+	Q_OBJECT
+
+public:
+	Plugin() : type(EXTENSION) {}
+	virtual ~Plugin() {}
+
+	PLUGIN_TYPE getType() const {return this->type;}
+	QString getName() const {return this->name;}
+	QVariantMap getSettings() const {return this->settingsMap;}
+
+protected:
+	QString name;
+	PLUGIN_TYPE type;
+	QVariantMap settingsMap;
+
+	void setType(PLUGIN_TYPE type) {this->type = type;}
+	void setName(const QString& name) {this->name = name;}
+
+signals:
+	void info(QString);
+	void error(QString);
+	void storeSettings(QString pluginName, QVariantMap settings);
+};
+
+#define Plugin_iid "octproz.plugin.interface"
+Q_DECLARE_INTERFACE(Plugin, Plugin_iid)
+
+
+class Extension : public Plugin
+{
+	Q_OBJECT
+
+public:
+	Extension() : Plugin(), displayStyle(SEPARATE_WINDOW), rawGrabbingAllowed(false), processedGrabbingAllowed(false) {}
+	virtual ~Extension() {}
+
+	virtual QWidget* getWidget() = 0;
+	virtual void activateExtension() = 0;
+	virtual void deactivateExtension() = 0;
+	virtual void settingsLoaded(QVariantMap settings) = 0;
+
+	DISPLAY_STYLE getDisplayStyle() const {return this->displayStyle;}
+	QString getToolTip() const {return this->toolTip;}
+
+protected:
+	DISPLAY_STYLE displayStyle;
+	QString toolTip;
+	bool rawGrabbingAllowed;
+	bool processedGrabbingAllowed;
+
+public slots:
+	virtual void rawDataReceived(void* buffer, unsigned int bitDepth, unsigned int samplesPerLine, unsigned int linesPerFrame, unsigned int framesPerBuffer, unsigned int buffersPerVolume, unsigned int currentBufferNr) = 0;
+	virtual void processedDataReceived(void* buffer, unsigned int bitDepth, unsigned int samplesPerLine, unsigned int linesPerFrame, unsigned int framesPerBuffer, unsigned int buffersPerVolume, unsigned int currentBufferNr) = 0;
+	virtual void enableRawDataGrabbing(bool enable) {this->rawGrabbingAllowed = enable;}
+	virtual void enableProcessedDataGrabbing(bool enable) {this->processedGrabbingAllowed = enable;}
+};
+
+#define Extension_iid "octproz.extension.interface"
+Q_DECLARE_INTERFACE(Extension, Extension_iid)
+
+#endif //OCTPROZ_DEVKIT_H
\ No newline at end of file
@@ -0,0 +1,22 @@
+QT += core gui widgets printsupport
+TARGET = peakdetector-harness
+TEMPLATE = app
+CONFIG += console
+
+# Stub of the OCTproZ_DevKit interfaces, so the extension builds without OCTproZ
+DEVKITDIR = $$shell_path($$PWD/devkit)
+
+include($$PWD/../src/processing.pri)
+include($$PWD/../src/gui.pri)
+include($$PWD/../tests/common/common.pri)
+
+INCLUDEPATH += \
+	$$DEVKITDIR
+
+SOURCES += \
+	main.cpp \
+	headlessharness.cpp
+
+HEADERS += \
+	headlessharness.h \
+	$$DEVKITDIR/octproz_devkit.h
@@ -0,0 +1,187 @@
+#include "headlessharness.h"
+#include <QFile>
+#include <QDebug>
+#include <QTimer>
+
+
+HarnessProducer::HarnessProducer(Extension* extension, const HarnessConfig& config)
+	: QThread(),
+	extension(extension),
+	config(config),
+	sentBuffers(0),
+	lateBuffers(0),
+	elapsedNs(0),
+	stopRequested(0)
+{
+	//buffers are generated before the run, so the producer only measures the extension
+	SyntheticFrameParameters params = SyntheticFrameParameters::defaults(config.bitDepth, config.samplesPerLine, config.linesPerFrame);
+	params.framesPerBuffer = config.framesPerBuffer;
+	params.buffersPerVolume = config.buffersPerVolume;
+	params.motion = MOTION_SINE;
+	params.motionAmplitude = config.samplesPerLine/16.0;
+	params.motionPeriod = 50.0;
+	SyntheticFrameGenerator generator(params);
+	for (int i = 0; i < HARNESS_BUFFER_POOL; i++) {
+		this->buffers.append(generator.generateBuffer());
+	}
+}
+
+void HarnessProducer::run() {
+	qint64 periodNs = this->config.bufferRate > 0.0 ? static_cast<qint64>(1.0e9/this->config.bufferRate) : 0;
+	QElapsedTimer timer;
+	timer.start();
+	for (quint64 i = 0; i < this->config.bufferCount && !this->stopRequested.loadAcquire(); i++) {
+		qint64 deadlineNs = static_cast<qint64>(i)*periodNs;
+		qint64 remainingNs = deadlineNs - timer.nsecsElapsed();
+		if (remainingNs > 0) {
+			QThread::usleep(static_cast<unsigned long>(remainingNs/1000));
+		} else if (periodNs > 0 && remainingNs < -periodNs) {
+			this->lateBuffers++;
+		}
+		QByteArray& buffer = this->buffers[static_cast<int>(i % HARNESS_BUFFER_POOL)];
+		unsigned int bufferNr = this->config.buffersPerVolume > 0 ? static_cast<unsigned int>(i % this->config.buffersPerVolume) : 0;
+		this->extension->processedDataReceived(buffer.data(), this->config.bitDepth, this->config.samplesPerLine, this->config.linesPerFrame, this->config.framesPerBuffer, this->config.buffersPerVolume, bufferNr);
+		this->sentBuffers.storeRelease(i+1);
+	}
+	this->elapsedNs = timer.nsecsElapsed();
+}
+
+
+HeadlessHarness::HeadlessHarness(const HarnessConfig& config, QObject* parent)
+	: QObject(parent),
+	config(config),
+	detector(new PeakDetector()),
+	producer(nullptr),
+	recordCount(0),
+	droppedRecords(0),
+	batchCount(0),
+	resultCount(0),
+	analyzedFrames(0),
+	errorCount(0)
+{
+	this->producer = new HarnessProducer(this->detector, config);
+
+	//records are only needed for the csv output, there is one per analyzed frame at most
+	if (!config.outputFile.isEmpty()) {
+		quint64 framesPerBuffer = config.fullRate ? config.framesPerBuffer : 1;
+		this->records.resize(static_cast<int>(qMin(config.bufferCount*framesPerBuffer, static_cast<quint64>(HARNESS_MAX_RECORDS))));
+	}
+	connect(this->detector, &PeakDetector::peakBatchFound, this, &HeadlessHarness::collectBatch);
+	connect(this->detector, &PeakDetector::peakResultFound, this, [this](PeakResult) {
+		this->resultCount++;
+	});
+	connect(this->detector, &Plugin::error, this, [this](QString message) {
+		this->errorCount++;
+		qWarning().noquote() << message;
+	});
+	connect(this->detector, &Plugin::info, this, [this](QString message) {
+		if (this->config.verbose) {
+			qInfo().noquote() << message;
+		}
+	});
+	connect(this->producer, &QThread::finished, this, &HeadlessHarness::producerFinished);
+}
+
+HeadlessHarness::~HeadlessHarness() {
+	this->producer->stop();
+	this->producer->wait();
+	delete this->producer;
+	delete this->detector;
+}
+
+void HeadlessHarness::start() {
+	this->detector->settingsLoaded(this->settings());
+	this->detector->activateExtension();
+	this->detector->enableProcessedDataGrabbing(true);
+	this->producer->start();
+}
+
+QVariantMap HeadlessHarness::settings() const {
+	QVariantMap settings;
+	settings.insert(PEAKDETECTOR_SOURCE, PROCESSED);
+	settings.insert(PEAKDETECTOR_FEATURE, PARABOLIC_FIT);
+	settings.insert(PEAKDETECTOR_BUFFER, -1);
+	settings.insert(PEAKDETECTOR_FRAME, 0);
+	settings.insert(PEAKDETECTOR_ROI_X, this->config.roi.x());
+	settings.insert(PEAKDETECTOR_ROI_Y, this->config.roi.y());
+	settings.insert(PEAKDETECTOR_ROI_WIDTH, this->config.roi.width());
+	settings.insert(PEAKDETECTOR_ROI_HEIGHT, this->config.roi.height());
+	settings.insert(PEAKDETECTOR_FULL_RATE_ENABLED, this->config.fullRate);
+	settings.insert(PEAKDETECTOR_FUSED_INGEST_ENABLED, this->config.fusedIngest);
+	return settings;
+}
+
+void HeadlessHarness::collectBatch(const PeakBatch& batch) {
+	this->analyzedFrames += static_cast<quint64>(batch.frameCount);
+	this->batchCount++;
+	for (int i = 0; i < batch.frameCount; i++) {
+		if (this->recordCount >= this->records.size()) {
+			this->droppedRecords += static_cast<quint64>(this->records.isEmpty() ? 0 : batch.frameCount - i);
+			return;
+		}
+		HarnessRecord& record = this->records[this->recordCount++];
+		record.timestampNs = batch.timestampNs;
+		record.bufferNr = batch.bufferNr;
+		record.frameNr = batch.firstFrameNr + i;
+		record.position = batch.positions.at(i);
+		record.amplitude = batch.amplitudes.at(i);
+		record.flags = batch.flags.at(i);
+	}
+}
+
+void HeadlessHarness::producerFinished() {
+	//results of the last buffers are still queued in the peak finder thread
+	QTimer::singleShot(HARNESS_DRAIN_MS, this, [this]() {
+		this->detector->deactivateExtension();
+		QTextStream out(stdout);
+		this->printReport(out);
+		int status = this->errorCount > 0 ? 1 : 0;
+
+		//results without any batch mean that a path of the extension does not publish its peaks, the run is not valid
+		if (this->resultCount > 0 && this->analyzedFrames == 0) {
+			qWarning() << "Results were found, but no frame was reported as analyzed";
+			status = 1;
+		}
+		if (!this->config.outputFile.isEmpty() && !this->saveResults(this->config.outputFile)) {
+			qWarning() << "Could not write results to" << this->config.outputFile;
+			status = 1;
+		}
+		emit finished(status);
+	});
+}
+
+void HeadlessHarness::printReport(QTextStream& stream) const {
+	quint64 sentBuffers = this->producer->getSentBuffers();
+	quint64 framesPerBuffer = this->config.fullRate ? this->config.framesPerBuffer : 1;
+	quint64 offeredFrames = sentBuffers*framesPerBuffer;
+	quint64 lostFrames = this->detector->getLostFrames();
+	double seconds = this->producer->getElapsedNs()/1.0e9;
+	double samplesPerFrame = static_cast<double>(this->config.roi.width())*this->config.roi.height();
+
+	stream << "Geometry:          " << this->config.samplesPerLine << "x" << this->config.linesPerFrame << ", " << this->config.bitDepth << " bit, " << this->config.framesPerBuffer << " frames per buffer\n";
+	stream << "Buffers sent:      " << sentBuffers << " in " << QString::number(seconds, 'f', 3) << " s (" << QString::number(seconds > 0.0 ? sentBuffers/seconds : 0.0, 'f', 1) << " buffers/s, " << this->producer->getLateBuffers() << " late)\n";
+	stream << "Frames offered:    " << offeredFrames << "\n";
+	stream << "Frames analyzed:   " << this->analyzedFrames << " (" << QString::number(seconds > 0.0 ? this->analyzedFrames/seconds : 0.0, 'f', 1) << " frames/s, " << QString::number(seconds > 0.0 ? this->analyzedFrames*samplesPerFrame/seconds/1.0e6 : 0.0, 'f', 1) << " Msamples/s)\n";
+	stream << "Frames lost:       " << lostFrames << "\n";
+	stream << "Frames decimated:  " << (offeredFrames > this->analyzedFrames + lostFrames ? offeredFrames - this->analyzedFrames - lostFrames : 0) << "\n";
+	stream << "Results:           " << this->resultCount << " results, " << this->batchCount << " batches\n";
+	if (this->droppedRecords > 0) {
+		stream << "Records dropped:   " << this->droppedRecords << " (more than " << this->records.size() << " peaks)\n";
+	}
+	stream << "\n" << this->detector->getLatencyMonitor()->toCsv();
+	stream.flush();
+}
+
+bool HeadlessHarness::saveResults(const QString& fileName) const {
+	QFile file(fileName);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+		return false;
+	}
+	QTextStream stream(&file);
+	stream << "Timestamp (ns);Buffer;Frame;Position;Amplitude;Flags\n";
+	for (int i = 0; i < this->recordCount; i++) {
+		const HarnessRecord& record = this->records.at(i);
+		stream << record.timestampNs << ";" << record.bufferNr << ";" << record.frameNr << ";" << record.position << ";" << record.amplitude << ";" << static_cast<int>(record.flags) << "\n";
+	}
+	return true;
+}
\ No newline at end of file
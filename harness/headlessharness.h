@@ -0,0 +1,115 @@
+#ifndef HEADLESSHARNESS_H
+#define HEADLESSHARNESS_H
+
+#include <QObject>
+#include <QThread>
+#include <QVector>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include "peakdetector.h"
+#include "syntheticframegenerator.h"
+
+//distinct buffers the producer cycles through, so consecutive buffers do not share cache lines
+#define HARNESS_BUFFER_POOL 4
+//time after the last buffer in which results that are still queued are collected
+#define HARNESS_DRAIN_MS 500
+//upper limit of the peaks kept for the csv output, further peaks are only counted
+#define HARNESS_MAX_RECORDS (1 << 22)
+
+
+struct HarnessConfig {
+	unsigned int bitDepth;
+	unsigned int samplesPerLine;
+	unsigned int linesPerFrame;
+	unsigned int framesPerBuffer;
+	unsigned int buffersPerVolume;
+	double bufferRate;
+	quint64 bufferCount;
+	bool fullRate;
+	bool fusedIngest;
+	QRect roi;
+	QString outputFile;
+	bool verbose;
+};
+
+
+//peak of a single frame as it is written to the csv output
+struct HarnessRecord {
+	qint64 timestampNs;
+	int bufferNr;
+	int frameNr;
+	double position;
+	double amplitude;
+	quint8 flags;
+};
+
+
+//Calls processedDataReceived of the extension from its own thread, like the processing thread of OCTproZ does. Buffers
+//are sent at bufferRate per second (as fast as possible if 0) against fixed deadlines, so a slow call does not lower the
+//average rate. A producer that can not keep up counts the late buffers.
+class HarnessProducer : public QThread
+{
+	Q_OBJECT
+
+public:
+	HarnessProducer(Extension* extension, const HarnessConfig& config);
+
+	quint64 getSentBuffers() const {return this->sentBuffers.loadAcquire();}
+	quint64 getLateBuffers() const {return this->lateBuffers;}
+	qint64 getElapsedNs() const {return this->elapsedNs;}
+	void stop() {this->stopRequested.storeRelease(1);}
+
+protected:
+	void run() override;
+
+private:
+	Extension* extension;
+	HarnessConfig config;
+	QVector<QByteArray> buffers;
+	QAtomicInteger<quint64> sentBuffers;
+	quint64 lateBuffers;
+	qint64 elapsedNs;
+	QAtomicInt stopRequested;
+};
+
+
+//Drives a PeakDetector without the OCTproZ host: the extension is activated with harness settings, fed with synthetic
+//buffers by a HarnessProducer and every result it emits is collected. After the run throughput, lost frames and the
+//latency statistics of the extension are printed, the results can be saved as csv. Only the values of a batch are copied
+//into records that are allocated before the run, so collecting results neither allocates nor keeps the batches alive.
+class HeadlessHarness : public QObject
+{
+	Q_OBJECT
+
+public:
+	HeadlessHarness(const HarnessConfig& config, QObject* parent = nullptr);
+	~HeadlessHarness();
+
+	void start();
+	void printReport(QTextStream& stream) const;
+	bool saveResults(const QString& fileName) const;
+
+private:
+	HarnessConfig config;
+	PeakDetector* detector;
+	HarnessProducer* producer;
+	QVector<HarnessRecord> records;
+	int recordCount;
+	quint64 droppedRecords;
+	quint64 batchCount;
+	quint64 resultCount;
+	quint64 analyzedFrames;
+	quint64 errorCount;
+
+	QVariantMap settings() const;
+
+private slots:
+	void collectBatch(const PeakBatch& batch);
+	void producerFinished();
+
+signals:
+	void finished(int status);
+};
+
+#endif // HEADLESSHARNESS_H
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include "headlessharness.h"
+
+//Runs the PeakDetector extension without OCTproZ, e.g. under perf or valgrind:
+//peakdetector-harness --rate 200 --count 2000 --full-rate --frames 8
+int main(int argc, char *argv[])
+{
+	//no display is needed, the widgets of the extension are created but never shown
+	if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	}
+	QApplication app(argc, argv);
+	QCoreApplication::setApplicationName("peakdetector-harness");
+	
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Feeds synthetic processed buffers into the Peak Detector extension and reports throughput, lost frames and latency.");
+	parser.addHelpOption();
+	QCommandLineOption bitDepthOption("bit-depth", "Bit depth of the samples.", "bits", "16");
+	QCommandLineOption samplesOption("samples", "Samples per line.", "samples", "1024");
+	QCommandLineOption linesOption("lines", "Lines per frame.", "lines", "512");
+	QCommandLineOption framesOption("frames", "Frames per buffer.", "frames", "4");
+	QCommandLineOption buffersPerVolumeOption("buffers-per-volume", "Buffers per volume.", "buffers", "8");
+	QCommandLineOption rateOption("rate", "Buffers per second, 0 sends as fast as possible.", "rate", "100");
+	QCommandLineOption countOption("count", "Number of buffers to send.", "count", "1000");
+	QCommandLineOption fullRateOption("full-rate", "Analyze every frame of a buffer instead of only the selected one.");
+	QCommandLineOption fusedIngestOption("fused-ingest", "Accumulate the column sums of the ROI while the frames are copied (on or off).", "on|off", "on");
+	QCommandLineOption roiOption("roi", "ROI as x,y,width,height, the whole frame by default.", "roi");
+	QCommandLineOption outputOption("output", "Save every collected peak to a csv file.", "file");
+	QCommandLineOption verboseOption("verbose", "Print info messages of the extension.");
+	parser.addOptions({bitDepthOption, samplesOption, linesOption, framesOption, buffersPerVolumeOption, rateOption, countOption, fullRateOption, fusedIngestOption, roiOption, outputOption, verboseOption});
+	parser.process(app);
+	
+	HarnessConfig config;
+	config.bitDepth = parser.value(bitDepthOption).toUInt();
+	config.samplesPerLine = parser.value(samplesOption).toUInt();
+	config.linesPerFrame = parser.value(linesOption).toUInt();
+	config.framesPerBuffer = parser.value(framesOption).toUInt();
+	config.buffersPerVolume = parser.value(buffersPerVolumeOption).toUInt();
+	config.bufferRate = parser.value(rateOption).toDouble();
+	config.bufferCount = parser.value(countOption).toULongLong();
+	config.fullRate = parser.isSet(fullRateOption);
+	QString fusedIngest = parser.value(fusedIngestOption);
+	if (fusedIngest != "on" && fusedIngest != "off") {
+		qWarning() << "Fused ingest has to be on or off";
+		return 1;
+	}
+	config.fusedIngest = fusedIngest == "on";
+	config.roi = QRect(0, 0, static_cast<int>(config.samplesPerLine), static_cast<int>(config.linesPerFrame));
+	config.outputFile = parser.value(outputOption);
+	config.verbose = parser.isSet(verboseOption);
+	if (parser.isSet(roiOption)) {
+		QStringList values = parser.value(roiOption).split(',');
+		if (values.size() != 4) {
+			qWarning() << "ROI has to be given as x,y,width,height";
+			return 1;
+		}
+		config.roi = QRect(values.at(0).toInt(), values.at(1).toInt(), values.at(2).toInt(), values.at(3).toInt());
+	}
+	if (config.bitDepth == 0 || config.bitDepth > 32 || config.samplesPerLine == 0 || config.linesPerFrame == 0 || config.framesPerBuffer == 0 || config.buffersPerVolume == 0) {
+		qWarning() << "Invalid data dimensions";
+		return 1;
+	}
+	
+	HeadlessHarness harness(config);
+	QObject::connect(&harness, &HeadlessHarness::finished, &app, &QCoreApplication::exit);
+	harness.start();
+	return app.exec();
+}
\ No newline at end of file
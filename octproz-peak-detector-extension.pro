@@ -28,40 +28,11 @@ DEFINES += \
 	PEAKDETECTOR_LIBRARY \
 	QT_DEPRECATED_WARNINGS #emit warnings if depracted Qt features are used
 
-SOURCES += \
-	src/thirdparty/qcustomplot/qcustomplot.cpp \
-	src/peakdetector.cpp \
-	src/peakdetectorform.cpp \
-	src/bitdepthconverter.cpp \
-	src/imagedisplay.cpp \
-	src/lineplot.cpp \
-	src/peakfinder.cpp \
-	src/overlayitems/anchorpoint.cpp \
-	src/overlayitems/overlayitem.cpp \
-	src/overlayitems/rectoverlay.cpp
-
-HEADERS += \
-	src/thirdparty/qcustomplot/qcustomplot.h \
-	src/peakdetector.h \
-	src/peakdetectorform.h \
-	src/peakdetectorparameters.h \
-	src/bitdepthconverter.h \
-	src/imagedisplay.h \
-	src/lineplot.h \
-	src/peakfinder.h \
-	src/overlayitems/anchorpoint.h \
-	src/overlayitems/overlayitem.h \
-	src/overlayitems/rectoverlay.h
-
-FORMS +=  \
-	src/peakdetectorform.ui
+include(src/processing.pri)
+include(src/gui.pri)
 
 INCLUDEPATH += \
-	$$SHAREDIR \
-	src \
-	src/overlayitems \
-	src/thirdparty \
-	src/thirdparty/qcustomplot
+	$$SHAREDIR
 
 
 #set system specific output directory for extension
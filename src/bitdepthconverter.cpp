@@ -1,6 +1,10 @@
 #include "bitdepthconverter.h"
 #include <QtMath>
 
+#ifdef CPUFEATURES_X86
+#include <immintrin.h>
+#endif
+
 
 BitDepthConverter::BitDepthConverter(QObject *parent) : QObject(parent)
 {
@@ -18,47 +22,194 @@ BitDepthConverter::~BitDepthConverter()
 }
 
 void BitDepthConverter::convertDataTo8bit(void *inputData, int bitDepth, int samplesPerLine, int linesPerFrame) {
+	TRACE_SCOPE("BitDepthConverter::convertDataTo8bit");
 	if(!this->conversionRunning){
 		this->conversionRunning = true;
-		int length = samplesPerLine * linesPerFrame;
-
-		//check if new output8bitData-buffer needs to be created (due to resize or first time use)
-		if(this->output8bitData == nullptr || this->bitDepth != bitDepth || this->length != length){
-			if(bitDepth == 0 || length == 0){
-				emit error(tr("BitDepthConverter: Invalid data dimensions!"));
-				return;
-			}
-			this->bitDepth = bitDepth;
-			this->length = length;
-			if(this->output8bitData != nullptr){
-				free(this->output8bitData);
-				this->output8bitData = nullptr; //assign nullptr to avoid dangling pointer
-			}
-			this->output8bitData = static_cast<uchar*>(malloc(length*sizeof(uchar)));
-		}
-		//no conversion needed if inputData is already 8bit or below
-		if (bitDepth <= 8){
-			memcpy(this->output8bitData, inputData, length * sizeof(uchar));
+		bool converted = this->convert(inputData, bitDepth, samplesPerLine, linesPerFrame);
+		this->conversionRunning = false;
+
+		//inputData is not accessed anymore, so the producer can reuse it
+		emit inputDataReleased(inputData);
+
+		if(converted){
+			emit converted8bitData(output8bitData, samplesPerLine, linesPerFrame);
 		}
-		//convert to 8 bit element by element
-		else if (bitDepth >= 9 && bitDepth <=16){
-			float factor = 255 / (qPow(2,bitDepth) - 1);
-			for(int i=0; i<length; i++){
-				this->output8bitData[i] = static_cast<ushort*>(inputData)[i] * factor;
-				//this->output8bitData[i] = static_cast<uchar*>(inputData)[2*i+1]; //for 16 bit to 8 bit this is also possible
-			}
+	}else{
+		emit inputDataReleased(inputData);
+	}
+}
+
+bool BitDepthConverter::convert(void *inputData, int bitDepth, int samplesPerLine, int linesPerFrame) {
+	int length = samplesPerLine * linesPerFrame;
+
+	//check if new output8bitData-buffer needs to be created (due to resize or first time use)
+	if(this->output8bitData == nullptr || this->bitDepth != bitDepth || this->length != length){
+		if(bitDepth == 0 || length == 0){
+			emit error(tr("BitDepthConverter: Invalid data dimensions!"));
+			return false;
 		}
-		else if (bitDepth > 16 && bitDepth <=32){
-			float factor = 255 / (qPow(2,bitDepth) - 1);
-			for(int i=0; i<length; i++){
-				this->output8bitData[i] = static_cast<unsigned int*>(inputData)[i] * factor;
-			}
-		//do nothing if bit depth is out of range
-		}else{
-			return;
+		this->bitDepth = bitDepth;
+		this->length = length;
+		if(this->output8bitData != nullptr){
+			free(this->output8bitData);
+			this->output8bitData = nullptr; //assign nullptr to avoid dangling pointer
 		}
+		this->output8bitData = static_cast<uchar*>(malloc(length*sizeof(uchar)));
+	}
+	return convertTo8bit(inputData, this->output8bitData, length, bitDepth);
+}
 
-		emit converted8bitData(output8bitData, samplesPerLine, linesPerFrame);
-		this->conversionRunning = false;
+bool BitDepthConverter::convertTo8bit(const void* inputData, uchar* outputData, int length, int bitDepth) {
+	return convertTo8bit(inputData, outputData, length, bitDepth, CpuFeatures::getKernel());
+}
+
+bool BitDepthConverter::convertTo8bit(const void* inputData, uchar* outputData, int length, int bitDepth, SIMD_KERNEL kernel) {
+	//no conversion needed if inputData is already 8bit or below
+	if (bitDepth <= 8){
+		memcpy(outputData, inputData, length * sizeof(uchar));
+	}
+	//convert to 8 bit element by element
+	else if (bitDepth >= 9 && bitDepth <=16){
+		float factor = 255 / (qPow(2,bitDepth) - 1);
+		convert<quint16>(static_cast<const quint16*>(inputData), outputData, length, factor, kernel);
+	}
+	else if (bitDepth > 16 && bitDepth <=32){
+		float factor = 255 / (qPow(2,bitDepth) - 1);
+		convert<quint32>(static_cast<const quint32*>(inputData), outputData, length, factor, kernel);
+	//do nothing if bit depth is out of range
+	}else{
+		return false;
+	}
+
+	return true;
+}
+
+template<typename T>
+void BitDepthConverter::convert(const T* inputData, uchar* outputData, int length, float factor, SIMD_KERNEL kernel) {
+	//vector kernels use the same single precision multiplication and truncation as the scalar loop, so results are identical
+	int i = 0;
+#ifdef CPUFEATURES_X86
+	if (kernel == KERNEL_AVX512) {
+		i = convertAvx512(inputData, outputData, length, factor);
+	} else if (kernel == KERNEL_AVX2) {
+		i = convertAvx2(inputData, outputData, length, factor);
+	} else if (kernel == KERNEL_SSE2) {
+		i = convertSse2(inputData, outputData, length, factor);
+	}
+#else
+	Q_UNUSED(kernel)
+#endif
+	for(; i<length; i++){
+		outputData[i] = inputData[i] * factor;
+	}
+}
+
+#ifdef CPUFEATURES_X86
+//The vector kernels convert 16 samples per iteration and return the number of converted samples. Scaled values are
+//truncated to 32 bit integers and only the lowest byte is kept, just like the implicit float to uchar conversion.
+
+TARGET_SSE2 static inline __m128i scaleSse2(__m128 values, __m128 factor) {
+	return _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(values, factor)), _mm_set1_epi32(0xFF));
+}
+
+TARGET_SSE2 static inline __m128 unsignedToFloatSse2(__m128i values) {
+	//cvtepi32_ps interprets values as signed. Upper and lower half words are converted exactly and rounded only once when added
+	__m128 high = _mm_cvtepi32_ps(_mm_srli_epi32(values, 16));
+	__m128 low = _mm_cvtepi32_ps(_mm_and_si128(values, _mm_set1_epi32(0xFFFF)));
+	return _mm_add_ps(_mm_mul_ps(high, _mm_set1_ps(65536.0f)), low);
+}
+
+TARGET_SSE2 int BitDepthConverter::convertSse2(const quint16* inputData, uchar* outputData, int length, float factor) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 scale = _mm_set1_ps(factor);
+	int i = 0;
+	for (; i + 16 <= length; i += 16) {
+		__m128i samplesA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inputData + i));
+		__m128i samplesB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inputData + i + 8));
+		__m128i a0 = scaleSse2(_mm_cvtepi32_ps(_mm_unpacklo_epi16(samplesA, zero)), scale);
+		__m128i a1 = scaleSse2(_mm_cvtepi32_ps(_mm_unpackhi_epi16(samplesA, zero)), scale);
+		__m128i b0 = scaleSse2(_mm_cvtepi32_ps(_mm_unpacklo_epi16(samplesB, zero)), scale);
+		__m128i b1 = scaleSse2(_mm_cvtepi32_ps(_mm_unpackhi_epi16(samplesB, zero)), scale);
+		__m128i bytes = _mm_packus_epi16(_mm_packs_epi32(a0, a1), _mm_packs_epi32(b0, b1));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outputData + i), bytes);
+	}
+	return i;
+}
+
+TARGET_SSE2 int BitDepthConverter::convertSse2(const quint32* inputData, uchar* outputData, int length, float factor) {
+	const __m128 scale = _mm_set1_ps(factor);
+	int i = 0;
+	for (; i + 16 <= length; i += 16) {
+		const __m128i* input = reinterpret_cast<const __m128i*>(inputData + i);
+		__m128i a0 = scaleSse2(unsignedToFloatSse2(_mm_loadu_si128(input)), scale);
+		__m128i a1 = scaleSse2(unsignedToFloatSse2(_mm_loadu_si128(input + 1)), scale);
+		__m128i b0 = scaleSse2(unsignedToFloatSse2(_mm_loadu_si128(input + 2)), scale);
+		__m128i b1 = scaleSse2(unsignedToFloatSse2(_mm_loadu_si128(input + 3)), scale);
+		__m128i bytes = _mm_packus_epi16(_mm_packs_epi32(a0, a1), _mm_packs_epi32(b0, b1));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outputData + i), bytes);
+	}
+	return i;
+}
+
+TARGET_AVX2 static inline __m128i packAvx2(__m256i a, __m256i b) {
+	__m128i low = _mm_packs_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+	__m128i high = _mm_packs_epi32(_mm256_castsi256_si128(b), _mm256_extracti128_si256(b, 1));
+	return _mm_packus_epi16(low, high);
+}
+
+TARGET_AVX2 static inline __m256i scaleAvx2(__m256 values, __m256 factor) {
+	return _mm256_and_si256(_mm256_cvttps_epi32(_mm256_mul_ps(values, factor)), _mm256_set1_epi32(0xFF));
+}
+
+TARGET_AVX2 static inline __m256 unsignedToFloatAvx2(__m256i values) {
+	__m256 high = _mm256_cvtepi32_ps(_mm256_srli_epi32(values, 16));
+	__m256 low = _mm256_cvtepi32_ps(_mm256_and_si256(values, _mm256_set1_epi32(0xFFFF)));
+	return _mm256_add_ps(_mm256_mul_ps(high, _mm256_set1_ps(65536.0f)), low);
+}
+
+TARGET_AVX2 int BitDepthConverter::convertAvx2(const quint16* inputData, uchar* outputData, int length, float factor) {
+	const __m256 scale = _mm256_set1_ps(factor);
+	int i = 0;
+	for (; i + 16 <= length; i += 16) {
+		const __m128i* input = reinterpret_cast<const __m128i*>(inputData + i);
+		__m256i a = scaleAvx2(_mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128(input))), scale);
+		__m256i b = scaleAvx2(_mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128(input + 1))), scale);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outputData + i), packAvx2(a, b));
+	}
+	return i;
+}
+
+TARGET_AVX2 int BitDepthConverter::convertAvx2(const quint32* inputData, uchar* outputData, int length, float factor) {
+	const __m256 scale = _mm256_set1_ps(factor);
+	int i = 0;
+	for (; i + 16 <= length; i += 16) {
+		const __m256i* input = reinterpret_cast<const __m256i*>(inputData + i);
+		__m256i a = scaleAvx2(unsignedToFloatAvx2(_mm256_loadu_si256(input)), scale);
+		__m256i b = scaleAvx2(unsignedToFloatAvx2(_mm256_loadu_si256(input + 1)), scale);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outputData + i), packAvx2(a, b));
+	}
+	return i;
+}
+
+TARGET_AVX512 int BitDepthConverter::convertAvx512(const quint16* inputData, uchar* outputData, int length, float factor) {
+	const __m512 scale = _mm512_set1_ps(factor);
+	int i = 0;
+	for (; i + 16 <= length; i += 16) {
+		__m512 values = _mm512_cvtepi32_ps(_mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(inputData + i))));
+		__m512i scaled = _mm512_cvttps_epi32(_mm512_mul_ps(values, scale));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outputData + i), _mm512_cvtepi32_epi8(scaled));
+	}
+	return i;
+}
+
+TARGET_AVX512 int BitDepthConverter::convertAvx512(const quint32* inputData, uchar* outputData, int length, float factor) {
+	const __m512 scale = _mm512_set1_ps(factor);
+	int i = 0;
+	for (; i + 16 <= length; i += 16) {
+		__m512 values = _mm512_cvtepu32_ps(_mm512_loadu_si512(inputData + i));
+		__m512i scaled = _mm512_cvttps_epi32(_mm512_mul_ps(values, scale));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outputData + i), _mm512_cvtepi32_epi8(scaled));
 	}
+	return i;
 }
+#endif
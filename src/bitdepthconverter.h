@@ -2,6 +2,8 @@
 #define BITDEPTHCONVERTER_H
 
 #include <QObject>
+#include "cpufeatures.h"
+#include "tracerecorder.h"
 
 class BitDepthConverter : public QObject
 {
@@ -10,17 +12,32 @@ public:
 	explicit BitDepthConverter(QObject *parent = nullptr);
 	~BitDepthConverter();
 
+	static bool convertTo8bit(const void* inputData, uchar* outputData, int length, int bitDepth);
+	static bool convertTo8bit(const void* inputData, uchar* outputData, int length, int bitDepth, SIMD_KERNEL kernel);
+
 private:
 	uchar* output8bitData;
 	int bitDepth;
 	int length;
 	bool conversionRunning;
 
+	bool convert(void *inputData, int bitDepth, int samplesPerLine, int linesPerFrame);
+#ifdef CPUFEATURES_X86
+	static int convertSse2(const quint16* inputData, uchar* outputData, int length, float factor);
+	static int convertSse2(const quint32* inputData, uchar* outputData, int length, float factor);
+	static int convertAvx2(const quint16* inputData, uchar* outputData, int length, float factor);
+	static int convertAvx2(const quint32* inputData, uchar* outputData, int length, float factor);
+	static int convertAvx512(const quint16* inputData, uchar* outputData, int length, float factor);
+	static int convertAvx512(const quint32* inputData, uchar* outputData, int length, float factor);
+#endif
+	template <typename T> static void convert(const T* inputData, uchar* outputData, int length, float factor, SIMD_KERNEL kernel);
+
 public slots:
 	void convertDataTo8bit(void *inputData, int bitDepth, int samplesPerLine, int linesPerFrame);
 
 signals:
 	void converted8bitData(uchar *output8bitData, unsigned int samplesPerLine, unsigned int linesPerFrame);
+	void inputDataReleased(void *inputData);
 	void info(QString);
 	void error(QString);
 };
@@ -0,0 +1,321 @@
+#include "columnaccumulator.h"
+#include <cstring>
+
+#ifdef CPUFEATURES_X86
+#include <immintrin.h>
+#endif
+
+
+void ColumnAccumulator::accumulate(const void* data, unsigned int bitDepth, size_t stride, const QRect& roi, quint64* columnSums) {
+	accumulate(data, bitDepth, stride, roi, columnSums, CpuFeatures::getKernel());
+}
+
+void ColumnAccumulator::accumulate(const void* data, unsigned int bitDepth, size_t stride, const QRect& roi, quint64* columnSums, SIMD_KERNEL kernel) {
+	if (roi.width() <= 0 || roi.height() <= 0) {
+		return;
+	}
+	memset(columnSums, 0, static_cast<size_t>(roi.width())*sizeof(quint64));
+
+	if (bitDepth <= 8) {
+		accumulate<quint8>(static_cast<const quint8*>(data), stride, roi, columnSums, kernel);
+	} else if (bitDepth > 8 && bitDepth <= 16) {
+		accumulate<quint16>(static_cast<const quint16*>(data), stride, roi, columnSums, kernel);
+	} else if (bitDepth > 16 && bitDepth <= 32) {
+		accumulate<quint32>(static_cast<const quint32*>(data), stride, roi, columnSums, kernel);
+	}
+}
+
+template<typename T>
+void ColumnAccumulator::accumulate(const T* data, size_t stride, const QRect& roi, quint64* columnSums, SIMD_KERNEL kernel) {
+	//vector kernels process as many full strips of columns as possible, the remaining columns are summed up by the scalar loop
+	int processedColumns = 0;
+#ifdef CPUFEATURES_X86
+	if (kernel == KERNEL_AVX512) {
+		processedColumns = accumulateAvx512(data, stride, roi, columnSums);
+	} else if (kernel == KERNEL_AVX2) {
+		processedColumns = accumulateAvx2(data, stride, roi, columnSums);
+	} else if (kernel == KERNEL_SSE2) {
+		processedColumns = accumulateSse2(data, stride, roi, columnSums);
+	}
+#else
+	Q_UNUSED(kernel)
+#endif
+	if (processedColumns < roi.width()) {
+		QRect remainingRoi(roi.x() + processedColumns, roi.y(), roi.width() - processedColumns, roi.height());
+		accumulateScalar<T>(data, stride, remainingRoi, columnSums + processedColumns);
+	}
+}
+
+template<typename T>
+void ColumnAccumulator::accumulateScalar(const T* data, size_t stride, const QRect& roi, quint64* columnSums) {
+	int roiWidth = roi.width();
+	int endY = roi.y() + roi.height();
+
+	//walk through ROI rows only, every row is read exactly once
+	for (int y = roi.y(); y < endY; ++y) {
+		const T* row = data + static_cast<size_t>(y)*stride + roi.x();
+		for (int x = 0; x < roiWidth; ++x) {
+			columnSums[x] += row[x];
+		}
+	}
+}
+
+#ifdef CPUFEATURES_X86
+//The vector kernels walk down strips of 64 bytes (one cache line, two for avx-512) per row and keep the partial sums of
+//the strip in registers. Wider lanes are obtained by unpacking (sse2) or zero extending (avx2, avx-512) the loaded samples.
+
+TARGET_SSE2 int ColumnAccumulator::accumulateSse2(const quint8* data, size_t stride, const QRect& roi, quint64* columnSums) {
+	const __m128i zero = _mm_setzero_si128();
+	int roiHeight = roi.height();
+	int x = 0;
+	for (; x + 64 <= roi.width(); x += 64) {
+		const quint8* strip = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		int y = 0;
+		while (y < roiHeight) {
+			__m128i sums[8];
+			for (int i = 0; i < 8; i++) {
+				sums[i] = zero;
+			}
+			int endY = qMin(roiHeight, y + ACCUMULATOR_ROWS_8BIT);
+			for (; y < endY; ++y) {
+				const __m128i* row = reinterpret_cast<const __m128i*>(strip + static_cast<size_t>(y)*stride);
+				for (int i = 0; i < 4; i++) {
+					__m128i samples = _mm_loadu_si128(row + i);
+					sums[2*i] = _mm_add_epi16(sums[2*i], _mm_unpacklo_epi8(samples, zero));
+					sums[2*i+1] = _mm_add_epi16(sums[2*i+1], _mm_unpackhi_epi8(samples, zero));
+				}
+			}
+			alignas(16) quint16 lanes[64];
+			for (int i = 0; i < 8; i++) {
+				_mm_store_si128(reinterpret_cast<__m128i*>(lanes) + i, sums[i]);
+			}
+			for (int i = 0; i < 64; i++) {
+				columnSums[x + i] += lanes[i];
+			}
+		}
+	}
+	return x;
+}
+
+TARGET_SSE2 int ColumnAccumulator::accumulateSse2(const quint16* data, size_t stride, const QRect& roi, quint64* columnSums) {
+	const __m128i zero = _mm_setzero_si128();
+	int roiHeight = roi.height();
+	int x = 0;
+	for (; x + 32 <= roi.width(); x += 32) {
+		const quint16* strip = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		int y = 0;
+		while (y < roiHeight) {
+			__m128i sums[8];
+			for (int i = 0; i < 8; i++) {
+				sums[i] = zero;
+			}
+			int endY = qMin(roiHeight, y + ACCUMULATOR_ROWS_16BIT);
+			for (; y < endY; ++y) {
+				const __m128i* row = reinterpret_cast<const __m128i*>(strip + static_cast<size_t>(y)*stride);
+				for (int i = 0; i < 4; i++) {
+					__m128i samples = _mm_loadu_si128(row + i);
+					sums[2*i] = _mm_add_epi32(sums[2*i], _mm_unpacklo_epi16(samples, zero));
+					sums[2*i+1] = _mm_add_epi32(sums[2*i+1], _mm_unpackhi_epi16(samples, zero));
+				}
+			}
+			alignas(16) quint32 lanes[32];
+			for (int i = 0; i < 8; i++) {
+				_mm_store_si128(reinterpret_cast<__m128i*>(lanes) + i, sums[i]);
+			}
+			for (int i = 0; i < 32; i++) {
+				columnSums[x + i] += lanes[i];
+			}
+		}
+	}
+	return x;
+}
+
+TARGET_SSE2 int ColumnAccumulator::accumulateSse2(const quint32* data, size_t stride, const QRect& roi, quint64* columnSums) {
+	const __m128i zero = _mm_setzero_si128();
+	int roiHeight = roi.height();
+	int x = 0;
+	for (; x + 16 <= roi.width(); x += 16) {
+		const quint32* strip = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		__m128i sums[8];
+		for (int i = 0; i < 8; i++) {
+			sums[i] = zero;
+		}
+		//64-bit lanes can not overflow for any realistic number of rows
+		for (int y = 0; y < roiHeight; ++y) {
+			const __m128i* row = reinterpret_cast<const __m128i*>(strip + static_cast<size_t>(y)*stride);
+			for (int i = 0; i < 4; i++) {
+				__m128i samples = _mm_loadu_si128(row + i);
+				sums[2*i] = _mm_add_epi64(sums[2*i], _mm_unpacklo_epi32(samples, zero));
+				sums[2*i+1] = _mm_add_epi64(sums[2*i+1], _mm_unpackhi_epi32(samples, zero));
+			}
+		}
+		for (int i = 0; i < 8; i++) {
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(columnSums + x) + i, sums[i]);
+		}
+	}
+	return x;
+}
+
+TARGET_AVX2 int ColumnAccumulator::accumulateAvx2(const quint8* data, size_t stride, const QRect& roi, quint64* columnSums) {
+	int roiHeight = roi.height();
+	int x = 0;
+	for (; x + 64 <= roi.width(); x += 64) {
+		const quint8* strip = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		int y = 0;
+		while (y < roiHeight) {
+			__m256i sums[4];
+			for (int i = 0; i < 4; i++) {
+				sums[i] = _mm256_setzero_si256();
+			}
+			int endY = qMin(roiHeight, y + ACCUMULATOR_ROWS_8BIT);
+			for (; y < endY; ++y) {
+				const __m128i* row = reinterpret_cast<const __m128i*>(strip + static_cast<size_t>(y)*stride);
+				for (int i = 0; i < 4; i++) {
+					sums[i] = _mm256_add_epi16(sums[i], _mm256_cvtepu8_epi16(_mm_loadu_si128(row + i)));
+				}
+			}
+			alignas(32) quint16 lanes[64];
+			for (int i = 0; i < 4; i++) {
+				_mm256_store_si256(reinterpret_cast<__m256i*>(lanes) + i, sums[i]);
+			}
+			for (int i = 0; i < 64; i++) {
+				columnSums[x + i] += lanes[i];
+			}
+		}
+	}
+	return x;
+}
+
+TARGET_AVX2 int ColumnAccumulator::accumulateAvx2(const quint16* data, size_t stride, const QRect& roi, quint64* columnSums) {
+	int roiHeight = roi.height();
+	int x = 0;
+	for (; x + 32 <= roi.width(); x += 32) {
+		const quint16* strip = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		int y = 0;
+		while (y < roiHeight) {
+			__m256i sums[4];
+			for (int i = 0; i < 4; i++) {
+				sums[i] = _mm256_setzero_si256();
+			}
+			int endY = qMin(roiHeight, y + ACCUMULATOR_ROWS_16BIT);
+			for (; y < endY; ++y) {
+				const __m128i* row = reinterpret_cast<const __m128i*>(strip + static_cast<size_t>(y)*stride);
+				for (int i = 0; i < 4; i++) {
+					sums[i] = _mm256_add_epi32(sums[i], _mm256_cvtepu16_epi32(_mm_loadu_si128(row + i)));
+				}
+			}
+			alignas(32) quint32 lanes[32];
+			for (int i = 0; i < 4; i++) {
+				_mm256_store_si256(reinterpret_cast<__m256i*>(lanes) + i, sums[i]);
+			}
+			for (int i = 0; i < 32; i++) {
+				columnSums[x + i] += lanes[i];
+			}
+		}
+	}
+	return x;
+}
+
+TARGET_AVX2 int ColumnAccumulator::accumulateAvx2(const quint32* data, size_t stride, const QRect& roi, quint64* columnSums) {
+	int roiHeight = roi.height();
+	int x = 0;
+	for (; x + 16 <= roi.width(); x += 16) {
+		const quint32* strip = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		__m256i sums[4];
+		for (int i = 0; i < 4; i++) {
+			sums[i] = _mm256_setzero_si256();
+		}
+		for (int y = 0; y < roiHeight; ++y) {
+			const __m128i* row = reinterpret_cast<const __m128i*>(strip + static_cast<size_t>(y)*stride);
+			for (int i = 0; i < 4; i++) {
+				sums[i] = _mm256_add_epi64(sums[i], _mm256_cvtepu32_epi64(_mm_loadu_si128(row + i)));
+			}
+		}
+		for (int i = 0; i < 4; i++) {
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(columnSums + x) + i, sums[i]);
+		}
+	}
+	return x;
+}
+TARGET_AVX512 int ColumnAccumulator::accumulateAvx512(const quint8* data, size_t stride, const QRect& roi, quint64* columnSums) {
+	int roiHeight = roi.height();
+	int x = 0;
+	for (; x + 128 <= roi.width(); x += 128) {
+		const quint8* strip = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		int y = 0;
+		while (y < roiHeight) {
+			__m512i sums[4];
+			for (int i = 0; i < 4; i++) {
+				sums[i] = _mm512_setzero_si512();
+			}
+			int endY = qMin(roiHeight, y + ACCUMULATOR_ROWS_8BIT);
+			for (; y < endY; ++y) {
+				const __m256i* row = reinterpret_cast<const __m256i*>(strip + static_cast<size_t>(y)*stride);
+				for (int i = 0; i < 4; i++) {
+					sums[i] = _mm512_add_epi16(sums[i], _mm512_cvtepu8_epi16(_mm256_loadu_si256(row + i)));
+				}
+			}
+			alignas(64) quint16 lanes[128];
+			for (int i = 0; i < 4; i++) {
+				_mm512_store_si512(reinterpret_cast<__m512i*>(lanes) + i, sums[i]);
+			}
+			for (int i = 0; i < 128; i++) {
+				columnSums[x + i] += lanes[i];
+			}
+		}
+	}
+	return x;
+}
+
+TARGET_AVX512 int ColumnAccumulator::accumulateAvx512(const quint16* data, size_t stride, const QRect& roi, quint64* columnSums) {
+	int roiHeight = roi.height();
+	int x = 0;
+	for (; x + 64 <= roi.width(); x += 64) {
+		const quint16* strip = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		int y = 0;
+		while (y < roiHeight) {
+			__m512i sums[4];
+			for (int i = 0; i < 4; i++) {
+				sums[i] = _mm512_setzero_si512();
+			}
+			int endY = qMin(roiHeight, y + ACCUMULATOR_ROWS_16BIT);
+			for (; y < endY; ++y) {
+				const __m256i* row = reinterpret_cast<const __m256i*>(strip + static_cast<size_t>(y)*stride);
+				for (int i = 0; i < 4; i++) {
+					sums[i] = _mm512_add_epi32(sums[i], _mm512_cvtepu16_epi32(_mm256_loadu_si256(row + i)));
+				}
+			}
+			alignas(64) quint32 lanes[64];
+			for (int i = 0; i < 4; i++) {
+				_mm512_store_si512(reinterpret_cast<__m512i*>(lanes) + i, sums[i]);
+			}
+			for (int i = 0; i < 64; i++) {
+				columnSums[x + i] += lanes[i];
+			}
+		}
+	}
+	return x;
+}
+
+TARGET_AVX512 int ColumnAccumulator::accumulateAvx512(const quint32* data, size_t stride, const QRect& roi, quint64* columnSums) {
+	int roiHeight = roi.height();
+	int x = 0;
+	for (; x + 32 <= roi.width(); x += 32) {
+		const quint32* strip = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		__m512i sums[4];
+		for (int i = 0; i < 4; i++) {
+			sums[i] = _mm512_setzero_si512();
+		}
+		for (int y = 0; y < roiHeight; ++y) {
+			const __m256i* row = reinterpret_cast<const __m256i*>(strip + static_cast<size_t>(y)*stride);
+			for (int i = 0; i < 4; i++) {
+				sums[i] = _mm512_add_epi64(sums[i], _mm512_cvtepu32_epi64(_mm256_loadu_si256(row + i)));
+			}
+		}
+		for (int i = 0; i < 4; i++) {
+			_mm512_storeu_si512(reinterpret_cast<__m512i*>(columnSums + x) + i, sums[i]);
+		}
+	}
+	return x;
+}
+#endif
@@ -0,0 +1,40 @@
+#ifndef COLUMNACCUMULATOR_H
+#define COLUMNACCUMULATOR_H
+
+#include <QtGlobal>
+#include <QRect>
+#include "cpufeatures.h"
+
+//number of 8-bit rows that can be summed up in 16-bit lanes (255*257 = 65535) and 16-bit rows in 32-bit lanes before the lanes have to be flushed
+#define ACCUMULATOR_ROWS_8BIT 256
+#define ACCUMULATOR_ROWS_16BIT 65536
+
+
+//Sums up all rows of a ROI column by column. Only the ROI rows of the frame are read, so this can be used directly on the
+//buffer provided by OCTproZ without copying the whole frame first. The roi is given relative to data, consecutive lines
+//are stride samples apart. The roi has to lie within the buffer and columnSums needs space for roi.width() values.
+//Samples are summed up in integer lanes of twice their width which are flushed into the 64-bit column sums before they
+//can overflow, so all kernels produce exactly the same result.
+class ColumnAccumulator
+{
+public:
+	static void accumulate(const void* data, unsigned int bitDepth, size_t stride, const QRect& roi, quint64* columnSums);
+	static void accumulate(const void* data, unsigned int bitDepth, size_t stride, const QRect& roi, quint64* columnSums, SIMD_KERNEL kernel);
+
+private:
+	template <typename T> static void accumulateScalar(const T* data, size_t stride, const QRect& roi, quint64* columnSums);
+#ifdef CPUFEATURES_X86
+	static int accumulateSse2(const quint8* data, size_t stride, const QRect& roi, quint64* columnSums);
+	static int accumulateSse2(const quint16* data, size_t stride, const QRect& roi, quint64* columnSums);
+	static int accumulateSse2(const quint32* data, size_t stride, const QRect& roi, quint64* columnSums);
+	static int accumulateAvx2(const quint8* data, size_t stride, const QRect& roi, quint64* columnSums);
+	static int accumulateAvx2(const quint16* data, size_t stride, const QRect& roi, quint64* columnSums);
+	static int accumulateAvx2(const quint32* data, size_t stride, const QRect& roi, quint64* columnSums);
+	static int accumulateAvx512(const quint8* data, size_t stride, const QRect& roi, quint64* columnSums);
+	static int accumulateAvx512(const quint16* data, size_t stride, const QRect& roi, quint64* columnSums);
+	static int accumulateAvx512(const quint32* data, size_t stride, const QRect& roi, quint64* columnSums);
+#endif
+	template <typename T> static void accumulate(const T* data, size_t stride, const QRect& roi, quint64* columnSums, SIMD_KERNEL kernel);
+};
+
+#endif //COLUMNACCUMULATOR_H
@@ -0,0 +1,102 @@
+#include "columnintegraltable.h"
+#include <cstring>
+
+
+ColumnIntegralTable::ColumnIntegralTable()
+	: wide(false),
+	valid(false),
+	samplesPerLine(0),
+	linesPerFrame(0)
+{
+
+}
+
+void ColumnIntegralTable::build(const FrameView& frame) {
+	this->valid = false;
+	int width = frame.region.width();
+	int height = frame.region.height();
+	if (frame.data == nullptr || width <= 0 || height <= 0 || frame.bitDepth == 0 || frame.bitDepth > 32) {
+		return;
+	}
+
+	//largest sum of a column has to fit into the table entries
+	quint64 maxSample = (Q_UINT64_C(1) << frame.bitDepth) - 1;
+	this->wide = frame.bitDepth > 16 || maxSample*static_cast<quint64>(height) > Q_UINT64_C(0xFFFFFFFF);
+	int tableSize = (height+1)*width;
+	if (this->wide) {
+		if (this->wideTable.size() < tableSize) {
+			this->wideTable.resize(tableSize);
+		}
+		this->narrowTable.clear();
+	} else {
+		if (this->narrowTable.size() < tableSize) {
+			this->narrowTable.resize(tableSize);
+		}
+		this->wideTable.clear();
+	}
+
+	if (frame.bitDepth <= 8) {
+		if (this->wide) {
+			build(static_cast<const quint8*>(frame.data), frame.stride, width, height, this->wideTable.data());
+		} else {
+			build(static_cast<const quint8*>(frame.data), frame.stride, width, height, this->narrowTable.data());
+		}
+	} else if (frame.bitDepth <= 16) {
+		if (this->wide) {
+			build(static_cast<const quint16*>(frame.data), frame.stride, width, height, this->wideTable.data());
+		} else {
+			build(static_cast<const quint16*>(frame.data), frame.stride, width, height, this->narrowTable.data());
+		}
+	} else {
+		build(static_cast<const quint32*>(frame.data), frame.stride, width, height, this->wideTable.data());
+	}
+
+	this->region = frame.region;
+	this->samplesPerLine = frame.samplesPerLine;
+	this->linesPerFrame = frame.linesPerFrame;
+	this->valid = true;
+}
+
+bool ColumnIntegralTable::covers(const QRect& roi) const {
+	return this->valid && roi.width() > 0 && roi.height() > 0 && this->region.contains(roi);
+}
+
+size_t ColumnIntegralTable::getAllocatedBytes() const {
+	return static_cast<size_t>(this->narrowTable.capacity())*sizeof(quint32) + static_cast<size_t>(this->wideTable.capacity())*sizeof(quint64);
+}
+
+bool ColumnIntegralTable::columnSums(const QRect& roi, quint64* columnSums) const {
+	if (!this->covers(roi)) {
+		return false;
+	}
+	QRect tableRoi = roi.translated(-this->region.x(), -this->region.y());
+	if (this->wide) {
+		readColumnSums(this->wideTable.constData(), this->region.width(), tableRoi, columnSums);
+	} else {
+		readColumnSums(this->narrowTable.constData(), this->region.width(), tableRoi, columnSums);
+	}
+	return true;
+}
+
+template<typename T, typename S>
+void ColumnIntegralTable::build(const T* data, size_t stride, int width, int height, S* table) {
+	//every table row is the previous one plus a line of the frame, both are read in memory order
+	memset(table, 0, static_cast<size_t>(width)*sizeof(S));
+	for (int y = 0; y < height; ++y) {
+		const T* line = data + static_cast<size_t>(y)*stride;
+		const S* previous = table + static_cast<size_t>(y)*width;
+		S* current = table + static_cast<size_t>(y+1)*width;
+		for (int x = 0; x < width; ++x) {
+			current[x] = previous[x] + line[x];
+		}
+	}
+}
+
+template<typename S>
+void ColumnIntegralTable::readColumnSums(const S* table, int tableWidth, const QRect& roi, quint64* columnSums) {
+	const S* top = table + static_cast<size_t>(roi.y())*tableWidth + roi.x();
+	const S* bottom = table + static_cast<size_t>(roi.y() + roi.height())*tableWidth + roi.x();
+	for (int x = 0; x < roi.width(); ++x) {
+		columnSums[x] = static_cast<quint64>(bottom[x] - top[x]);
+	}
+}
@@ -0,0 +1,43 @@
+#ifndef COLUMNINTEGRALTABLE_H
+#define COLUMNINTEGRALTABLE_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QRect>
+#include "frameview.h"
+
+
+//Column-wise cumulative sums of all lines of a frame view, built in a single pass. Row y of the table holds the sums of
+//the lines above y, so the column sums of any ROI inside the view are the difference of two table rows and can be read
+//out for many ROIs without touching the frame again. Sums are stored in 32-bit if they can not overflow (8-bit and
+//16-bit data of up to 65537 lines), which halves the memory traffic. The table memory only grows and is reused for
+//every frame.
+class ColumnIntegralTable
+{
+public:
+	ColumnIntegralTable();
+
+	void build(const FrameView& frame);
+	void invalidate() {this->valid = false;}
+	bool isValid() const {return this->valid;}
+	bool covers(const QRect& roi) const;
+	QRect getRegion() const {return this->region;}
+	unsigned int getSamplesPerLine() const {return this->samplesPerLine;}
+	unsigned int getLinesPerFrame() const {return this->linesPerFrame;}
+	size_t getAllocatedBytes() const;
+	bool columnSums(const QRect& roi, quint64* columnSums) const;
+
+private:
+	QVector<quint32> narrowTable;
+	QVector<quint64> wideTable;
+	bool wide;
+	bool valid;
+	QRect region;
+	unsigned int samplesPerLine;
+	unsigned int linesPerFrame;
+
+	template <typename T, typename S> static void build(const T* data, size_t stride, int width, int height, S* table);
+	template <typename S> static void readColumnSums(const S* table, int tableWidth, const QRect& roi, quint64* columnSums);
+};
+
+#endif //COLUMNINTEGRALTABLE_H
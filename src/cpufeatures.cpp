@@ -0,0 +1,102 @@
+#include "cpufeatures.h"
+#include <QByteArray>
+
+#if defined(CPUFEATURES_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+
+QAtomicInt CpuFeatures::selectedKernel(-1);
+
+SIMD_KERNEL CpuFeatures::initialize() {
+	SIMD_KERNEL kernel = detectBestKernel();
+	QByteArray forceScalar = qgetenv(PEAKDETECTOR_FORCE_SCALAR_ENV);
+	if (!forceScalar.isEmpty() && forceScalar != "0") {
+		kernel = KERNEL_SCALAR;
+	}
+	selectedKernel.storeRelease(kernel);
+	return kernel;
+}
+
+SIMD_KERNEL CpuFeatures::getKernel() {
+	int kernel = selectedKernel.loadAcquire();
+	if (kernel < 0) {
+		return initialize();
+	}
+	return static_cast<SIMD_KERNEL>(kernel);
+}
+
+void CpuFeatures::setKernel(SIMD_KERNEL kernel) {
+	//never select a kernel that would crash with an illegal instruction
+	while (!isSupported(kernel)) {
+		kernel = static_cast<SIMD_KERNEL>(kernel-1);
+	}
+	selectedKernel.storeRelease(kernel);
+}
+
+bool CpuFeatures::isSupported(SIMD_KERNEL kernel) {
+	switch (kernel) {
+		case KERNEL_SCALAR:
+			return true;
+#ifdef CPUFEATURES_X86
+#if defined(_MSC_VER)
+		case KERNEL_SSE2: {
+			int info[4];
+			__cpuid(info, 1);
+			return (info[3] & (1 << 26)) != 0;
+		}
+		case KERNEL_AVX2:
+		case KERNEL_AVX512: {
+			//vector registers have to be enabled by the operating system (osxsave and xcr0), not only supported by the cpu
+			int info[4];
+			__cpuid(info, 1);
+			if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) {
+				return false;
+			}
+			unsigned long long xcr0 = _xgetbv(0);
+			__cpuidex(info, 7, 0);
+			if (kernel == KERNEL_AVX2) {
+				return (xcr0 & 0x6) == 0x6 && (info[1] & (1 << 5)) != 0;
+			}
+			return (xcr0 & 0xE6) == 0xE6 && (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0;
+		}
+#else
+		case KERNEL_SSE2:
+			return __builtin_cpu_supports("sse2");
+		case KERNEL_AVX2:
+			return __builtin_cpu_supports("avx2");
+		case KERNEL_AVX512:
+			return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+#endif
+		default:
+			return false;
+	}
+}
+
+SIMD_KERNEL CpuFeatures::detectBestKernel() {
+	if (isSupported(KERNEL_AVX512)) {
+		return KERNEL_AVX512;
+	}
+	if (isSupported(KERNEL_AVX2)) {
+		return KERNEL_AVX2;
+	}
+	if (isSupported(KERNEL_SSE2)) {
+		return KERNEL_SSE2;
+	}
+	return KERNEL_SCALAR;
+}
+
+QString CpuFeatures::getKernelName(SIMD_KERNEL kernel) {
+	switch (kernel) {
+		case KERNEL_SSE2:
+			return "SSE2";
+		case KERNEL_AVX2:
+			return "AVX2";
+		case KERNEL_AVX512:
+			return "AVX-512";
+		default:
+			return "scalar";
+	}
+}
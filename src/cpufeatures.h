@@ -0,0 +1,52 @@
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QAtomicInt>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPUFEATURES_X86
+#endif
+
+//vector kernels are compiled for their instruction set with function attributes, so the plugin does not need any
+//architecture specific compiler flags and still runs on cpus without avx. Msvc allows intrinsics without attributes.
+#if defined(_MSC_VER)
+#define TARGET_SSE2
+#define TARGET_AVX2
+#define TARGET_AVX512
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#endif
+
+//if this environment variable is set (and not 0) the scalar kernels are used, e.g. for A/B comparisons
+#define PEAKDETECTOR_FORCE_SCALAR_ENV "PEAKDETECTOR_FORCE_SCALAR"
+
+
+enum SIMD_KERNEL{
+	KERNEL_SCALAR,
+	KERNEL_SSE2,
+	KERNEL_AVX2,
+	KERNEL_AVX512
+};
+
+
+//Detects the vector instruction sets of the cpu once and selects which variant of the hot kernels (column
+//accumulation, bit depth conversion, max search) is used. All kernels call getKernel() to dispatch.
+class CpuFeatures
+{
+public:
+	static SIMD_KERNEL initialize();
+	static SIMD_KERNEL getKernel();
+	static void setKernel(SIMD_KERNEL kernel);
+	static bool isSupported(SIMD_KERNEL kernel);
+	static SIMD_KERNEL detectBestKernel();
+	static QString getKernelName(SIMD_KERNEL kernel);
+
+private:
+	static QAtomicInt selectedKernel;
+};
+
+#endif //CPUFEATURES_H
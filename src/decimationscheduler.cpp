@@ -0,0 +1,106 @@
+#include "decimationscheduler.h"
+#include <QtMath>
+
+
+DecimationScheduler::DecimationScheduler()
+	: target(TARGET_LATENCY),
+	targetValueMicro(50000),
+	frameCostNs(0),
+	costReports(0),
+	appliedCostReports(0),
+	targetReachable(true),
+	decimationRatio(1),
+	bufferIntervalNs(0),
+	lastTimestampNs(-1),
+	bufferCounter(0)
+{
+}
+
+void DecimationScheduler::setTarget(DECIMATION_TARGET target, double value) {
+	this->target.storeRelease(static_cast<int>(target));
+	this->targetValueMicro.storeRelease(static_cast<qint64>(value*1000.0));
+}
+
+void DecimationScheduler::reportProcessingTime(unsigned int frames, qint64 nsecs) {
+	if(frames == 0 || nsecs <= 0){
+		return;
+	}
+	//only the consumer thread writes frameCostNs, so read-modify-write does not need to be atomic
+	double currentCost = static_cast<double>(nsecs)/static_cast<double>(frames);
+	double previousCost = static_cast<double>(this->frameCostNs.loadAcquire());
+	double smoothedCost = previousCost <= 0 ? currentCost : previousCost + DECIMATION_SMOOTHING*(currentCost-previousCost);
+	this->frameCostNs.storeRelease(qMax(static_cast<qint64>(1), static_cast<qint64>(smoothedCost)));
+	this->costReports.fetchAndAddRelease(1);
+}
+
+bool DecimationScheduler::acceptBuffer(qint64 timestampNs, unsigned int framesPerAnalyzedBuffer, int queueDepth) {
+	//measure interval between incoming buffers
+	if(this->lastTimestampNs >= 0 && timestampNs > this->lastTimestampNs){
+		double interval = static_cast<double>(timestampNs-this->lastTimestampNs);
+		this->bufferIntervalNs = this->bufferIntervalNs <= 0 ? interval : this->bufferIntervalNs + DECIMATION_SMOOTHING*(interval-this->bufferIntervalNs);
+	}
+	this->lastTimestampNs = timestampNs;
+
+	//adapt decimation ratio as soon as processing cost and buffer rate are known, but only once per new cost measurement
+	double bufferCostNs = static_cast<double>(this->frameCostNs.loadAcquire())*framesPerAnalyzedBuffer;
+	int costReports = this->costReports.loadAcquire();
+	if(bufferCostNs > 0 && this->bufferIntervalNs > 0 && costReports != this->appliedCostReports){
+		this->appliedCostReports = costReports;
+		this->decimationRatio.storeRelease(this->calculateDecimationRatio(bufferCostNs, queueDepth));
+	}
+
+	this->bufferCounter++;
+	if(this->bufferCounter < this->decimationRatio.loadAcquire()){
+		return false;
+	}
+	this->bufferCounter = 0;
+	return true;
+}
+
+void DecimationScheduler::reset() {
+	this->frameCostNs.storeRelease(0);
+	this->appliedCostReports = this->costReports.loadAcquire();
+	this->targetReachable.storeRelease(true);
+	this->decimationRatio.storeRelease(1);
+	this->bufferIntervalNs = 0;
+	this->lastTimestampNs = -1;
+	this->bufferCounter = 0;
+}
+
+int DecimationScheduler::calculateDecimationRatio(double bufferCostNs, int queueDepth) {
+	int ratio = this->decimationRatio.loadAcquire();
+	double targetValue = static_cast<double>(this->targetValueMicro.loadAcquire())/1000.0;
+
+	//analysis has to keep up with incoming buffers, otherwise the queue grows until frames are dropped
+	int sustainableRatio = qCeil(bufferCostNs/this->bufferIntervalNs);
+
+	if(this->target.loadAcquire() == TARGET_CPU_BUDGET){
+		double budget = qBound(0.001, targetValue/100.0, 1.0);
+		ratio = qCeil(bufferCostNs/(budget*this->bufferIntervalNs));
+		this->targetReachable.storeRelease(true);
+	}else{
+		//a buffer that alone takes longer than the target can not be made faster by skipping others
+		double targetLatencyNs = targetValue*1.0e6;
+		if(bufferCostNs > targetLatencyNs){
+			this->targetReachable.storeRelease(false);
+			return qBound(1, sustainableRatio, MAX_DECIMATION_RATIO);
+		}
+		this->targetReachable.storeRelease(true);
+
+		//the queue drains while buffers are skipped, so the next accepted buffer waits queueDepth*bufferCostNs minus the
+		//skipped time. A larger ratio than the one that brings this wait within the target does not lower the latency
+		int latencyRatio = qCeil(((queueDepth+1)*bufferCostNs - targetLatencyNs)/this->bufferIntervalNs);
+		int maxRatio = qMax(sustainableRatio, latencyRatio);
+
+		//increase ratio quickly if expected latency exceeds target, decrease it slowly if there is enough headroom
+		double expectedLatencyNs = (queueDepth+1)*bufferCostNs;
+		if(expectedLatencyNs > targetLatencyNs){
+			ratio = ratio + qMax(1, ratio/4);
+		}else if(2.0*expectedLatencyNs < targetLatencyNs){
+			ratio = ratio - 1;
+		}
+		ratio = qBound(sustainableRatio, ratio, maxRatio);
+	}
+
+	return qBound(1, ratio, MAX_DECIMATION_RATIO);
+}
@@ -0,0 +1,48 @@
+#ifndef DECIMATIONSCHEDULER_H
+#define DECIMATIONSCHEDULER_H
+
+#include <QtGlobal>
+#include <QAtomicInt>
+#include "peakdetectorparameters.h"
+
+#define MAX_DECIMATION_RATIO 1000
+#define DECIMATION_SMOOTHING 0.2
+
+
+//Decides which incoming buffers are analyzed. The consumer reports how long the analysis of a frame takes, the producer
+//asks for every incoming buffer if it should be analyzed. The decimation ratio (analyze 1 of N buffers) is adapted at
+//runtime so that either the expected latency (queued buffers plus the buffer being processed) stays below the target
+//latency, or the fraction of time spent on analysis stays below the target cpu budget. The ratio is only stepped once per
+//new processing time report, so a burst of buffers does not change it more than once. If a single buffer takes longer
+//than the target latency, the target can not be reached by decimation and only the sustainable ratio is used.
+class DecimationScheduler
+{
+public:
+	DecimationScheduler();
+
+	void setTarget(DECIMATION_TARGET target, double value);
+	void reportProcessingTime(unsigned int frames, qint64 nsecs);
+	bool acceptBuffer(qint64 timestampNs, unsigned int framesPerAnalyzedBuffer, int queueDepth);
+	void reset();
+
+	int getDecimationRatio() const {return this->decimationRatio.loadAcquire();}
+	bool isTargetReachable() const {return this->targetReachable.loadAcquire() != 0;}
+	qint64 getFrameCostNs() const {return this->frameCostNs.loadAcquire();}
+	double getBufferIntervalNs() const {return this->bufferIntervalNs;}
+
+private:
+	QAtomicInt target;
+	QAtomicInteger<qint64> targetValueMicro;
+	QAtomicInteger<qint64> frameCostNs;
+	QAtomicInt costReports;
+	int appliedCostReports;
+	QAtomicInt targetReachable;
+	QAtomicInt decimationRatio;
+	double bufferIntervalNs;
+	qint64 lastTimestampNs;
+	int bufferCounter;
+
+	int calculateDecimationRatio(double bufferCostNs, int queueDepth);
+};
+
+#endif //DECIMATIONSCHEDULER_H
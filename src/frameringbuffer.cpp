@@ -0,0 +1,133 @@
+#include "frameringbuffer.h"
+#include <cstdlib>
+
+
+FrameRingBuffer::FrameRingBuffer(int depth)
+	: bytesPerSlot(0),
+	columnSumsPerSlot(0),
+	writeIndex(0),
+	lostFrames(0)
+{
+	this->resize(depth, 0);
+}
+
+FrameRingBuffer::~FrameRingBuffer() {
+	this->releaseSlots();
+}
+
+bool FrameRingBuffer::resize(int depth, size_t bytesPerSlot, size_t columnSumsPerSlot) {
+	depth = qBound(1, depth, MAX_FRAME_RING_DEPTH);
+
+	//slots can only be reallocated if no consumer holds one of them
+	if(this->getUsedSlots() > 0){
+		return false;
+	}
+
+	this->releaseSlots();
+	this->frameSlots.resize(depth);
+	for(int i = 0; i < depth; i++){
+		FrameSlot* slot = new FrameSlot();
+		slot->data = bytesPerSlot > 0 ? static_cast<char*>(malloc(bytesPerSlot)) : nullptr;
+		slot->capacity = slot->data != nullptr ? bytesPerSlot : 0;
+		slot->bitDepth = 0;
+		slot->samplesPerLine = 0;
+		slot->linesPerFrame = 0;
+		slot->frameCount = 0;
+		slot->columnSums = columnSumsPerSlot > 0 ? static_cast<quint64*>(malloc(columnSumsPerSlot*sizeof(quint64))) : nullptr;
+		slot->columnSumsCapacity = slot->columnSums != nullptr ? columnSumsPerSlot : 0;
+		slot->stride = 0;
+		slot->bytesPerFrame = 0;
+		slot->hasFrameData = false;
+		slot->hasColumnSums = false;
+		slot->timestampNs = -1;
+		slot->copiedNs = -1;
+		slot->bufferNr = -1;
+		slot->firstFrameNr = -1;
+		slot->dataFrameNr = -1;
+		slot->state.storeRelease(SLOT_FREE);
+		slot->pendingReaders.storeRelease(0);
+		this->frameSlots[i] = slot;
+	}
+	this->bytesPerSlot = bytesPerSlot;
+	this->columnSumsPerSlot = columnSumsPerSlot;
+	this->writeIndex = 0;
+	return true;
+}
+
+int FrameRingBuffer::getUsedSlots() const {
+	int usedSlots = 0;
+	for(int i = 0; i < this->frameSlots.size(); i++){
+		if(this->frameSlots.at(i)->state.loadAcquire() != SLOT_FREE){
+			usedSlots++;
+		}
+	}
+	return usedSlots;
+}
+
+FrameSlot* FrameRingBuffer::acquire() {
+	//only the producer calls this method, so writeIndex does not need to be atomic. A slot that is still held by a consumer is skipped
+	int depth = this->frameSlots.size();
+	for(int i = 0; i < depth; i++){
+		int index = (this->writeIndex+i)%depth;
+		FrameSlot* slot = this->frameSlots.at(index);
+		if(slot->state.testAndSetAcquire(SLOT_FREE, SLOT_WRITING)){
+			this->writeIndex = (index+1)%depth;
+			return slot;
+		}
+	}
+	return nullptr;
+}
+
+void FrameRingBuffer::publish(FrameSlot* slot, int readers) {
+	if(slot == nullptr){
+		return;
+	}
+	if(readers <= 0){
+		slot->state.storeRelease(SLOT_FREE);
+		return;
+	}
+	slot->pendingReaders.storeRelease(readers);
+	slot->state.storeRelease(SLOT_IN_USE);
+}
+
+void FrameRingBuffer::release(FrameSlot* slot) {
+	if(slot == nullptr){
+		return;
+	}
+	//last consumer hands the slot back to the producer
+	if(slot->pendingReaders.fetchAndSubOrdered(1) == 1){
+		slot->state.storeRelease(SLOT_FREE);
+	}
+}
+
+void FrameRingBuffer::release(const void* address) {
+	const char* pointer = static_cast<const char*>(address);
+	for(int i = 0; i < this->frameSlots.size(); i++){
+		FrameSlot* slot = this->frameSlots.at(i);
+		if(slot->data != nullptr && pointer >= slot->data && pointer < slot->data + slot->capacity){
+			this->release(slot);
+			return;
+		}
+	}
+}
+
+quint64 FrameRingBuffer::countLostFrames(quint64 frames) {
+	return this->lostFrames.fetchAndAddOrdered(frames)+frames;
+}
+
+void FrameRingBuffer::resetLostFrames() {
+	this->lostFrames.storeRelease(0);
+}
+
+void FrameRingBuffer::releaseSlots() {
+	for(int i = 0; i < this->frameSlots.size(); i++){
+		if(this->frameSlots.at(i)->data != nullptr){
+			free(this->frameSlots.at(i)->data);
+		}
+		if(this->frameSlots.at(i)->columnSums != nullptr){
+			free(this->frameSlots.at(i)->columnSums);
+		}
+		delete this->frameSlots.at(i);
+	}
+	this->frameSlots.clear();
+}
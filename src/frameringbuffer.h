@@ -0,0 +1,81 @@
+#ifndef FRAMERINGBUFFER_H
+#define FRAMERINGBUFFER_H
+
+#include <QtGlobal>
+#include <QAtomicInt>
+#include <QVector>
+#include <QMetaType>
+#include <QRect>
+
+#define DEFAULT_FRAME_RING_DEPTH 4
+#define MAX_FRAME_RING_DEPTH 64
+
+
+enum FRAME_SLOT_STATE{
+	SLOT_FREE,
+	SLOT_WRITING,
+	SLOT_IN_USE
+};
+
+struct FrameSlot {
+	char* data;
+	size_t capacity;
+	unsigned int bitDepth;
+	unsigned int samplesPerLine;
+	unsigned int linesPerFrame;
+	unsigned int frameCount;
+	quint64* columnSums;
+	size_t columnSumsCapacity;
+	QRect roi;
+	QRect region;
+	size_t stride;
+	size_t bytesPerFrame;
+	bool hasFrameData;
+	bool hasColumnSums;
+	qint64 timestampNs;
+	qint64 copiedNs;
+	int bufferNr;
+	int firstFrameNr;
+	int dataFrameNr;
+	QAtomicInt state;
+	QAtomicInt pendingReaders;
+};
+Q_DECLARE_METATYPE(FrameSlot*)
+
+
+//Single-producer ring of pre-allocated frame slots. The producer acquires the next free slot, fills it and publishes it together
+//with the number of consumers that will read it. Every consumer releases the slot when it is done, the last release hands
+//the slot back to the producer. Slots that a consumer keeps for longer are skipped, only if no slot is free the ring is full
+//and the producer has to drop the frame.
+class FrameRingBuffer
+{
+public:
+	explicit FrameRingBuffer(int depth = DEFAULT_FRAME_RING_DEPTH);
+	~FrameRingBuffer();
+
+	bool resize(int depth, size_t bytesPerSlot, size_t columnSumsPerSlot = 0);
+	int getDepth() const {return this->frameSlots.size();}
+	size_t getBytesPerSlot() const {return this->bytesPerSlot;}
+	size_t getColumnSumsPerSlot() const {return this->columnSumsPerSlot;}
+	int getUsedSlots() const;
+
+	FrameSlot* acquire();
+	void publish(FrameSlot* slot, int readers);
+	void release(FrameSlot* slot);
+	void release(const void* address);
+
+	quint64 countLostFrames(quint64 frames = 1);
+	quint64 getLostFrames() const {return this->lostFrames.loadAcquire();}
+	void resetLostFrames();
+
+private:
+	QVector<FrameSlot*> frameSlots;
+	size_t bytesPerSlot;
+	size_t columnSumsPerSlot;
+	int writeIndex;
+	QAtomicInteger<quint64> lostFrames;
+
+	void releaseSlots();
+};
+
+#endif //FRAMERINGBUFFER_H
@@ -0,0 +1,37 @@
+#ifndef FRAMEVIEW_H
+#define FRAMEVIEW_H
+
+#include <QtGlobal>
+#include <QRect>
+#include <QMetaType>
+
+
+//Describes which part of a frame is stored in a buffer and how it is laid out. data points to the first sample of region,
+//consecutive lines of the region are stride samples apart. samplesPerLine and linesPerFrame are the dimensions of the
+//full frame, so a view of a ROI-only copy can still be mapped to frame coordinates.
+struct FrameView {
+	const void* data;
+	unsigned int bitDepth;
+	unsigned int samplesPerLine;
+	unsigned int linesPerFrame;
+	size_t stride;
+	QRect region;
+
+	static FrameView fullFrame(const void* data, unsigned int bitDepth, unsigned int samplesPerLine, unsigned int linesPerFrame) {
+		FrameView view;
+		view.data = data;
+		view.bitDepth = bitDepth;
+		view.samplesPerLine = samplesPerLine;
+		view.linesPerFrame = linesPerFrame;
+		view.stride = samplesPerLine;
+		view.region = QRect(0, 0, static_cast<int>(samplesPerLine), static_cast<int>(linesPerFrame));
+		return view;
+	}
+
+	static size_t bytesPerSample(unsigned int bitDepth) {
+		return static_cast<size_t>((bitDepth+7)/8);
+	}
+};
+Q_DECLARE_METATYPE(FrameView)
+
+#endif //FRAMEVIEW_H
@@ -0,0 +1,29 @@
+# Extension class and its widgets. Needs processing.pri, it is shared by the extension and the headless harness.
+
+INCLUDEPATH += \
+	$$PWD/overlayitems \
+	$$PWD/thirdparty \
+	$$PWD/thirdparty/qcustomplot
+
+SOURCES += \
+	$$PWD/thirdparty/qcustomplot/qcustomplot.cpp \
+	$$PWD/peakdetector.cpp \
+	$$PWD/peakdetectorform.cpp \
+	$$PWD/imagedisplay.cpp \
+	$$PWD/lineplot.cpp \
+	$$PWD/overlayitems/anchorpoint.cpp \
+	$$PWD/overlayitems/overlayitem.cpp \
+	$$PWD/overlayitems/rectoverlay.cpp
+
+HEADERS += \
+	$$PWD/thirdparty/qcustomplot/qcustomplot.h \
+	$$PWD/peakdetector.h \
+	$$PWD/peakdetectorform.h \
+	$$PWD/imagedisplay.h \
+	$$PWD/lineplot.h \
+	$$PWD/overlayitems/anchorpoint.h \
+	$$PWD/overlayitems/overlayitem.h \
+	$$PWD/overlayitems/rectoverlay.h
+
+FORMS += \
+	$$PWD/peakdetectorform.ui
@@ -12,16 +12,18 @@ ImageDisplay::ImageDisplay(QWidget *parent) : QGraphicsView(parent)
 
 	this->inputItem = new QGraphicsPixmapItem();
 	this->roiRect = new RectOverlay(inputItem);
+	this->surfaceItem = new QGraphicsPathItem(inputItem);
+	QPen surfacePen(QColor(250, 200, 50));
+	surfacePen.setCosmetic(true);
+	this->surfaceItem->setPen(surfacePen);
+	this->surfaceItem->setVisible(false);
 	this->scene->addItem(inputItem);
 	this->scene->update();
 
 	//setup roi
+	this->roiRect->setToolTip(DEFAULT_ROI_NAME);
 	connect(this->roiRect, &RectOverlay::positionChanged, this, [this](OverlayItem* item) {
-		auto topLeftAnchor = item->getAnchorPoints().at(0);
-		auto bottomRightAnchor = item->getAnchorPoints().at(1);
-		QRectF roiRect(topLeftAnchor->scenePos(), bottomRightAnchor->scenePos());
-		QPolygonF roiInImageCoordinates = this->inputItem->mapFromItem(this->inputItem, roiRect);
-		emit roiChanged(roiRect.toRect());
+		emit roiChanged(overlayRect(item));
 	});
 
 	//adjust orientation of display to match orientation of octproz main output
@@ -40,6 +42,7 @@ ImageDisplay::ImageDisplay(QWidget *parent) : QGraphicsView(parent)
 	connect(this->bitConverter, &BitDepthConverter::info, this, &ImageDisplay::info);
 	connect(this->bitConverter, &BitDepthConverter::error, this, &ImageDisplay::error);
 	connect(this->bitConverter, &BitDepthConverter::converted8bitData, this, &ImageDisplay::displayFrame);
+	connect(this->bitConverter, &BitDepthConverter::inputDataReleased, this, &ImageDisplay::frameReleased, Qt::DirectConnection);
 	connect(&converterThread, &QThread::finished, this->bitConverter, &BitDepthConverter::deleteLater);
 	converterThread.start();
 }
@@ -107,6 +110,16 @@ void ImageDisplay::wheelEvent(QWheelEvent* event) {
 	QGraphicsView::wheelEvent(event);
 }
 
+void ImageDisplay::showEvent(QShowEvent* event) {
+	emit visibilityChanged(true);
+	QGraphicsView::showEvent(event);
+}
+
+void ImageDisplay::hideEvent(QHideEvent* event) {
+	emit visibilityChanged(false);
+	QGraphicsView::hideEvent(event);
+}
+
 void ImageDisplay::scaleView(qreal scaleFactor) {
 	qreal factor = transform().scale(scaleFactor, scaleFactor).mapRect(QRectF(0, 0, 1, 1)).width();
 	if (factor < 0.07 || factor > 100){
@@ -124,34 +137,151 @@ void ImageDisplay::zoomOut() {
 }
 
 void ImageDisplay::receiveFrame(void *frame, unsigned int bitDepth, unsigned int samplesPerLine, unsigned int linesPerFrame) {
+	this->receiveFrameView(FrameView::fullFrame(frame, bitDepth, samplesPerLine, linesPerFrame));
+}
+
+void ImageDisplay::receiveFrameView(FrameView frame) {
+	void* data = const_cast<void*>(frame.data);
 	if(!this->isVisible()){
+		emit frameReleased(data);
 		return;
 	}
-	if(bitDepth != 8){
-		emit non8bitFrameReceived(frame, bitDepth, samplesPerLine, linesPerFrame);
+
+	//the view may only contain a part of the frame. It is displayed at its position within the full frame, so the roi overlay stays in frame coordinates
+	this->displayedRegion = frame.region;
+	if(this->frameWidth != static_cast<int>(frame.samplesPerLine) || this->frameHeight != static_cast<int>(frame.linesPerFrame)){
+		this->frameWidth = frame.samplesPerLine;
+		this->frameHeight = frame.linesPerFrame;
+		this->inputItem->setPixmap(QPixmap());
+		this->scene->setSceneRect(0, 0, this->frameWidth, this->frameHeight);
+		this->fitInView(this->scene->sceneRect(), Qt::KeepAspectRatio);
+		this->ensureVisible(this->inputItem);
+		this->centerOn(this->pos());
+	}
+
+	unsigned int samplesPerLine = static_cast<unsigned int>(frame.stride);
+	unsigned int linesPerFrame = static_cast<unsigned int>(frame.region.height());
+	if(frame.bitDepth != 8){
+		//frame is released by the bit depth converter as soon as the conversion is done
+		emit non8bitFrameReceived(data, frame.bitDepth, samplesPerLine, linesPerFrame);
 	}else{
-		this->displayFrame(static_cast<uchar*>(frame), samplesPerLine, linesPerFrame);
+		this->displayFrame(static_cast<uchar*>(data), samplesPerLine, linesPerFrame);
+		emit frameReleased(data);
 	}
 }
 
 void ImageDisplay::displayFrame(uchar* frame, unsigned int samplesPerLine, unsigned int linesPerFrame) {
-	//create QPixmap from uchar array and update inputItem
-	QImage image(frame, samplesPerLine, linesPerFrame, samplesPerLine, QImage::Format_Grayscale8 );
+	TRACE_SCOPE("ImageDisplay::displayFrame");
+	//create QPixmap from uchar array and update inputItem. Samples beyond the displayed region (stride padding) are cropped
+	int width = this->displayedRegion.width() > 0 ? qMin(this->displayedRegion.width(), static_cast<int>(samplesPerLine)) : static_cast<int>(samplesPerLine);
+	QImage image(frame, width, linesPerFrame, samplesPerLine, QImage::Format_Grayscale8 );
 	this->inputItem->setPixmap(QPixmap::fromImage(image));
+	this->inputItem->setOffset(this->displayedRegion.topLeft());
+}
 
-	//scale view if input sizes have changed
-	if(this->frameWidth != samplesPerLine || this->frameHeight != linesPerFrame){
-		this->frameWidth = samplesPerLine;
-		this->frameHeight = linesPerFrame;
-		this->fitInView(this->scene->sceneRect(), Qt::KeepAspectRatio);
-		this->ensureVisible(this->inputItem);
-		this->centerOn(this->pos());
+void ImageDisplay::setRoi(QRect roi) {
+	this->roiRect->setRect(roi);
+}
 
-		//set scene rect back to minimal size
-		this->scene->setSceneRect(this->scene->itemsBoundingRect());
+void ImageDisplay::setRoiName(QString name) {
+	this->roiRect->setName(name);
+	this->roiRect->setToolTip(name);
+}
+
+void ImageDisplay::setAdditionalRoiNames(QStringList names) {
+	//overlays are reused in their order, so renaming a roi keeps its position
+	this->resizeAdditionalRois(qMin(names.size(), MAX_ADDITIONAL_ROIS));
+	for (int i = 0; i < this->additionalRoiRects.size(); i++) {
+		this->additionalRoiRects.at(i)->setName(names.at(i));
+		this->additionalRoiRects.at(i)->setToolTip(names.at(i));
 	}
+	emit additionalRoisChanged(this->getAdditionalRois());
 }
 
-void ImageDisplay::setRoi(QRect roi) {
-	this->roiRect->setRect(roi);
+QVector<NamedRoi> ImageDisplay::getAdditionalRois() const {
+	QVector<NamedRoi> rois;
+	for (RectOverlay* overlay : this->additionalRoiRects) {
+		NamedRoi roi;
+		roi.name = overlay->getName();
+		roi.rect = overlayRect(overlay);
+		rois.append(roi);
+	}
+	return rois;
+}
+
+QVariantList ImageDisplay::saveAdditionalRois() const {
+	//overlay state with the name of the roi added to it
+	QVariantList states;
+	for (RectOverlay* overlay : this->additionalRoiRects) {
+		QVariantMap state = overlay->saveState();
+		state["name"] = overlay->getName();
+		states.append(state);
+	}
+	return states;
+}
+
+void ImageDisplay::loadAdditionalRois(const QVariantList& states) {
+	QStringList names;
+	for (const QVariant& state : states) {
+		names.append(state.toMap().value("name").toString());
+	}
+	this->resizeAdditionalRois(qMin(names.size(), MAX_ADDITIONAL_ROIS));
+	for (int i = 0; i < this->additionalRoiRects.size(); i++) {
+		this->additionalRoiRects.at(i)->setName(names.at(i));
+		this->additionalRoiRects.at(i)->setToolTip(names.at(i));
+		this->additionalRoiRects.at(i)->loadState(states.at(i).toMap());
+	}
+	emit additionalRoisChanged(this->getAdditionalRois());
+}
+
+void ImageDisplay::resizeAdditionalRois(int count) {
+	while (this->additionalRoiRects.size() > count) {
+		delete this->additionalRoiRects.takeLast();
+	}
+
+	//new overlays get their own color and are placed with an offset, so they do not hide each other
+	static const QColor colors[MAX_ADDITIONAL_ROIS] = {QColor(0, 200, 0, 128), QColor(0, 100, 255, 128), QColor(255, 0, 255, 128), QColor(0, 220, 220, 128), QColor(255, 160, 0, 128), QColor(160, 80, 255, 128), QColor(255, 255, 0, 128)};
+	while (this->additionalRoiRects.size() < count) {
+		int index = this->additionalRoiRects.size();
+		RectOverlay* overlay = new RectOverlay(this->inputItem);
+		overlay->setColor(colors[index % MAX_ADDITIONAL_ROIS]);
+		overlay->setRect(QRect(50 + 25*(index+1), 50 + 25*(index+1), 400, 200));
+		connect(overlay, &RectOverlay::positionChanged, this, [this](OverlayItem* item) {
+			Q_UNUSED(item)
+			emit additionalRoisChanged(this->getAdditionalRois());
+		});
+		this->additionalRoiRects.append(overlay);
+	}
+}
+
+QRect ImageDisplay::overlayRect(OverlayItem* item) {
+	auto topLeftAnchor = item->getAnchorPoints().at(0);
+	auto bottomRightAnchor = item->getAnchorPoints().at(1);
+	QRectF roiRect(topLeftAnchor->scenePos(), bottomRightAnchor->scenePos());
+	return roiRect.toRect();
+}
+
+void ImageDisplay::displaySurfaceProfile(SurfaceProfile profile) {
+	//polyline through the peak of every line at the center of the pixels, lines without peak interrupt it
+	QPainterPath path;
+	bool connected = false;
+	for (int i = 0; i < profile.positions.size(); i++) {
+		double position = profile.positions.at(i);
+		if (position < 0) {
+			connected = false;
+			continue;
+		}
+		QPointF point(position + 0.5, profile.firstLine + i + 0.5);
+		if (connected) {
+			path.lineTo(point);
+		} else {
+			path.moveTo(point);
+			connected = true;
+		}
+	}
+	this->surfaceItem->setPath(path);
+}
+
+void ImageDisplay::setSurfaceProfileVisible(bool visible) {
+	this->surfaceItem->setVisible(visible);
 }
@@ -4,12 +4,19 @@
 #include <QWidget>
 #include <QGraphicsView>
 #include <QGraphicsPixmapItem>
+#include <QGraphicsPathItem>
 #include <QThread>
 #include <QKeyEvent>
 #include <QWheelEvent>
 #include <QtMath>
 #include "bitdepthconverter.h"
 #include "rectoverlay.h"
+#include "frameview.h"
+#include "surfaceprofile.h"
+#include "peakdetectorparameters.h"
+
+#define DEFAULT_ROI_NAME "ROI"
+#define MAX_ADDITIONAL_ROIS 7
 
 class ImageDisplay : public QGraphicsView
 {
@@ -21,6 +28,9 @@ public:
 	~ImageDisplay();
 
 	QRect getRoi(){return this->currentRoi;}
+	QVector<NamedRoi> getAdditionalRois() const;
+	QVariantList saveAdditionalRois() const;
+	void loadAdditionalRois(const QVariantList& states);
 
 private:
 	void mouseDoubleClickEvent(QMouseEvent* event) override;
@@ -29,6 +39,10 @@ private:
 	void keyPressEvent(QKeyEvent* event) override;
 	void wheelEvent(QWheelEvent* event) override;
 	void scaleView(qreal scaleFactor);
+	void showEvent(QShowEvent* event) override;
+	void hideEvent(QHideEvent* event) override;
+	void resizeAdditionalRois(int count);
+	static QRect overlayRect(OverlayItem* item);
 
 private:
 	BitDepthConverter* bitConverter;
@@ -36,21 +50,32 @@ private:
 	QGraphicsPixmapItem* inputItem;
 	int frameWidth;
 	int frameHeight;
+	QRect displayedRegion;
 	int mousePosX;
 	int mousePosY;
 	RectOverlay* roiRect;
+	QList<RectOverlay*> additionalRoiRects;
+	QGraphicsPathItem* surfaceItem;
 	QRect currentRoi;
 
 public slots:
 	void zoomIn();
 	void zoomOut();
 	void receiveFrame(void* frame, unsigned int bitDepth, unsigned int samplesPerLine, unsigned int linesPerFrame);
+	void receiveFrameView(FrameView frame);
 	void displayFrame(uchar* frame, unsigned int samplesPerLine, unsigned int linesPerFrame);
 	void setRoi(QRect roi);
+	void setRoiName(QString name);
+	void setAdditionalRoiNames(QStringList names);
+	void displaySurfaceProfile(SurfaceProfile profile);
+	void setSurfaceProfileVisible(bool visible);
 
 signals:
 	void non8bitFrameReceived(void *frame, unsigned int bitDepth, unsigned int samplesPerLine, unsigned int linesPerFrame);
 	void roiChanged(QRect);
+	void additionalRoisChanged(QVector<NamedRoi>);
+	void frameReleased(void* frame);
+	void visibilityChanged(bool visible);
 	void info(QString);
 	void error(QString);
 
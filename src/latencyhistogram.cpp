@@ -0,0 +1,79 @@
+#include "latencyhistogram.h"
+#include <QtAlgorithms>
+#include <QtMath>
+
+
+LatencyHistogram::LatencyHistogram()
+{
+	this->reset();
+}
+
+void LatencyHistogram::record(qint64 latencyNs) {
+	latencyNs = qMax(Q_INT64_C(0), latencyNs);
+	this->buckets[bucketIndex(static_cast<quint64>(latencyNs))].fetchAndAddRelaxed(1);
+	this->sum.fetchAndAddRelaxed(static_cast<quint64>(latencyNs));
+	this->count.fetchAndAddRelease(1);
+
+	//maximum is only replaced if no other thread stored a larger value in the meantime
+	qint64 currentMax = this->max.loadAcquire();
+	while (latencyNs > currentMax && !this->max.testAndSetOrdered(currentMax, latencyNs, currentMax)) {
+	}
+}
+
+void LatencyHistogram::reset() {
+	for (int i = 0; i < LATENCY_BUCKETS; ++i) {
+		this->buckets[i].storeRelease(0);
+	}
+	this->count.storeRelease(0);
+	this->sum.storeRelease(0);
+	this->max.storeRelease(0);
+}
+
+double LatencyHistogram::getMean() const {
+	quint64 count = this->count.loadAcquire();
+	return count > 0 ? static_cast<double>(this->sum.loadAcquire())/static_cast<double>(count) : 0.0;
+}
+
+qint64 LatencyHistogram::percentile(double fraction) const {
+	//upper bound of the bucket that contains the requested rank, but never more than the largest recorded value
+	quint64 count = 0;
+	for (int i = 0; i < LATENCY_BUCKETS; ++i) {
+		count += this->buckets[i].loadAcquire();
+	}
+	if (count == 0) {
+		return 0;
+	}
+	quint64 rank = qMax<quint64>(1, static_cast<quint64>(qCeil(qBound(0.0, fraction, 1.0)*static_cast<double>(count))));
+	quint64 cumulativeCount = 0;
+	for (int i = 0; i < LATENCY_BUCKETS; ++i) {
+		cumulativeCount += this->buckets[i].loadAcquire();
+		if (cumulativeCount >= rank) {
+			return qMin(bucketUpperBound(i), this->getMax());
+		}
+	}
+	return this->getMax();
+}
+
+int LatencyHistogram::bucketIndex(quint64 latencyNs) {
+	//values below LATENCY_SUB_BUCKETS have a bucket of their own, above that the highest bits select the bucket
+	if (latencyNs < LATENCY_SUB_BUCKETS) {
+		return static_cast<int>(latencyNs);
+	}
+	if (latencyNs >= (Q_UINT64_C(1) << LATENCY_MAX_EXPONENT)) {
+		return LATENCY_BUCKETS-1;
+	}
+	int highestBit = 63 - static_cast<int>(qCountLeadingZeroBits(latencyNs));
+	int shift = highestBit - LATENCY_SUB_BUCKET_BITS;
+	int subBucket = static_cast<int>((latencyNs >> shift) & (LATENCY_SUB_BUCKETS-1));
+	return (shift+1)*LATENCY_SUB_BUCKETS + subBucket;
+}
+
+qint64 LatencyHistogram::bucketUpperBound(int index) {
+	if (index < LATENCY_SUB_BUCKETS) {
+		return index;
+	}
+	int shift = index/LATENCY_SUB_BUCKETS - 1;
+	int subBucket = index % LATENCY_SUB_BUCKETS;
+	qint64 lowerBound = static_cast<qint64>(LATENCY_SUB_BUCKETS + subBucket) << shift;
+	return lowerBound + (Q_INT64_C(1) << shift) - 1;
+}
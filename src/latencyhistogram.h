@@ -0,0 +1,40 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtGlobal>
+#include <QAtomicInteger>
+
+//every power of two is split into 16 buckets, so percentiles are exact to about 6 %. Latencies of 2^40 ns (about 18
+//minutes) and more end up in the last bucket
+#define LATENCY_SUB_BUCKET_BITS 4
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BUCKET_BITS)
+#define LATENCY_MAX_EXPONENT 40
+#define LATENCY_BUCKETS ((LATENCY_MAX_EXPONENT - LATENCY_SUB_BUCKET_BITS + 1)*LATENCY_SUB_BUCKETS)
+
+
+//Log-linear histogram of latencies in nanoseconds. Values are recorded with atomic increments and without locks, so
+//producer, worker and gui thread can all record into the same histogram while it is read. Statistics read during
+//recording may be off by the values that are recorded at that moment.
+class LatencyHistogram
+{
+public:
+	LatencyHistogram();
+
+	void record(qint64 latencyNs);
+	void reset();
+	quint64 getCount() const {return this->count.loadAcquire();}
+	qint64 getMax() const {return this->max.loadAcquire();}
+	double getMean() const;
+	qint64 percentile(double fraction) const;
+
+	static int bucketIndex(quint64 latencyNs);
+	static qint64 bucketUpperBound(int index);
+
+private:
+	QAtomicInteger<quint64> buckets[LATENCY_BUCKETS];
+	QAtomicInteger<quint64> count;
+	QAtomicInteger<quint64> sum;
+	QAtomicInteger<qint64> max;
+};
+
+#endif //LATENCYHISTOGRAM_H
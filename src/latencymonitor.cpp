@@ -0,0 +1,60 @@
+#include "latencymonitor.h"
+
+
+LatencyMonitor::LatencyMonitor()
+{
+	this->clock.start();
+}
+
+void LatencyMonitor::record(LATENCY_STAGE stage, qint64 latencyNs) {
+	if (stage < 0 || stage >= STAGE_COUNT) {
+		return;
+	}
+	this->histograms[stage].record(latencyNs);
+}
+
+void LatencyMonitor::record(LATENCY_STAGE stage, qint64 startNs, qint64 endNs) {
+	//timestamps of -1 mark hops that were skipped, for example for a reanalysis of the last frame
+	if (startNs < 0 || endNs < 0) {
+		return;
+	}
+	this->record(stage, endNs - startNs);
+}
+
+void LatencyMonitor::reset() {
+	for (int i = 0; i < STAGE_COUNT; ++i) {
+		this->histograms[i].reset();
+	}
+}
+
+QString LatencyMonitor::toCsv() const {
+	//same separator as the curves exported from the line plot
+	QString csv = "Stage;Count;p50 [us];p90 [us];p99 [us];Max [us];Mean [us]\n";
+	for (int i = 0; i < STAGE_COUNT; ++i) {
+		const LatencyHistogram& histogram = this->histograms[i];
+		csv += stageName(static_cast<LATENCY_STAGE>(i)) + ";" + QString::number(histogram.getCount())
+			+ ";" + QString::number(static_cast<double>(histogram.percentile(0.5))/1000.0, 'f', 3)
+			+ ";" + QString::number(static_cast<double>(histogram.percentile(0.9))/1000.0, 'f', 3)
+			+ ";" + QString::number(static_cast<double>(histogram.percentile(0.99))/1000.0, 'f', 3)
+			+ ";" + QString::number(static_cast<double>(histogram.getMax())/1000.0, 'f', 3)
+			+ ";" + QString::number(histogram.getMean()/1000.0, 'f', 3) + "\n";
+	}
+	return csv;
+}
+
+QString LatencyMonitor::stageName(LATENCY_STAGE stage) {
+	switch (stage) {
+	case STAGE_COPY:
+		return "Copy";
+	case STAGE_QUEUE:
+		return "Queue";
+	case STAGE_ANALYSIS:
+		return "Analysis";
+	case STAGE_DISPLAY:
+		return "Display";
+	case STAGE_TOTAL:
+		return "Total";
+	default:
+		return "";
+	}
+}
@@ -0,0 +1,44 @@
+#ifndef LATENCYMONITOR_H
+#define LATENCYMONITOR_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QElapsedTimer>
+#include "latencyhistogram.h"
+
+//interval in which the form updates the latency statistics
+#define LATENCY_DISPLAY_INTERVAL_MS 500
+
+
+enum LATENCY_STAGE{
+	STAGE_COPY,
+	STAGE_QUEUE,
+	STAGE_ANALYSIS,
+	STAGE_DISPLAY,
+	STAGE_TOTAL,
+	STAGE_COUNT
+};
+
+//Latencies of every hop from the arrival of a buffer in processedDataReceived to the display of its peak: copy into
+//the frame ring, waiting in the queue of the peak finder thread, analysis and delivery to the gui. All threads take
+//their timestamps from the same monotonic clock, every stage is recorded by the thread that finishes it.
+class LatencyMonitor
+{
+public:
+	LatencyMonitor();
+
+	qint64 now() const {return this->clock.nsecsElapsed();}
+	void record(LATENCY_STAGE stage, qint64 latencyNs);
+	void record(LATENCY_STAGE stage, qint64 startNs, qint64 endNs);
+	void reset();
+	const LatencyHistogram& getHistogram(LATENCY_STAGE stage) const {return this->histograms[stage];}
+	QString toCsv() const;
+
+	static QString stageName(LATENCY_STAGE stage);
+
+private:
+	QElapsedTimer clock;
+	LatencyHistogram histograms[STAGE_COUNT];
+};
+
+#endif //LATENCYMONITOR_H
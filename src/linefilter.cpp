@@ -0,0 +1,163 @@
+#include "linefilter.h"
+#include <QtMath>
+#include <cstring>
+
+#ifdef CPUFEATURES_X86
+#include <immintrin.h>
+#endif
+
+
+LineFilter::LineFilter()
+	: type(FILTER_NONE),
+	halfWidth(0)
+{
+
+}
+
+void LineFilter::setFilter(LINE_FILTER type, int halfWidth) {
+	if (type < FILTER_NONE || type > FILTER_GAUSSIAN) {
+		type = FILTER_NONE;
+	}
+	halfWidth = qBound(0, halfWidth, MAX_LINE_FILTER_HALF_WIDTH);
+	if (type == this->type && halfWidth == this->halfWidth) {
+		return;
+	}
+	this->type = type;
+	this->halfWidth = halfWidth;
+
+	int size = 2*halfWidth+1;
+	this->coefficients.resize(size);
+	if (type == FILTER_BOXCAR || type == FILTER_NONE || halfWidth == 0) {
+		this->coefficients.fill(1.0/size);
+	} else if (type == FILTER_SAVITZKY_GOLAY) {
+		//smoothing coefficients of a least squares fit of a quadratic polynomial, for halfWidth 1 this is the identity
+		double m = halfWidth;
+		double denominator = (2.0*m+3.0)*(2.0*m+1.0)*(2.0*m-1.0);
+		for (int i = -halfWidth; i <= halfWidth; ++i) {
+			this->coefficients[i+halfWidth] = 3.0*(3.0*m*m + 3.0*m - 1.0 - 5.0*i*i) / denominator;
+		}
+	} else if (type == FILTER_GAUSSIAN) {
+		//kernel is truncated at three sigma and normalized so the gain stays 1
+		double sigma = halfWidth/3.0;
+		double sum = 0.0;
+		for (int i = -halfWidth; i <= halfWidth; ++i) {
+			double weight = qExp(-0.5*i*i/(sigma*sigma));
+			this->coefficients[i+halfWidth] = weight;
+			sum += weight;
+		}
+		for (int i = 0; i < size; ++i) {
+			this->coefficients[i] /= sum;
+		}
+	}
+}
+
+void LineFilter::apply(qreal* line, int length) {
+	this->apply(line, length, CpuFeatures::getKernel());
+}
+
+void LineFilter::apply(qreal* line, int length, SIMD_KERNEL kernel) {
+	if (!this->isActive() || line == nullptr || length <= 0) {
+		return;
+	}
+
+	//copy of the line with replicated border samples, so the convolution never has to check the line bounds
+	int paddedLength = length + 2*this->halfWidth;
+	if (this->paddedLine.size() < paddedLength) {
+		this->paddedLine.resize(paddedLength);
+	}
+	qreal* padded = this->paddedLine.data();
+	for (int i = 0; i < this->halfWidth; ++i) {
+		padded[i] = line[0];
+		padded[this->halfWidth + length + i] = line[length-1];
+	}
+	memcpy(padded + this->halfWidth, line, static_cast<size_t>(length)*sizeof(qreal));
+
+	if (this->type == FILTER_BOXCAR) {
+		this->applyBoxcar(line, length);
+		return;
+	}
+
+	//vector kernels process as many full registers as possible, the remaining samples are handled by the scalar loop
+	const qreal* coefficients = this->coefficients.constData();
+	int coefficientCount = this->coefficients.size();
+	int processedSamples = 0;
+#ifdef CPUFEATURES_X86
+	if (kernel == KERNEL_AVX512) {
+		processedSamples = convolveAvx512(padded, length, coefficients, coefficientCount, line);
+	} else if (kernel == KERNEL_AVX2) {
+		processedSamples = convolveAvx2(padded, length, coefficients, coefficientCount, line);
+	} else if (kernel == KERNEL_SSE2) {
+		processedSamples = convolveSse2(padded, length, coefficients, coefficientCount, line);
+	}
+#else
+	Q_UNUSED(kernel)
+#endif
+	convolveScalar(padded, processedSamples, length, coefficients, coefficientCount, line);
+}
+
+void LineFilter::applyBoxcar(qreal* line, int length) {
+	//the window sum is updated with one sample entering and one leaving, which is cheaper than a convolution from a width of about 3
+	const qreal* padded = this->paddedLine.constData();
+	int size = 2*this->halfWidth+1;
+	qreal weight = 1.0/size;
+	qreal sum = 0.0;
+	for (int i = 0; i < size; ++i) {
+		sum += padded[i];
+	}
+	line[0] = sum*weight;
+	for (int x = 1; x < length; ++x) {
+		sum += padded[x+size-1] - padded[x-1];
+		line[x] = sum*weight;
+	}
+}
+
+void LineFilter::convolveScalar(const qreal* input, int begin, int length, const qreal* coefficients, int coefficientCount, qreal* output) {
+	for (int x = begin; x < length; ++x) {
+		qreal sum = 0.0;
+		for (int k = 0; k < coefficientCount; ++k) {
+			sum += coefficients[k]*input[x+k];
+		}
+		output[x] = sum;
+	}
+}
+
+#ifdef CPUFEATURES_X86
+//Each register holds consecutive output samples. For every coefficient the input is loaded shifted by one sample, so
+//all loads are unaligned but the coefficients only have to be broadcast once per register.
+
+TARGET_SSE2 int LineFilter::convolveSse2(const qreal* input, int length, const qreal* coefficients, int coefficientCount, qreal* output) {
+	int x = 0;
+	for (; x + 2 <= length; x += 2) {
+		__m128d sum = _mm_setzero_pd();
+		for (int k = 0; k < coefficientCount; ++k) {
+			sum = _mm_add_pd(sum, _mm_mul_pd(_mm_set1_pd(coefficients[k]), _mm_loadu_pd(input + x + k)));
+		}
+		_mm_storeu_pd(output + x, sum);
+	}
+	return x;
+}
+
+TARGET_AVX2 int LineFilter::convolveAvx2(const qreal* input, int length, const qreal* coefficients, int coefficientCount, qreal* output) {
+	int x = 0;
+	for (; x + 4 <= length; x += 4) {
+		__m256d sum = _mm256_setzero_pd();
+		for (int k = 0; k < coefficientCount; ++k) {
+			sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_set1_pd(coefficients[k]), _mm256_loadu_pd(input + x + k)));
+		}
+		_mm256_storeu_pd(output + x, sum);
+	}
+	return x;
+}
+
+TARGET_AVX512 int LineFilter::convolveAvx512(const qreal* input, int length, const qreal* coefficients, int coefficientCount, qreal* output) {
+	int x = 0;
+	for (; x + 8 <= length; x += 8) {
+		__m512d sum = _mm512_setzero_pd();
+		for (int k = 0; k < coefficientCount; ++k) {
+			sum = _mm512_add_pd(sum, _mm512_mul_pd(_mm512_set1_pd(coefficients[k]), _mm512_loadu_pd(input + x + k)));
+		}
+		_mm512_storeu_pd(output + x, sum);
+	}
+	return x;
+}
+#endif
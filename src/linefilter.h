@@ -0,0 +1,46 @@
+#ifndef LINEFILTER_H
+#define LINEFILTER_H
+
+#include <QtGlobal>
+#include <QVector>
+#include "cpufeatures.h"
+#include "peakdetectorparameters.h"
+
+#define DEFAULT_LINE_FILTER_HALF_WIDTH 3
+#define MAX_LINE_FILTER_HALF_WIDTH 64
+
+
+//Smooths a line in place with a symmetric kernel of 2*halfWidth+1 coefficients that is precomputed in setFilter(). The
+//boxcar is a running sum, so its cost does not depend on the width. Savitzky-Golay (quadratic fit) and gaussian
+//(sigma = halfWidth/3) are convolutions that are vectorized over consecutive output samples. Samples beyond the ends of
+//the line are replaced by the first and last sample, so a constant line stays constant up to the borders.
+class LineFilter
+{
+public:
+	LineFilter();
+
+	void setFilter(LINE_FILTER type, int halfWidth);
+	LINE_FILTER getType() const {return this->type;}
+	int getHalfWidth() const {return this->halfWidth;}
+	const QVector<qreal>& getCoefficients() const {return this->coefficients;}
+	bool isActive() const {return this->type != FILTER_NONE && this->halfWidth > 0;}
+
+	void apply(qreal* line, int length);
+	void apply(qreal* line, int length, SIMD_KERNEL kernel);
+
+private:
+	LINE_FILTER type;
+	int halfWidth;
+	QVector<qreal> coefficients;
+	QVector<qreal> paddedLine;
+
+	void applyBoxcar(qreal* line, int length);
+	static void convolveScalar(const qreal* input, int begin, int length, const qreal* coefficients, int coefficientCount, qreal* output);
+#ifdef CPUFEATURES_X86
+	static int convolveSse2(const qreal* input, int length, const qreal* coefficients, int coefficientCount, qreal* output);
+	static int convolveAvx2(const qreal* input, int length, const qreal* coefficients, int coefficientCount, qreal* output);
+	static int convolveAvx512(const qreal* input, int length, const qreal* coefficients, int coefficientCount, qreal* output);
+#endif
+};
+
+#endif //LINEFILTER_H
@@ -0,0 +1,309 @@
+#include "linepeaksearch.h"
+#include <QtAlgorithms>
+
+#ifdef CPUFEATURES_X86
+#include <immintrin.h>
+#endif
+
+
+int LinePeakSearch::findLinePeaks(const void* data, unsigned int bitDepth, size_t stride, const QRect& roi, qreal threshold, int* positions) {
+	return findLinePeaks(data, bitDepth, stride, roi, threshold, positions, CpuFeatures::getKernel());
+}
+
+int LinePeakSearch::findLinePeaks(const void* data, unsigned int bitDepth, size_t stride, const QRect& roi, qreal threshold, int* positions, SIMD_KERNEL kernel) {
+	if (roi.width() <= 0 || roi.height() <= 0) {
+		return 0;
+	}
+
+	if (bitDepth <= 8) {
+		return findLinePeaks<quint8>(static_cast<const quint8*>(data), stride, roi, threshold, positions, kernel);
+	} else if (bitDepth > 8 && bitDepth <= 16) {
+		return findLinePeaks<quint16>(static_cast<const quint16*>(data), stride, roi, threshold, positions, kernel);
+	} else if (bitDepth > 16 && bitDepth <= 32) {
+		return findLinePeaks<quint32>(static_cast<const quint32*>(data), stride, roi, threshold, positions, kernel);
+	}
+	return 0;
+}
+
+template<typename T>
+int LinePeakSearch::findLinePeaks(const T* data, size_t stride, const QRect& roi, qreal threshold, int* positions, SIMD_KERNEL kernel) {
+	int roiWidth = roi.width();
+	int peakCount = 0;
+	for (int y = 0; y < roi.height(); ++y) {
+		const T* line = data + static_cast<size_t>(roi.y() + y)*stride + roi.x();
+
+		//single sweep over the line. Vector kernels process as many full registers as possible, the remaining samples
+		//are handled by the scalar loop. A sample only replaces the maximum if it is larger, so the first occurrence is kept
+		quint32 max = 0;
+		int position = 0;
+		int processedSamples = 0;
+#ifdef CPUFEATURES_X86
+		if (kernel == KERNEL_AVX512) {
+			processedSamples = findPeakAvx512(line, roiWidth, &max, &position);
+		} else if (kernel == KERNEL_AVX2) {
+			processedSamples = findPeakAvx2(line, roiWidth, &max, &position);
+		} else if (kernel == KERNEL_SSE2) {
+			processedSamples = findPeakSse2(line, roiWidth, &max, &position);
+		}
+#endif
+		for (int x = processedSamples; x < roiWidth; ++x) {
+			if (static_cast<quint32>(line[x]) > max) {
+				max = line[x];
+				position = x;
+			}
+		}
+		if (!(static_cast<qreal>(max) > threshold)) {
+			positions[y] = -1;
+			continue;
+		}
+		positions[y] = position;
+		peakCount++;
+	}
+	return peakCount;
+}
+
+template<typename T>
+void LinePeakSearch::mergeLanes(const T* laneMax, const T* laneBlocks, int lanes, int offset, quint32* max, int* position) {
+	//every lane holds its maximum and the block of its first occurrence, ties between lanes go to the first position
+	for (int i = 0; i < lanes; i++) {
+		quint32 value = laneMax[i];
+		int lanePosition = offset + static_cast<int>(laneBlocks[i])*lanes + i;
+		if (value > *max || (value == *max && lanePosition < *position)) {
+			*max = value;
+			*position = lanePosition;
+		}
+	}
+}
+
+#ifdef CPUFEATURES_X86
+//The peak kernels keep the maximum of every lane and the number of the block in which it was found first, a larger
+//sample replaces both (compare and select). Block numbers are counted in lanes of the sample width, so the lanes are
+//merged into max and position after at most as many blocks as the lane can count. The kernels return the number of
+//samples they have processed.
+
+TARGET_SSE2 int LinePeakSearch::findPeakSse2(const quint8* line, int length, quint32* max, int* position) {
+	const __m128i one = _mm_set1_epi8(1);
+	int x = 0;
+	while (x + 16 <= length) {
+		int blocks = qMin((length - x)/16, 255);
+		__m128i maxValues = _mm_setzero_si128();
+		__m128i maxBlocks = _mm_setzero_si128();
+		__m128i block = _mm_setzero_si128();
+		for (int i = 0; i < blocks; i++) {
+			__m128i newMax = _mm_max_epu8(maxValues, _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x + 16*i)));
+			__m128i unchanged = _mm_cmpeq_epi8(newMax, maxValues);
+			maxBlocks = _mm_or_si128(_mm_and_si128(unchanged, maxBlocks), _mm_andnot_si128(unchanged, block));
+			maxValues = newMax;
+			block = _mm_add_epi8(block, one);
+		}
+		alignas(16) quint8 laneMax[16];
+		alignas(16) quint8 laneBlocks[16];
+		_mm_store_si128(reinterpret_cast<__m128i*>(laneMax), maxValues);
+		_mm_store_si128(reinterpret_cast<__m128i*>(laneBlocks), maxBlocks);
+		mergeLanes(laneMax, laneBlocks, 16, x, max, position);
+		x += blocks*16;
+	}
+	return x;
+}
+
+TARGET_SSE2 int LinePeakSearch::findPeakSse2(const quint16* line, int length, quint32* max, int* position) {
+	//sse2 has no unsigned 16-bit compare, flipping the sign bit maps unsigned order to signed order
+	const __m128i signBit = _mm_set1_epi16(static_cast<short>(0x8000));
+	const __m128i one = _mm_set1_epi16(1);
+	int x = 0;
+	while (x + 8 <= length) {
+		int blocks = qMin((length - x)/8, 65535);
+		__m128i maxValues = signBit;
+		__m128i maxBlocks = _mm_setzero_si128();
+		__m128i block = _mm_setzero_si128();
+		for (int i = 0; i < blocks; i++) {
+			__m128i samples = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(line + x + 8*i)), signBit);
+			__m128i greater = _mm_cmpgt_epi16(samples, maxValues);
+			maxValues = _mm_or_si128(_mm_and_si128(greater, samples), _mm_andnot_si128(greater, maxValues));
+			maxBlocks = _mm_or_si128(_mm_and_si128(greater, block), _mm_andnot_si128(greater, maxBlocks));
+			block = _mm_add_epi16(block, one);
+		}
+		alignas(16) quint16 laneMax[8];
+		alignas(16) quint16 laneBlocks[8];
+		_mm_store_si128(reinterpret_cast<__m128i*>(laneMax), _mm_xor_si128(maxValues, signBit));
+		_mm_store_si128(reinterpret_cast<__m128i*>(laneBlocks), maxBlocks);
+		mergeLanes(laneMax, laneBlocks, 8, x, max, position);
+		x += blocks*8;
+	}
+	return x;
+}
+
+TARGET_SSE2 int LinePeakSearch::findPeakSse2(const quint32* line, int length, quint32* max, int* position) {
+	//no unsigned 32-bit compare in sse2 either, same sign flip as for 16 bit
+	const __m128i signBit = _mm_set1_epi32(static_cast<int>(0x80000000));
+	const __m128i one = _mm_set1_epi32(1);
+	int x = 0;
+	int blocks = length/4;
+	__m128i maxValues = signBit;
+	__m128i maxBlocks = _mm_setzero_si128();
+	__m128i block = _mm_setzero_si128();
+	for (int i = 0; i < blocks; i++) {
+		__m128i samples = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(line + 4*i)), signBit);
+		__m128i greater = _mm_cmpgt_epi32(samples, maxValues);
+		maxValues = _mm_or_si128(_mm_and_si128(greater, samples), _mm_andnot_si128(greater, maxValues));
+		maxBlocks = _mm_or_si128(_mm_and_si128(greater, block), _mm_andnot_si128(greater, maxBlocks));
+		block = _mm_add_epi32(block, one);
+	}
+	if (blocks > 0) {
+		alignas(16) quint32 laneMax[4];
+		alignas(16) quint32 laneBlocks[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(laneMax), _mm_xor_si128(maxValues, signBit));
+		_mm_store_si128(reinterpret_cast<__m128i*>(laneBlocks), maxBlocks);
+		mergeLanes(laneMax, laneBlocks, 4, x, max, position);
+		x = blocks*4;
+	}
+	return x;
+}
+
+TARGET_AVX2 int LinePeakSearch::findPeakAvx2(const quint8* line, int length, quint32* max, int* position) {
+	const __m256i one = _mm256_set1_epi8(1);
+	int x = 0;
+	while (x + 32 <= length) {
+		int blocks = qMin((length - x)/32, 255);
+		__m256i maxValues = _mm256_setzero_si256();
+		__m256i maxBlocks = _mm256_setzero_si256();
+		__m256i block = _mm256_setzero_si256();
+		for (int i = 0; i < blocks; i++) {
+			__m256i newMax = _mm256_max_epu8(maxValues, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(line + x + 32*i)));
+			maxBlocks = _mm256_blendv_epi8(block, maxBlocks, _mm256_cmpeq_epi8(newMax, maxValues));
+			maxValues = newMax;
+			block = _mm256_add_epi8(block, one);
+		}
+		alignas(32) quint8 laneMax[32];
+		alignas(32) quint8 laneBlocks[32];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(laneMax), maxValues);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(laneBlocks), maxBlocks);
+		mergeLanes(laneMax, laneBlocks, 32, x, max, position);
+		x += blocks*32;
+	}
+	return x;
+}
+
+TARGET_AVX2 int LinePeakSearch::findPeakAvx2(const quint16* line, int length, quint32* max, int* position) {
+	const __m256i one = _mm256_set1_epi16(1);
+	int x = 0;
+	while (x + 16 <= length) {
+		int blocks = qMin((length - x)/16, 65535);
+		__m256i maxValues = _mm256_setzero_si256();
+		__m256i maxBlocks = _mm256_setzero_si256();
+		__m256i block = _mm256_setzero_si256();
+		for (int i = 0; i < blocks; i++) {
+			__m256i newMax = _mm256_max_epu16(maxValues, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(line + x + 16*i)));
+			maxBlocks = _mm256_blendv_epi8(block, maxBlocks, _mm256_cmpeq_epi16(newMax, maxValues));
+			maxValues = newMax;
+			block = _mm256_add_epi16(block, one);
+		}
+		alignas(32) quint16 laneMax[16];
+		alignas(32) quint16 laneBlocks[16];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(laneMax), maxValues);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(laneBlocks), maxBlocks);
+		mergeLanes(laneMax, laneBlocks, 16, x, max, position);
+		x += blocks*16;
+	}
+	return x;
+}
+
+TARGET_AVX2 int LinePeakSearch::findPeakAvx2(const quint32* line, int length, quint32* max, int* position) {
+	const __m256i one = _mm256_set1_epi32(1);
+	int x = 0;
+	int blocks = length/8;
+	__m256i maxValues = _mm256_setzero_si256();
+	__m256i maxBlocks = _mm256_setzero_si256();
+	__m256i block = _mm256_setzero_si256();
+	for (int i = 0; i < blocks; i++) {
+		__m256i newMax = _mm256_max_epu32(maxValues, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(line + 8*i)));
+		maxBlocks = _mm256_blendv_epi8(block, maxBlocks, _mm256_cmpeq_epi32(newMax, maxValues));
+		maxValues = newMax;
+		block = _mm256_add_epi32(block, one);
+	}
+	if (blocks > 0) {
+		alignas(32) quint32 laneMax[8];
+		alignas(32) quint32 laneBlocks[8];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(laneMax), maxValues);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(laneBlocks), maxBlocks);
+		mergeLanes(laneMax, laneBlocks, 8, x, max, position);
+		x = blocks*8;
+	}
+	return x;
+}
+
+TARGET_AVX512 int LinePeakSearch::findPeakAvx512(const quint8* line, int length, quint32* max, int* position) {
+	const __m512i one = _mm512_set1_epi8(1);
+	int x = 0;
+	while (x + 64 <= length) {
+		int blocks = qMin((length - x)/64, 255);
+		__m512i maxValues = _mm512_setzero_si512();
+		__m512i maxBlocks = _mm512_setzero_si512();
+		__m512i block = _mm512_setzero_si512();
+		for (int i = 0; i < blocks; i++) {
+			__m512i samples = _mm512_loadu_si512(line + x + 64*i);
+			__mmask64 greater = _mm512_cmpgt_epu8_mask(samples, maxValues);
+			maxValues = _mm512_mask_mov_epi8(maxValues, greater, samples);
+			maxBlocks = _mm512_mask_mov_epi8(maxBlocks, greater, block);
+			block = _mm512_add_epi8(block, one);
+		}
+		alignas(64) quint8 laneMax[64];
+		alignas(64) quint8 laneBlocks[64];
+		_mm512_store_si512(laneMax, maxValues);
+		_mm512_store_si512(laneBlocks, maxBlocks);
+		mergeLanes(laneMax, laneBlocks, 64, x, max, position);
+		x += blocks*64;
+	}
+	return x;
+}
+
+TARGET_AVX512 int LinePeakSearch::findPeakAvx512(const quint16* line, int length, quint32* max, int* position) {
+	const __m512i one = _mm512_set1_epi16(1);
+	int x = 0;
+	while (x + 32 <= length) {
+		int blocks = qMin((length - x)/32, 65535);
+		__m512i maxValues = _mm512_setzero_si512();
+		__m512i maxBlocks = _mm512_setzero_si512();
+		__m512i block = _mm512_setzero_si512();
+		for (int i = 0; i < blocks; i++) {
+			__m512i samples = _mm512_loadu_si512(line + x + 32*i);
+			__mmask32 greater = _mm512_cmpgt_epu16_mask(samples, maxValues);
+			maxValues = _mm512_mask_mov_epi16(maxValues, greater, samples);
+			maxBlocks = _mm512_mask_mov_epi16(maxBlocks, greater, block);
+			block = _mm512_add_epi16(block, one);
+		}
+		alignas(64) quint16 laneMax[32];
+		alignas(64) quint16 laneBlocks[32];
+		_mm512_store_si512(laneMax, maxValues);
+		_mm512_store_si512(laneBlocks, maxBlocks);
+		mergeLanes(laneMax, laneBlocks, 32, x, max, position);
+		x += blocks*32;
+	}
+	return x;
+}
+
+TARGET_AVX512 int LinePeakSearch::findPeakAvx512(const quint32* line, int length, quint32* max, int* position) {
+	const __m512i one = _mm512_set1_epi32(1);
+	int x = 0;
+	int blocks = length/16;
+	__m512i maxValues = _mm512_setzero_si512();
+	__m512i maxBlocks = _mm512_setzero_si512();
+	__m512i block = _mm512_setzero_si512();
+	for (int i = 0; i < blocks; i++) {
+		__m512i samples = _mm512_loadu_si512(line + 16*i);
+		__mmask16 greater = _mm512_cmpgt_epu32_mask(samples, maxValues);
+		maxValues = _mm512_mask_mov_epi32(maxValues, greater, samples);
+		maxBlocks = _mm512_mask_mov_epi32(maxBlocks, greater, block);
+		block = _mm512_add_epi32(block, one);
+	}
+	if (blocks > 0) {
+		alignas(64) quint32 laneMax[16];
+		alignas(64) quint32 laneBlocks[16];
+		_mm512_store_si512(laneMax, maxValues);
+		_mm512_store_si512(laneBlocks, maxBlocks);
+		mergeLanes(laneMax, laneBlocks, 16, x, max, position);
+		x = blocks*16;
+	}
+	return x;
+}
+#endif
@@ -0,0 +1,37 @@
+#ifndef LINEPEAKSEARCH_H
+#define LINEPEAKSEARCH_H
+
+#include <QtGlobal>
+#include <QRect>
+#include "cpufeatures.h"
+
+
+//Finds the position of the maximum in every line (A-scan) of a ROI. The roi is given relative to data, consecutive lines
+//are stride samples apart. positions needs space for roi.height() values and receives the column of the first maximum
+//relative to roi.x() or -1 if the maximum of the line is not above threshold. The vector kernels find maximum and
+//position in a single sweep: every lane keeps its maximum and the block it first occurred in, and the lanes are merged
+//to the first position of the maximum, so all kernels produce exactly the same result. Returns the number of lines
+//with a peak.
+class LinePeakSearch
+{
+public:
+	static int findLinePeaks(const void* data, unsigned int bitDepth, size_t stride, const QRect& roi, qreal threshold, int* positions);
+	static int findLinePeaks(const void* data, unsigned int bitDepth, size_t stride, const QRect& roi, qreal threshold, int* positions, SIMD_KERNEL kernel);
+
+private:
+	template <typename T> static int findLinePeaks(const T* data, size_t stride, const QRect& roi, qreal threshold, int* positions, SIMD_KERNEL kernel);
+	template <typename T> static void mergeLanes(const T* laneMax, const T* laneBlocks, int lanes, int offset, quint32* max, int* position);
+#ifdef CPUFEATURES_X86
+	static int findPeakSse2(const quint8* line, int length, quint32* max, int* position);
+	static int findPeakSse2(const quint16* line, int length, quint32* max, int* position);
+	static int findPeakSse2(const quint32* line, int length, quint32* max, int* position);
+	static int findPeakAvx2(const quint8* line, int length, quint32* max, int* position);
+	static int findPeakAvx2(const quint16* line, int length, quint32* max, int* position);
+	static int findPeakAvx2(const quint32* line, int length, quint32* max, int* position);
+	static int findPeakAvx512(const quint8* line, int length, quint32* max, int* position);
+	static int findPeakAvx512(const quint16* line, int length, quint32* max, int* position);
+	static int findPeakAvx512(const quint32* line, int length, quint32* max, int* position);
+#endif
+};
+
+#endif //LINEPEAKSEARCH_H
@@ -32,6 +32,12 @@ LinePlot::LinePlot(QWidget* parent) : QCustomPlot(parent){
 	this->addGraph();
 	this->setReferenceCurveColor(referenceCurveColor);
 
+	//configure marker graph, it only draws scatter points, e.g. for detected peaks
+	this->markerGraph = this->addGraph();
+	this->markerGraph->setLineStyle(QCPGraph::lsNone);
+	this->markerGraph->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssCircle, QPen(QColor(250, 200, 50)), QBrush(Qt::NoBrush), 7));
+	this->markerGraph->removeFromLegend();
+
 	//configure axis
 	this->setAxisVisible(false);
 	this->setAxisColor(Qt::white);
@@ -109,6 +115,7 @@ void LinePlot::setAxisVisible(bool visible) {
 }
 
 void LinePlot::plotLine(QVector<qreal> line) {
+	TRACE_SCOPE("LinePlot::plotLine");
 	// Check if the line data is empty
 	if (line.isEmpty()) {
 		emit error(tr("Could not plot data. Data seems to be empty."));
@@ -391,6 +398,22 @@ void LinePlot::setHorizontalLineVisible(bool visible) {
 	this->lineB->setVisible(visible);
 }
 
+void LinePlot::plotMarkers(QVector<QPointF> markers) {
+	QVector<double> x(markers.size());
+	QVector<double> y(markers.size());
+	for (int i = 0; i < markers.size(); ++i) {
+		x[i] = markers.at(i).x();
+		y[i] = markers.at(i).y();
+	}
+	this->markerGraph->setData(x, y, true);
+	this->replot();
+}
+
+void LinePlot::setMarkersVisible(bool visible) {
+	this->markerGraph->setVisible(visible);
+	this->replot();
+}
+
 void LinePlot::scaleYAxis(double min, double max) {
 	this->customRange = true;
 	this->customRangeLower = min;
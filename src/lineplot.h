@@ -2,6 +2,7 @@
 #define LINEPLOT_H
 
 #include "qcustomplot.h"
+#include "tracerecorder.h"
 
 class LinePlot : public QCustomPlot
 {
@@ -38,6 +39,7 @@ private:
 	int referenceCurveAlpha;
 	QCPItemStraightLine* lineA;
 	QCPItemStraightLine* lineB;
+	QCPGraph* markerGraph;
 	double customRangeLower;
 	double customRangeUpper;
 	bool customRange;
@@ -66,6 +68,8 @@ public slots:
 	void setHorizontalLine(double xPos);
 	void setVerticalLineVisible(bool visible);
 	void setHorizontalLineVisible(bool visible);
+	void plotMarkers(QVector<QPointF> markers);
+	void setMarkersVisible(bool visible);
 	void scaleYAxis(double min, double max);
 	bool saveCurveDataToFile(QString fileName);
 	bool saveAllCurvesToFile(QString fileName);
@@ -0,0 +1,134 @@
+#include "maxsearch.h"
+
+#ifdef CPUFEATURES_X86
+#include <immintrin.h>
+#endif
+
+
+int MaxSearch::findMaxValuePosition(const qreal* line, int length, qreal threshold) {
+	return findMaxValuePosition(line, length, threshold, CpuFeatures::getKernel());
+}
+
+int MaxSearch::findMaxValuePosition(const qreal* line, int length, qreal threshold, SIMD_KERNEL kernel) {
+	if (length <= 0) {
+		return -1;
+	}
+
+	//vector kernels first determine the maximum of all values above threshold and then search its first position
+	qreal max = line[0];
+#ifdef CPUFEATURES_X86
+	if (kernel == KERNEL_AVX512) {
+		max = findMaxAvx512(line, length, threshold);
+	} else if (kernel == KERNEL_AVX2) {
+		max = findMaxAvx2(line, length, threshold);
+	} else if (kernel == KERNEL_SSE2) {
+		max = findMaxSse2(line, length, threshold);
+	} else {
+		return findMaxValuePositionScalar(line, length, threshold);
+	}
+#else
+	Q_UNUSED(kernel)
+	return findMaxValuePositionScalar(line, length, threshold);
+#endif
+	if (!(max > line[0])) {
+		return -1;
+	}
+	return findFirstPosition(line, 1, length, max);
+}
+
+int MaxSearch::findMaxValuePositionScalar(const qreal* line, int length, qreal threshold) {
+	qreal max = line[0];
+	int maxPos = -1;
+	for (int i = 1; i < length; i++) {
+		if (line[i] > threshold && line[i] > max) {
+			max = line[i];
+			maxPos = i;
+		}
+	}
+
+	return maxPos;
+}
+
+int MaxSearch::findFirstPosition(const qreal* line, int begin, int length, qreal value) {
+	for (int i = begin; i < length; i++) {
+		if (line[i] == value) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+#ifdef CPUFEATURES_X86
+//Values below or equal to threshold are replaced by the first value of the line, so they can never become the maximum.
+//The search starts at index 1, the remaining values that do not fill a whole register are checked with scalar code.
+
+TARGET_SSE2 qreal MaxSearch::findMaxSse2(const qreal* line, int length, qreal threshold) {
+	const __m128d first = _mm_set1_pd(line[0]);
+	const __m128d limit = _mm_set1_pd(threshold);
+	__m128d maxA = first;
+	__m128d maxB = first;
+	int i = 1;
+	for (; i + 4 <= length; i += 4) {
+		__m128d a = _mm_loadu_pd(line + i);
+		__m128d b = _mm_loadu_pd(line + i + 2);
+		__m128d maskA = _mm_cmpgt_pd(a, limit);
+		__m128d maskB = _mm_cmpgt_pd(b, limit);
+		maxA = _mm_max_pd(maxA, _mm_or_pd(_mm_and_pd(maskA, a), _mm_andnot_pd(maskA, first)));
+		maxB = _mm_max_pd(maxB, _mm_or_pd(_mm_and_pd(maskB, b), _mm_andnot_pd(maskB, first)));
+	}
+	alignas(16) qreal lanes[4];
+	_mm_store_pd(lanes, maxA);
+	_mm_store_pd(lanes + 2, maxB);
+	qreal max = qMax(qMax(lanes[0], lanes[1]), qMax(lanes[2], lanes[3]));
+	for (; i < length; i++) {
+		if (line[i] > threshold && line[i] > max) {
+			max = line[i];
+		}
+	}
+	return max;
+}
+
+TARGET_AVX2 qreal MaxSearch::findMaxAvx2(const qreal* line, int length, qreal threshold) {
+	const __m256d first = _mm256_set1_pd(line[0]);
+	const __m256d limit = _mm256_set1_pd(threshold);
+	__m256d maxA = first;
+	__m256d maxB = first;
+	int i = 1;
+	for (; i + 8 <= length; i += 8) {
+		__m256d a = _mm256_loadu_pd(line + i);
+		__m256d b = _mm256_loadu_pd(line + i + 4);
+		maxA = _mm256_max_pd(maxA, _mm256_blendv_pd(first, a, _mm256_cmp_pd(a, limit, _CMP_GT_OQ)));
+		maxB = _mm256_max_pd(maxB, _mm256_blendv_pd(first, b, _mm256_cmp_pd(b, limit, _CMP_GT_OQ)));
+	}
+	alignas(32) qreal lanes[4];
+	_mm256_store_pd(lanes, _mm256_max_pd(maxA, maxB));
+	qreal max = qMax(qMax(lanes[0], lanes[1]), qMax(lanes[2], lanes[3]));
+	for (; i < length; i++) {
+		if (line[i] > threshold && line[i] > max) {
+			max = line[i];
+		}
+	}
+	return max;
+}
+
+TARGET_AVX512 qreal MaxSearch::findMaxAvx512(const qreal* line, int length, qreal threshold) {
+	const __m512d first = _mm512_set1_pd(line[0]);
+	const __m512d limit = _mm512_set1_pd(threshold);
+	__m512d maxA = first;
+	__m512d maxB = first;
+	int i = 1;
+	for (; i + 16 <= length; i += 16) {
+		__m512d a = _mm512_loadu_pd(line + i);
+		__m512d b = _mm512_loadu_pd(line + i + 8);
+		maxA = _mm512_mask_max_pd(maxA, _mm512_cmp_pd_mask(a, limit, _CMP_GT_OQ), maxA, a);
+		maxB = _mm512_mask_max_pd(maxB, _mm512_cmp_pd_mask(b, limit, _CMP_GT_OQ), maxB, b);
+	}
+	qreal max = _mm512_reduce_max_pd(_mm512_max_pd(maxA, maxB));
+	for (; i < length; i++) {
+		if (line[i] > threshold && line[i] > max) {
+			max = line[i];
+		}
+	}
+	return max;
+}
+#endif
@@ -0,0 +1,27 @@
+#ifndef MAXSEARCH_H
+#define MAXSEARCH_H
+
+#include <QtGlobal>
+#include "cpufeatures.h"
+
+
+//Finds the position of the maximum of a line. Only values above threshold are taken into account and the maximum has to
+//be larger than the first value of the line, otherwise -1 is returned. If the maximum occurs more than once, the first
+//position is returned.
+class MaxSearch
+{
+public:
+	static int findMaxValuePosition(const qreal* line, int length, qreal threshold);
+	static int findMaxValuePosition(const qreal* line, int length, qreal threshold, SIMD_KERNEL kernel);
+
+private:
+	static int findMaxValuePositionScalar(const qreal* line, int length, qreal threshold);
+	static int findFirstPosition(const qreal* line, int begin, int length, qreal value);
+#ifdef CPUFEATURES_X86
+	static qreal findMaxSse2(const qreal* line, int length, qreal threshold);
+	static qreal findMaxAvx2(const qreal* line, int length, qreal threshold);
+	static qreal findMaxAvx512(const qreal* line, int length, qreal threshold);
+#endif
+};
+
+#endif //MAXSEARCH_H
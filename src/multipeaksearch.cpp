@@ -0,0 +1,113 @@
+#include "multipeaksearch.h"
+#include <algorithm>
+
+namespace {
+	//heap order with the lowest peak at the front
+	bool isHigher(const DetectedPeak& a, const DetectedPeak& b) {
+		return a.height > b.height;
+	}
+
+	bool isLeftOf(const DetectedPeak& a, const DetectedPeak& b) {
+		return a.position < b.position;
+	}
+}
+
+
+MultiPeakSearch::MultiPeakSearch()
+	: threshold(0),
+	maxPeaks(DEFAULT_MAX_PEAKS),
+	minDistance(DEFAULT_MIN_PEAK_DISTANCE),
+	minProminence(0)
+{
+	this->peaks.reserve(MAX_PEAKS);
+}
+
+int MultiPeakSearch::findPeaks(const qreal* line, int length, qreal threshold, int maxPeaks, int minDistance, qreal minProminence) {
+	//resize instead of clear to keep the allocated capacity for the next line
+	this->candidates.resize(0);
+	this->peaks.resize(0);
+	this->threshold = threshold;
+	this->maxPeaks = qBound(1, maxPeaks, MAX_PEAKS);
+	this->minDistance = minDistance;
+	this->minProminence = minProminence;
+	if (length < 3) {
+		return 0;
+	}
+
+	//valleyMin is the lowest value since the last local maximum
+	qreal valleyMin = line[0];
+	int plateauStart = -1;
+	for (int i = 1; i < length; i++) {
+		if (line[i] > line[i-1]) {
+			plateauStart = i;
+		} else if (line[i] < line[i-1] && plateauStart >= 0) {
+			this->addCandidate((plateauStart+i-1)/2, line[i-1], valleyMin);
+			plateauStart = -1;
+			valleyMin = line[i];
+			continue;
+		}
+		valleyMin = qMin(valleyMin, line[i]);
+	}
+
+	//remaining candidates have no higher peak to their right, their right base is the lowest value up to the end of the line
+	while (!this->candidates.isEmpty()) {
+		Candidate candidate = this->candidates.takeLast();
+		this->finishCandidate(candidate, valleyMin);
+		if (!this->candidates.isEmpty()) {
+			valleyMin = qMin(valleyMin, this->candidates.last().gapMin);
+		}
+	}
+
+	std::sort(this->peaks.begin(), this->peaks.end(), isLeftOf);
+	return this->peaks.size();
+}
+
+void MultiPeakSearch::addCandidate(int position, qreal height, qreal valleyMin) {
+	//new peak is the next higher peak for all lower candidates on the stack, so their right base is known now
+	while (!this->candidates.isEmpty() && this->candidates.last().height <= height) {
+		Candidate candidate = this->candidates.takeLast();
+		candidate.suppressed = candidate.suppressed || position-candidate.position < this->minDistance;
+		this->finishCandidate(candidate, valleyMin);
+		if (this->candidates.isEmpty()) {
+			valleyMin = qMin(valleyMin, candidate.leftBase);
+		} else {
+			valleyMin = qMin(valleyMin, this->candidates.last().gapMin);
+		}
+	}
+
+	//remaining top of the stack is the nearest higher peak to the left
+	Candidate candidate;
+	candidate.position = position;
+	candidate.height = height;
+	candidate.leftBase = valleyMin;
+	candidate.gapMin = height;
+	candidate.suppressed = false;
+	if (!this->candidates.isEmpty()) {
+		this->candidates.last().gapMin = valleyMin;
+		candidate.suppressed = position-this->candidates.last().position < this->minDistance;
+	}
+	this->candidates.append(candidate);
+}
+
+void MultiPeakSearch::finishCandidate(const Candidate& candidate, qreal rightBase) {
+	if (candidate.suppressed || !(candidate.height > this->threshold)) {
+		return;
+	}
+	DetectedPeak peak;
+	peak.position = candidate.position;
+	peak.height = candidate.height;
+	peak.prominence = candidate.height - qMax(candidate.leftBase, rightBase);
+	if (peak.prominence < this->minProminence) {
+		return;
+	}
+
+	//keep only the maxPeaks highest peaks
+	if (this->peaks.size() < this->maxPeaks) {
+		this->peaks.append(peak);
+		std::push_heap(this->peaks.begin(), this->peaks.end(), isHigher);
+	} else if (peak.height > this->peaks.first().height) {
+		std::pop_heap(this->peaks.begin(), this->peaks.end(), isHigher);
+		this->peaks.last() = peak;
+		std::push_heap(this->peaks.begin(), this->peaks.end(), isHigher);
+	}
+}
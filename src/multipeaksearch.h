@@ -0,0 +1,54 @@
+#ifndef MULTIPEAKSEARCH_H
+#define MULTIPEAKSEARCH_H
+
+#include <QtGlobal>
+#include <QVector>
+
+#define DEFAULT_MAX_PEAKS 5
+#define MAX_PEAKS 32
+#define DEFAULT_MIN_PEAK_DISTANCE 10
+
+
+struct DetectedPeak {
+	int position;
+	qreal height;
+	qreal prominence;
+};
+
+
+//Finds the strongest local maxima of a line in a single pass. Prominence is the height of a peak above the higher of the
+//two lowest points between the peak and the next higher peak (or the border of the line) on each side. Local maxima are
+//kept on a stack of decreasing height, so the nearest higher peak to the left is the one below on the stack and a peak is
+//finished as soon as a higher peak to its right is found or the end of the line is reached. A peak is discarded if a higher
+//local maximum lies closer than minDistance, even if that maximum is not reported itself. Finished peaks above threshold
+//and minProminence are collected in a min-heap of at most maxPeaks entries. Flat peaks are located at the center of the
+//plateau, a peak of equal height to the right counts as higher one.
+class MultiPeakSearch
+{
+public:
+	MultiPeakSearch();
+
+	int findPeaks(const qreal* line, int length, qreal threshold, int maxPeaks, int minDistance, qreal minProminence);
+	const QVector<DetectedPeak>& getPeaks() const {return this->peaks;}
+
+private:
+	struct Candidate {
+		int position;
+		qreal height;
+		qreal leftBase;
+		qreal gapMin;
+		bool suppressed;
+	};
+
+	QVector<Candidate> candidates;
+	QVector<DetectedPeak> peaks;
+	qreal threshold;
+	int maxPeaks;
+	int minDistance;
+	qreal minProminence;
+
+	void addCandidate(int position, qreal height, qreal valleyMin);
+	void finishCandidate(const Candidate& candidate, qreal rightBase);
+};
+
+#endif //MULTIPEAKSEARCH_H
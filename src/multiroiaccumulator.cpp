@@ -0,0 +1,103 @@
+#include "multiroiaccumulator.h"
+#include "columnaccumulator.h"
+#include <algorithm>
+
+
+MultiRoiAccumulator::MultiRoiAccumulator()
+{
+
+}
+
+void MultiRoiAccumulator::accumulate(const void* data, unsigned int bitDepth, size_t stride, const QVector<QRect>& rois) {
+	this->accumulate(data, bitDepth, stride, rois, CpuFeatures::getKernel());
+}
+
+void MultiRoiAccumulator::accumulate(const void* data, unsigned int bitDepth, size_t stride, const QVector<QRect>& rois, SIMD_KERNEL kernel) {
+	//column sums of all rois are stored one after another in a single buffer that is reused for every frame
+	this->rois = rois;
+	this->offsets.resize(rois.size());
+	this->borders.clear();
+	int totalWidth = 0;
+	int left = 0;
+	int right = 0;
+	for (int i = 0; i < rois.size(); ++i) {
+		const QRect& roi = rois.at(i);
+		this->offsets[i] = totalWidth;
+		if (roi.width() <= 0 || roi.height() <= 0) {
+			continue;
+		}
+		if (this->borders.isEmpty()) {
+			left = roi.x();
+			right = roi.x() + roi.width();
+		}
+		left = qMin(left, roi.x());
+		right = qMax(right, roi.x() + roi.width());
+		totalWidth += roi.width();
+		this->borders.append(roi.y());
+		this->borders.append(roi.y() + roi.height());
+	}
+	if (this->columnSums.size() < totalWidth) {
+		this->columnSums.resize(totalWidth);
+	}
+	std::fill(this->columnSums.begin(), this->columnSums.begin() + totalWidth, 0);
+	if (this->borders.isEmpty()) {
+		return;
+	}
+	if (this->bandSums.size() < right - left) {
+		this->bandSums.resize(right - left);
+	}
+	std::sort(this->borders.begin(), this->borders.end());
+	this->borders.erase(std::unique(this->borders.begin(), this->borders.end()), this->borders.end());
+
+	for (int b = 0; b + 1 < this->borders.size(); ++b) {
+		int bandTop = this->borders.at(b);
+		int bandHeight = this->borders.at(b+1) - bandTop;
+		this->bandRois.clear();
+		for (int i = 0; i < rois.size(); ++i) {
+			const QRect& roi = rois.at(i);
+			if (roi.width() > 0 && roi.y() <= bandTop && roi.y() + roi.height() > bandTop) {
+				this->bandRois.append(i);
+			}
+		}
+		if (this->bandRois.isEmpty()) {
+			continue;
+		}
+
+		//every column range is reduced with the vectorized accumulator, the band sums are kept at their position relative to the left border of all rois
+		this->mergeSpans(bandTop, bandHeight);
+		for (const QRect& span : this->spans) {
+			ColumnAccumulator::accumulate(data, bitDepth, stride, span, this->bandSums.data() + (span.x() - left), kernel);
+		}
+		for (int i : this->bandRois) {
+			const QRect& roi = rois.at(i);
+			const quint64* band = this->bandSums.constData() + (roi.x() - left);
+			quint64* sums = this->columnSums.data() + this->offsets.at(i);
+			for (int x = 0; x < roi.width(); ++x) {
+				sums[x] += band[x];
+			}
+		}
+	}
+}
+
+void MultiRoiAccumulator::mergeSpans(int bandTop, int bandHeight) {
+	//column ranges of the rois in the band, sorted by their left border and joined where they overlap or touch
+	this->spans.clear();
+	for (int i : this->bandRois) {
+		const QRect& roi = this->rois.at(i);
+		this->spans.append(QRect(roi.x(), bandTop, roi.width(), bandHeight));
+	}
+	std::sort(this->spans.begin(), this->spans.end(), [](const QRect& a, const QRect& b) {
+		return a.x() < b.x();
+	});
+	int merged = 0;
+	for (int i = 1; i < this->spans.size(); ++i) {
+		QRect& last = this->spans[merged];
+		const QRect& span = this->spans.at(i);
+		if (span.x() <= last.x() + last.width()) {
+			last.setWidth(qMax(last.width(), span.x() + span.width() - last.x()));
+		} else {
+			this->spans[++merged] = span;
+		}
+	}
+	this->spans.resize(merged + 1);
+}
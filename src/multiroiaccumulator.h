@@ -0,0 +1,38 @@
+#ifndef MULTIROIACCUMULATOR_H
+#define MULTIROIACCUMULATOR_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QRect>
+#include "cpufeatures.h"
+
+
+//Column sums of several ROIs of the same frame, calculated in a single sweep from the top to the bottom of the frame.
+//The rows are split into bands at every roi border, so the set of rois covering a band does not change within it.
+//Every band is reduced once over the merged column ranges of its rois into a shared line of band sums, which is then
+//added to the column sums of each of these rois. Samples of overlapping rois are therefore read only once. The rois
+//are given relative to data and consecutive lines are stride samples apart, like for ColumnAccumulator.
+class MultiRoiAccumulator
+{
+public:
+	MultiRoiAccumulator();
+
+	void accumulate(const void* data, unsigned int bitDepth, size_t stride, const QVector<QRect>& rois);
+	void accumulate(const void* data, unsigned int bitDepth, size_t stride, const QVector<QRect>& rois, SIMD_KERNEL kernel);
+	int getRoiCount() const {return this->rois.size();}
+	QRect getRoi(int index) const {return this->rois.at(index);}
+	const quint64* getColumnSums(int index) const {return this->columnSums.constData() + this->offsets.at(index);}
+
+private:
+	QVector<QRect> rois;
+	QVector<int> offsets;
+	QVector<quint64> columnSums;
+	QVector<quint64> bandSums;
+	QVector<int> borders;
+	QVector<int> bandRois;
+	QVector<QRect> spans;
+
+	void mergeSpans(int bandTop, int bandHeight);
+};
+
+#endif //MULTIROIACCUMULATOR_H
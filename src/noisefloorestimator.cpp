@@ -0,0 +1,42 @@
+#include "noisefloorestimator.h"
+#include <algorithm>
+
+
+NoiseFloorEstimator::NoiseFloorEstimator()
+	: median(0.0),
+	mad(0.0)
+{
+
+}
+
+double NoiseFloorEstimator::estimate(const qreal* line, int length, double noiseFactor) {
+	if (line == nullptr || length <= 0) {
+		this->median = 0.0;
+		this->mad = 0.0;
+		return 0.0;
+	}
+	if (this->values.size() < length) {
+		this->values.resize(length);
+	}
+	qreal* values = this->values.data();
+	std::copy(line, line + length, values);
+	this->median = selectMedian(values, length);
+
+	//the deviations overwrite the copy, its order after the selection does not matter
+	for (int i = 0; i < length; ++i) {
+		values[i] = qAbs(values[i] - this->median);
+	}
+	this->mad = selectMedian(values, length);
+	return this->median + noiseFactor*this->mad;
+}
+
+double NoiseFloorEstimator::selectMedian(qreal* values, int length) {
+	//for an even length the upper middle value is the smallest value right of the lower one after the selection
+	int middle = (length-1)/2;
+	std::nth_element(values, values + middle, values + length);
+	if (length % 2 != 0) {
+		return values[middle];
+	}
+	qreal upper = *std::min_element(values + middle + 1, values + length);
+	return 0.5*(values[middle] + upper);
+}
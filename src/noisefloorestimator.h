@@ -0,0 +1,32 @@
+#ifndef NOISEFLOORESTIMATOR_H
+#define NOISEFLOORESTIMATOR_H
+
+#include <QtGlobal>
+#include <QVector>
+
+#define DEFAULT_NOISE_FACTOR 6.0
+#define MAX_NOISE_FACTOR 1000.0
+
+
+//Estimates the noise floor of a line as median + k*MAD, where MAD is the median of the absolute deviations from the
+//median. Both are robust against the peak itself, so the threshold follows gain and bit depth changes without retuning.
+//The medians are selected with nth_element in a copy of the line, which takes linear time on average. The copy only
+//grows and is reused for every line.
+class NoiseFloorEstimator
+{
+public:
+	NoiseFloorEstimator();
+
+	double estimate(const qreal* line, int length, double noiseFactor);
+	double getMedian() const {return this->median;}
+	double getMad() const {return this->mad;}
+
+private:
+	QVector<qreal> values;
+	double median;
+	double mad;
+
+	static double selectMedian(qreal* values, int length);
+};
+
+#endif //NOISEFLOORESTIMATOR_H
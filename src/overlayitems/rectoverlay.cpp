@@ -4,6 +4,7 @@
 RectOverlay::RectOverlay(QGraphicsItem *parent)
 	: OverlayItem(parent),
 	penWidth(13),
+	color(255, 0, 0, 128),
 	topLeftAnchor(new AnchorPoint(this)),
 	bottomRightAnchor(new AnchorPoint(this))
 {
@@ -35,14 +36,18 @@ void RectOverlay::setRect(QRect rect) {
 	this->update();
 }
 
+void RectOverlay::setColor(QColor color) {
+	this->color = color;
+	this->update();
+}
+
 void RectOverlay::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
 	Q_UNUSED(option)
 	Q_UNUSED(widget)
 
 	//set painting properties
 	painter->setRenderHint(QPainter::Antialiasing, true);
-	QColor rectColor(255, 0, 0, 128);
-	QPen pen(rectColor, this->penWidth, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin);
+	QPen pen(this->color, this->penWidth, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin);
 	painter->setPen(pen);
 
 	//sraw the rectangle based on the anchor positions
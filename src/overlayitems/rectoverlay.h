@@ -12,6 +12,7 @@ public:
 
 	QRectF boundingRect() const override;
 	void setRect(QRect rect);
+	void setColor(QColor color);
 	void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
 
 private:
@@ -19,6 +20,7 @@ private:
 	AnchorPoint *bottomRightAnchor;
 
 	qreal penWidth;
+	QColor color;
 };
 
 #endif //RECTOVERLAY_H
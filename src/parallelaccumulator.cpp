@@ -0,0 +1,100 @@
+#include "parallelaccumulator.h"
+#include <cstring>
+
+
+ParallelAccumulator::ParallelAccumulator(int maxThreads)
+	: threadPool(new QThreadPool()),
+	maxThreads(1),
+	data(nullptr),
+	bitDepth(0),
+	stride(0),
+	bandHeight(0),
+	bandCount(0)
+{
+	//worker threads are kept alive, so they do not have to be created again for every frame
+	this->threadPool->setExpiryTimeout(-1);
+	this->setMaxThreadCount(maxThreads);
+}
+
+ParallelAccumulator::~ParallelAccumulator() {
+	this->threadPool->waitForDone();
+	delete this->threadPool;
+}
+
+void ParallelAccumulator::setMaxThreadCount(int maxThreads) {
+	this->maxThreads = qMax(1, maxThreads);
+	this->threadPool->setMaxThreadCount(qMax(1, this->maxThreads-1));
+	this->partialSums.resize(this->maxThreads);
+	this->bandSums.resize(this->maxThreads);
+}
+
+int ParallelAccumulator::calculateBandHeight(int roiWidth, unsigned int bitDepth) {
+	size_t bytesPerRow = static_cast<size_t>(qMax(1, roiWidth))*((bitDepth+7)/8);
+	return qMax(1, static_cast<int>(PARALLEL_BAND_BYTES/bytesPerRow));
+}
+
+int ParallelAccumulator::calculateThreadCount(const QRect& roi, unsigned int bitDepth, int maxThreads) {
+	size_t roiBytes = static_cast<size_t>(qMax(0, roi.width()))*qMax(0, roi.height())*((bitDepth+7)/8);
+	if (roiBytes < PARALLEL_MIN_BYTES) {
+		return 1;
+	}
+	int bands = (roi.height() + calculateBandHeight(roi.width(), bitDepth) - 1)/calculateBandHeight(roi.width(), bitDepth);
+	return qBound(1, bands, maxThreads);
+}
+
+int ParallelAccumulator::accumulate(const void* data, unsigned int bitDepth, size_t stride, const QRect& roi, quint64* columnSums) {
+	int threads = calculateThreadCount(roi, bitDepth, this->maxThreads);
+	if (threads <= 1) {
+		ColumnAccumulator::accumulate(data, bitDepth, stride, roi, columnSums);
+		return 1;
+	}
+
+	this->data = data;
+	this->bitDepth = bitDepth;
+	this->stride = stride;
+	this->roi = roi;
+	this->bandHeight = calculateBandHeight(roi.width(), bitDepth);
+	this->bandCount = (roi.height() + this->bandHeight - 1)/this->bandHeight;
+	this->nextBand.storeRelease(0);
+	for (int i = 0; i < threads; i++) {
+		if (this->partialSums[i].size() < roi.width()) {
+			this->partialSums[i].resize(roi.width());
+			this->bandSums[i].resize(roi.width());
+		}
+		memset(this->partialSums[i].data(), 0, static_cast<size_t>(roi.width())*sizeof(quint64));
+	}
+
+	//calling thread works on bands as well instead of just waiting for the workers
+	for (int i = 1; i < threads; i++) {
+		this->threadPool->start(new BandReducer(this, i));
+	}
+	this->reduceBands(0);
+	this->finishedThreads.acquire(threads-1);
+
+	//merge partial sums of all threads
+	memcpy(columnSums, this->partialSums[0].constData(), static_cast<size_t>(roi.width())*sizeof(quint64));
+	for (int i = 1; i < threads; i++) {
+		const quint64* partial = this->partialSums[i].constData();
+		for (int x = 0; x < roi.width(); x++) {
+			columnSums[x] += partial[x];
+		}
+	}
+	return threads;
+}
+
+void ParallelAccumulator::reduceBands(int threadIndex) {
+	quint64* partial = this->partialSums[threadIndex].data();
+	quint64* band = this->bandSums[threadIndex].data();
+	int roiWidth = this->roi.width();
+	int endY = this->roi.y() + this->roi.height();
+
+	//bands are handed out dynamically, so threads that are delayed by the os do not hold up the others
+	for (int bandIndex = this->nextBand.fetchAndAddOrdered(1); bandIndex < this->bandCount; bandIndex = this->nextBand.fetchAndAddOrdered(1)) {
+		int bandY = this->roi.y() + bandIndex*this->bandHeight;
+		QRect bandRoi(this->roi.x(), bandY, roiWidth, qMin(this->bandHeight, endY-bandY));
+		ColumnAccumulator::accumulate(this->data, this->bitDepth, this->stride, bandRoi, band);
+		for (int x = 0; x < roiWidth; x++) {
+			partial[x] += band[x];
+		}
+	}
+}
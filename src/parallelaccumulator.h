@@ -0,0 +1,62 @@
+#ifndef PARALLELACCUMULATOR_H
+#define PARALLELACCUMULATOR_H
+
+#include <QtGlobal>
+#include <QRect>
+#include <QVector>
+#include <QThread>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QAtomicInt>
+#include "columnaccumulator.h"
+
+//rows of a band are chosen so that a band fits into the l2 cache of a core
+#define PARALLEL_BAND_BYTES 262144
+//rois below this size are reduced on the calling thread, the overhead of waking up workers would outweigh the gain
+#define PARALLEL_MIN_BYTES 1048576
+
+
+//Sums up ROI columns like ColumnAccumulator, but splits the ROI rows into bands that are reduced in parallel. Every
+//thread (including the calling one) picks the next unprocessed band, adds it to its own column partial sums and the
+//partial sums of all threads are merged at the end. Small ROIs are reduced single-threaded.
+class ParallelAccumulator
+{
+public:
+	explicit ParallelAccumulator(int maxThreads = QThread::idealThreadCount());
+	~ParallelAccumulator();
+
+	void setMaxThreadCount(int maxThreads);
+	int getMaxThreadCount() const {return this->maxThreads;}
+	int accumulate(const void* data, unsigned int bitDepth, size_t stride, const QRect& roi, quint64* columnSums);
+	static int calculateBandHeight(int roiWidth, unsigned int bitDepth);
+	static int calculateThreadCount(const QRect& roi, unsigned int bitDepth, int maxThreads);
+
+private:
+	class BandReducer : public QRunnable
+	{
+	public:
+		BandReducer(ParallelAccumulator* accumulator, int threadIndex) : accumulator(accumulator), threadIndex(threadIndex) {}
+		void run() override {this->accumulator->reduceBands(this->threadIndex); this->accumulator->finishedThreads.release();}
+	private:
+		ParallelAccumulator* accumulator;
+		int threadIndex;
+	};
+
+	QThreadPool* threadPool;
+	int maxThreads;
+	QVector<QVector<quint64>> partialSums;
+	QVector<QVector<quint64>> bandSums;
+	QAtomicInt nextBand;
+	QSemaphore finishedThreads;
+
+	const void* data;
+	unsigned int bitDepth;
+	size_t stride;
+	QRect roi;
+	int bandHeight;
+	int bandCount;
+
+	void reduceBands(int threadIndex);
+};
+
+#endif //PARALLELACCUMULATOR_H
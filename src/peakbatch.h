@@ -0,0 +1,36 @@
+#ifndef PEAKBATCH_H
+#define PEAKBATCH_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QMetaType>
+
+#define PEAK_FLAG_FOUND 0x01
+#define PEAK_FLAG_TRACKED 0x02
+#define PEAK_FLAG_ROI_EMPTY 0x04
+
+
+//Peaks of all frames of a batch as struct of arrays with one entry per frame, so a whole buffer can be handed on in a
+//single signal instead of one signal per frame. Positions are -1 for frames without peak, the flags combine the
+//PEAK_FLAG_ values. The arrays keep their memory if the batch gets smaller. A received batch shares its arrays with the
+//peak finder, which reuses them a few batches later. A receiver that retains batches for longer forces a reallocation
+//for every buffer and should copy the values it needs instead of the batch.
+struct PeakBatch {
+	qint64 timestampNs;
+	int bufferNr;
+	int firstFrameNr;
+	int frameCount;
+	QVector<double> positions;
+	QVector<double> amplitudes;
+	QVector<quint8> flags;
+
+	void resize(int frames) {
+		this->frameCount = frames;
+		this->positions.resize(frames);
+		this->amplitudes.resize(frames);
+		this->flags.resize(frames);
+	}
+};
+Q_DECLARE_METATYPE(PeakBatch)
+
+#endif //PEAKBATCH_H
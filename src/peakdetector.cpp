@@ -1,31 +1,50 @@
 #include "peakdetector.h"
+#include "columnaccumulator.h"
 
 
 PeakDetector::PeakDetector()
 	: Extension(),
-	lostBuffersProcessed(0),
 	form(new PeakDetectorForm()),
 	peakFinder(new PeakFinder()),
-	bufferCounter(0),
-	copyBufferId(-1),
-	bytesPerFrameProcessed(0),
-	bytesPerFrameRaw(0),
-	isCalculating(false),
+	frameRing(new FrameRingBuffer()),
+	frameRingDepth(DEFAULT_FRAME_RING_DEPTH),
+	fullRateEnabled(false),
+	fusedIngestEnabled(true),
+	roiOnlyExtractionEnabled(false),
+	surfaceTrackingEnabled(false),
+	columnSumsSufficient(true),
+	displayVisible(false),
+	queuedSlots(0),
+	scheduler(new DecimationScheduler()),
+	latencyMonitor(new LatencyMonitor()),
+	decimationReportTimestampNs(0),
+	frameKeptTimestampNs(-1),
+	acceptedBuffers(0),
+	framesPerBuffer(0),
+	buffersPerVolume(0),
 	active(false),
 	bufferNr(0),
-	nthBuffer(10),
 	frameNr(0)
 {
 	qRegisterMetaType<PeakDetectorParameters>("PeakDetectorParameters");
+	qRegisterMetaType<FrameSlot*>("FrameSlot*");
+	qRegisterMetaType<FrameView>("FrameView");
+	qRegisterMetaType<QVector<QPointF>>("QVector<QPointF>");
+	qRegisterMetaType<SurfaceProfile>("SurfaceProfile");
+	qRegisterMetaType<QVector<RoiPeak>>("QVector<RoiPeak>");
+	qRegisterMetaType<PeakResult>("PeakResult");
+	qRegisterMetaType<PeakBatch>("PeakBatch");
 
 	this->setType(EXTENSION);
 	this->displayStyle = SEPARATE_WINDOW;
 	this->name = "Peak Detector";
 	this->toolTip = "Finds the peak within a ROI in a B-scan";
 
+	//select vector kernels once, before any data is processed
+	CpuFeatures::initialize();
+
 	this->setupGuiConnections();
 	this->setupPeakFinder();
-	this->initializeFrameBuffers();
 }
 
 PeakDetector::~PeakDetector() {
@@ -34,8 +53,10 @@ PeakDetector::~PeakDetector() {
 
 	delete this->form;
 
-	this->releaseFrameBuffers(this->frameBuffersProcessed);
-	this->releaseFrameBuffers(this->frameBuffersRaw);
+	//consumer threads are stopped at this point, so no slot is accessed anymore
+	delete this->frameRing;
+	delete this->scheduler;
+	delete this->latencyMonitor;
 }
 
 QWidget* PeakDetector::getWidget() {
@@ -45,6 +66,7 @@ QWidget* PeakDetector::getWidget() {
 void PeakDetector::activateExtension() {
 	//this method is called by OCTproZ as soon as user activates the extension. If the extension controls hardware components, they can be prepared, activated, initialized or started here.
 	this->active = true;
+	emit info(this->name + ": " + tr("Using %1 kernels").arg(CpuFeatures::getKernelName(CpuFeatures::getKernel())));
 }
 
 void PeakDetector::deactivateExtension() {
@@ -62,13 +84,20 @@ void PeakDetector::setupGuiConnections() {
 	connect(this->form, &PeakDetectorForm::error, this, &PeakDetector::error);
 	connect(this, &PeakDetector::maxBuffers, this->form, &PeakDetectorForm::setMaximumBufferNr);
 	connect(this, &PeakDetector::maxFrames, this->form, &PeakDetectorForm::setMaximumFrameNr);
+	this->form->setLatencyMonitor(this->latencyMonitor);
 
 	//store settings
 	connect(this->form, &PeakDetectorForm::paramsChanged, this, &PeakDetector::storeParameters);
 
 	//image display connections
 	ImageDisplay* imageDisplay = this->form->getImageDisplay();
-	connect(this, &PeakDetector::newFrame, imageDisplay, &ImageDisplay::receiveFrame);
+	connect(this, &PeakDetector::newFrameView, imageDisplay, &ImageDisplay::receiveFrameView);
+	connect(imageDisplay, &ImageDisplay::frameReleased, this, [this](void* frame) {
+		this->frameRing->release(frame);
+	}, Qt::DirectConnection);
+	connect(imageDisplay, &ImageDisplay::visibilityChanged, this, [this](bool visible) {
+		this->displayVisible.storeRelease(visible);
+	});
 	connect(imageDisplay, &ImageDisplay::roiChanged, this, [this](const QRect& rect) {
 		QString rectString = QString("ROI: %1, %2, %3, %4").arg(rect.x()).arg(rect.y()).arg(rect.width()).arg(rect.height());
 		emit this->info(rectString);
@@ -84,42 +113,72 @@ void PeakDetector::setupGuiConnections() {
 	connect(this->form, &PeakDetectorForm::bufferSourceChanged, this, [this](BUFFER_SOURCE source) {
 		this->bufferSource = source;
 	});
+	connect(this->form, &PeakDetectorForm::frameRingDepthChanged, this, [this](int depth) {
+		this->frameRingDepth.storeRelease(depth);
+	});
+	connect(this->form, &PeakDetectorForm::fullRateEnabledChanged, this, [this](bool enabled) {
+		this->fullRateEnabled.storeRelease(enabled);
+	});
+	connect(this->form, &PeakDetectorForm::fusedIngestEnabledChanged, this, [this](bool enabled) {
+		this->fusedIngestEnabled.storeRelease(enabled);
+	});
+	connect(this->form, &PeakDetectorForm::roiOnlyExtractionEnabledChanged, this, [this](bool enabled) {
+		this->roiOnlyExtractionEnabled.storeRelease(enabled);
+	});
+	connect(this->form, &PeakDetectorForm::surfaceTrackingEnabledChanged, this, [this](bool enabled) {
+		this->surfaceTrackingEnabled.storeRelease(enabled);
+	});
+	connect(this->form, &PeakDetectorForm::paramsChanged, this, [this](PeakDetectorParameters params) {
+		//column sums of the fused ingest only give the mean of the main roi rows and no integral table of the whole frame
+		this->columnSumsSufficient.storeRelease(params.rowAggregation == AGGREGATION_MEAN && !params.integralTableEnabled && params.additionalRois.isEmpty());
+
+		//roi is needed in the producer thread to reduce the frame while copying it, roi-only extraction has to keep all rois
+		QRect bounds = params.roi.normalized();
+		for (const NamedRoi& namedRoi : params.additionalRois) {
+			bounds = bounds.united(namedRoi.rect.normalized());
+		}
+		QMutexLocker locker(&this->roiMutex);
+		this->roi = params.roi;
+		this->roiBounds = bounds;
+	});
+	connect(this->form, &PeakDetectorForm::decimationTargetChanged, this, [this](DECIMATION_TARGET target, double value) {
+		this->scheduler->setTarget(target, value);
+	});
+	connect(this, &PeakDetector::decimationUpdated, this->form, &PeakDetectorForm::displayDecimation);
 }
 
 void PeakDetector::setupPeakFinder() {
 	this->peakFinder = new PeakFinder();
+	this->peakFinder->setLatencyMonitor(this->latencyMonitor);
 	this->peakFinder->moveToThread(&peakFinderThread);
 	ImageDisplay* imageDisplay = this->form->getImageDisplay();
-	connect(this, &PeakDetector::newFrame, this->peakFinder, &PeakFinder::findPeak);
+	connect(this, &PeakDetector::newFrameSlot, this->peakFinder, &PeakFinder::processFrameSlot);
+	connect(this->peakFinder, &PeakFinder::frameSlotReleased, this, [this](FrameSlot* slot) {
+		this->frameRing->release(slot);
+	}, Qt::DirectConnection);
+	connect(this, &PeakDetector::lastFrameReleaseRequested, this->peakFinder, &PeakFinder::releaseLastFrame);
 	connect(imageDisplay, &ImageDisplay::roiChanged, this->peakFinder, &PeakFinder::setRoi);
 	connect(this->form, &PeakDetectorForm::paramsChanged, this->peakFinder, &PeakFinder::setParams);
 	connect(this->peakFinder, &PeakFinder::info, this, &PeakDetector::info);
 	connect(this->peakFinder, &PeakFinder::error, this, &PeakDetector::error);
 	connect(&peakFinderThread, &QThread::finished, this->peakFinder, &QObject::deleteLater);
 	connect(this->peakFinder, &PeakFinder::averagedLineCalculated, this->form, &PeakDetectorForm::plotLine);
-	connect(this->peakFinder, &PeakFinder::peakPositionFound, this->form, &PeakDetectorForm::plotPeakPositionIndicator);
-	connect(this->peakFinder, &PeakFinder::peakPositionFound, this->form, &PeakDetectorForm::displayPeakPositionValue);
+	connect(this->peakFinder, &PeakFinder::peakResultFound, this->form, &PeakDetectorForm::displayPeakResult);
+	connect(this->peakFinder, &PeakFinder::peakResultFound, this, &PeakDetector::peakResultFound);
+	connect(this->peakFinder, &PeakFinder::peakBatchFound, this, &PeakDetector::peakBatchFound);
+	connect(this->peakFinder, &PeakFinder::thresholdEstimated, this->form, &PeakDetectorForm::displayEstimatedThreshold);
+	connect(this->peakFinder, &PeakFinder::peaksFound, this->form, &PeakDetectorForm::plotPeakMarkers);
+	connect(this->peakFinder, &PeakFinder::surfaceProfileFound, this->form, &PeakDetectorForm::displaySurfaceProfile);
+	connect(this->peakFinder, &PeakFinder::roiPeaksFound, this->form, &PeakDetectorForm::displayRoiPeaks);
+	connect(this->peakFinder, &PeakFinder::peakTracked, this->form, &PeakDetectorForm::displayTrackingState);
+	connect(this->peakFinder, &PeakFinder::frameRateMeasured, this->form, &PeakDetectorForm::displayFrameRate);
+	connect(this->peakFinder, &PeakFinder::processingTimeMeasured, this, [this](unsigned int frames, qint64 nsecs) {
+		this->queuedSlots.fetchAndAddOrdered(-1);
+		this->scheduler->reportProcessingTime(frames, nsecs);
+	}, Qt::DirectConnection);
 	peakFinderThread.start();
 }
 
-void PeakDetector::initializeFrameBuffers() {
-	this->frameBuffersRaw.resize(NUMBER_OF_BUFFERS);
-	this->frameBuffersProcessed.resize(NUMBER_OF_BUFFERS);
-	for(int i = 0; i < NUMBER_OF_BUFFERS; i++){
-		this->frameBuffersRaw[i] = nullptr;
-		this->frameBuffersProcessed[i] = nullptr;
-	}
-}
-
-void PeakDetector::releaseFrameBuffers(QVector<void *> buffers) {
-	for (int i = 0; i < buffers.size(); i++) {
-		if (buffers[i] != nullptr) {
-			free(buffers[i]);
-			buffers[i] = nullptr;
-		}
-	}
-}
-
 void PeakDetector::storeParameters() {
 	//update settingsMap, so parameters can be reloaded into gui at next start of application
 	this->form->getSettings(&this->settingsMap);
@@ -137,22 +196,30 @@ void PeakDetector::rawDataReceived(void* buffer, unsigned bitDepth, unsigned int
 }
 
 void PeakDetector::processedDataReceived(void* buffer, unsigned int bitDepth, unsigned int samplesPerLine, unsigned int linesPerFrame, unsigned int framesPerBuffer, unsigned int buffersPerVolume, unsigned int currentBufferNr) {
+	TRACE_SCOPE("PeakDetector::processedDataReceived");
 	if(this->active){
-		if(!this->isCalculating && this->processedGrabbingAllowed){
+		if(this->processedGrabbingAllowed){
+			//arrival of the buffer is the start of the latency measurement of the peak that is found in it
+			qint64 timestampNs = this->latencyMonitor->now();
+
 			//check if current buffer is selected. If it is not selected discard it and do nothing (just return).
 			if(this->bufferNr>static_cast<int>(buffersPerVolume-1)){this->bufferNr = static_cast<int>(buffersPerVolume-1);}
 			if(!(this->bufferNr == -1 || this->bufferNr == static_cast<int>(currentBufferNr))){
 				return;
 			}
 
-			//check if this is the nthBuffer
-			this->bufferCounter++;
-			if(this->bufferCounter < this->nthBuffer){
+			//in full rate mode every frame of an accepted buffer is analyzed, otherwise only the selected frame
+			bool fullRate = this->fullRateEnabled.loadAcquire();
+			unsigned int framesPerSlot = fullRate ? framesPerBuffer : 1;
+
+			//let scheduler decide whether this buffer is analyzed, based on measured processing cost and queue depth. Slots that
+			//are only held by the image display do not delay the analysis, so just the ones queued for the peak finder count
+			bool accepted = this->scheduler->acceptBuffer(timestampNs, framesPerSlot, this->queuedSlots.loadAcquire());
+			this->reportDecimation(timestampNs);
+			if(!accepted){
 				return;
 			}
-			this->bufferCounter = 0;
-
-			this->isCalculating = true;
+			this->acceptedBuffers++;
 
 			//calculate size of single frame
 			size_t bytesPerSample = static_cast<size_t>(ceil(static_cast<double>(bitDepth)/8.0));
@@ -169,38 +236,155 @@ void PeakDetector::processedDataReceived(void* buffer, unsigned int bitDepth, un
 				this->buffersPerVolume = buffersPerVolume;
 			}
 
-			//check if buffer size changed and allocate buffer memory
-			if(this->frameBuffersProcessed[0] == nullptr || this->bytesPerFrameProcessed != bytesPerFrame){
+			//with fused ingest the ROI is reduced to column sums while reading the buffer and the frame is only copied for the image display,
+			//the surface profile or, at a limited rate, for the reanalysis after a roi or parameter change
+			bool fusedIngest = this->fusedIngestEnabled.loadAcquire() && this->columnSumsSufficient.loadAcquire();
+			bool displayFrame = this->displayVisible.loadAcquire();
+			bool reanalysisFrameDue = this->frameKeptTimestampNs < 0 || timestampNs - this->frameKeptTimestampNs >= static_cast<qint64>(REANALYSIS_FRAME_INTERVAL_MS)*1000000;
+			bool copyFrame = displayFrame || this->surfaceTrackingEnabled.loadAcquire() || reanalysisFrameDue;
+			QRect currentRoi;
+			QRect currentRoiBounds;
+			{
+				QMutexLocker locker(&this->roiMutex);
+				currentRoi = this->roi;
+				currentRoiBounds = this->roiBounds;
+			}
+			QRect clampedRoi = PeakFinder::clampRoi(currentRoi, samplesPerLine, linesPerFrame);
+			QRect clampedRoiBounds = PeakFinder::clampRoi(currentRoiBounds, samplesPerLine, linesPerFrame);
+
+			//with roi-only extraction just the bounding rectangle of all clamped rois of every frame is copied into a compact buffer
+			QRect region(0, 0, static_cast<int>(samplesPerLine), static_cast<int>(linesPerFrame));
+			if(this->roiOnlyExtractionEnabled.loadAcquire() && clampedRoiBounds.width() > 0 && clampedRoiBounds.height() > 0){
+				region = clampedRoiBounds;
+			}
+			size_t bytesPerRegion = static_cast<size_t>(region.width())*region.height()*bytesPerSample;
+			unsigned int framesToCopy = fusedIngest ? 1 : framesPerSlot;
+			size_t bytesPerSlot = qMax(bytesPerRegion*framesToCopy, bytesPerSample);
+			size_t columnSumsPerSlot = fusedIngest ? static_cast<size_t>(samplesPerLine)*framesPerSlot : 0;
+
+			//check if slot size or requested ring depth changed and (re)allocate ring slots. Slots are kept if they are only moderately larger than needed, so resizing the roi does not reallocate them all the time
+			int ringDepth = this->frameRing->getDepth();
+			size_t capacity = this->frameRing->getBytesPerSlot();
+			int requestedRingDepth = this->frameRingDepth.loadAcquire();
+			if(capacity < bytesPerSlot || capacity/4 > bytesPerSlot || this->frameRing->getColumnSumsPerSlot() != columnSumsPerSlot || ringDepth != requestedRingDepth){
 				if(bitDepth == 0 || samplesPerLine == 0 || linesPerFrame == 0 || framesPerBuffer == 0){
 					emit error(this->name + ":  " + tr("Invalid data dimensions!"));
 					return;
 				}
-				//(re)create copy buffers
-				if(this->frameBuffersProcessed[0] != nullptr){
-					this->releaseFrameBuffers(this->frameBuffersProcessed);
-				}
-				for (int i = 0; i < this->frameBuffersProcessed.size(); i++) {
-					this->frameBuffersProcessed[i] = static_cast<void*>(malloc(bytesPerFrame));
+				//slots can only be reallocated once all consumers have returned them, including the one the peak finder keeps for a reanalysis
+				if(!this->frameRing->resize(requestedRingDepth, bytesPerSlot, columnSumsPerSlot)){
+					emit lastFrameReleaseRequested();
+					this->reportLostFrames(framesPerSlot);
+					return;
 				}
-				this->bytesPerFrameProcessed = bytesPerFrame;
 			}
 
-			//copy single frame of received data and emit it for further processing
-			this->copyBufferId = (this->copyBufferId+1)%NUMBER_OF_BUFFERS;
+			//take ownership of the next free slot. If all slots are still in use by consumers the frame is dropped and the peak finder is asked to return the slot it keeps
+			FrameSlot* slot = this->frameRing->acquire();
+			if(slot == nullptr){
+				emit lastFrameReleaseRequested();
+				this->reportLostFrames(framesPerSlot);
+				return;
+			}
+
 			char* frameInBuffer = static_cast<char*>(buffer);
 			if(this->frameNr>static_cast<int>(framesPerBuffer-1)){this->frameNr = static_cast<int>(framesPerBuffer-1);}
-			memcpy(this->frameBuffersProcessed[this->copyBufferId], &(frameInBuffer[bytesPerFrame*this->frameNr]), bytesPerFrame);
-			emit newFrame(this->frameBuffersProcessed[this->copyBufferId], bitDepth, samplesPerLine, linesPerFrame);
+			char* selectedFrame = &(frameInBuffer[bytesPerFrame*this->frameNr]);
+			char* displayedFrame = slot->data;
+			if(fusedIngest){
+				//single pass over the ROI rows of every frame directly in the received buffer
+				slot->roi = clampedRoi;
+				for(unsigned int i = 0; i < framesPerSlot; i++){
+					char* frame = fullRate ? &(frameInBuffer[bytesPerFrame*i]) : selectedFrame;
+					ColumnAccumulator::accumulate(frame, bitDepth, samplesPerLine, slot->roi, slot->columnSums + static_cast<size_t>(i)*slot->roi.width());
+				}
+				if(copyFrame){
+					this->copyRegion(selectedFrame, bytesPerSample, samplesPerLine, region, slot->data);
+				}
+			}else{
+				if(fullRate){
+					for(unsigned int i = 0; i < framesPerSlot; i++){
+						this->copyRegion(&(frameInBuffer[bytesPerFrame*i]), bytesPerSample, samplesPerLine, region, &(slot->data[bytesPerRegion*i]));
+					}
+					displayedFrame = &(slot->data[bytesPerRegion*this->frameNr]);
+				}else{
+					this->copyRegion(selectedFrame, bytesPerSample, samplesPerLine, region, slot->data);
+				}
+			}
+			slot->copiedNs = this->latencyMonitor->now();
+			this->latencyMonitor->record(STAGE_COPY, timestampNs, slot->copiedNs);
+			slot->bitDepth = bitDepth;
+			slot->samplesPerLine = samplesPerLine;
+			slot->linesPerFrame = linesPerFrame;
+			slot->frameCount = framesPerSlot;
+			slot->region = region;
+			slot->stride = static_cast<size_t>(region.width());
+			slot->bytesPerFrame = bytesPerRegion;
+			slot->hasColumnSums = fusedIngest;
+			slot->hasFrameData = !fusedIngest || copyFrame;
+			slot->timestampNs = timestampNs;
+			slot->bufferNr = static_cast<int>(currentBufferNr);
+			slot->firstFrameNr = fullRate ? 0 : this->frameNr;
+			slot->dataFrameNr = fullRate && !fusedIngest ? static_cast<int>(framesPerSlot)-1 : this->frameNr;
+			if(slot->hasFrameData){
+				this->frameKeptTimestampNs = timestampNs;
+			}
 
-			this->isCalculating = false;
+			//hand slot over to peak finder and, if visible, to image display
+			this->frameRing->publish(slot, displayFrame ? 2 : 1);
+			if(displayFrame){
+				FrameView view;
+				view.data = displayedFrame;
+				view.bitDepth = bitDepth;
+				view.samplesPerLine = samplesPerLine;
+				view.linesPerFrame = linesPerFrame;
+				view.stride = slot->stride;
+				view.region = region;
+				emit newFrameView(view);
+			}
+			this->queuedSlots.fetchAndAddOrdered(1);
+			emit newFrameSlot(slot);
+
+			//a ring with a single slot would be blocked by the frame the peak finder keeps, so it copies the frame and returns the slot right away
+			if(this->frameRing->getDepth() < 2){
+				emit lastFrameReleaseRequested();
+			}
 		}
 		else{
-			this->lostBuffersProcessed++;
-			emit info(this->name + ": " + tr("Processed buffer lost. Total lost buffers: ") + QString::number(lostBuffersProcessed));
-			if(this->lostBuffersProcessed>= INT_MAX){
-				this->lostBuffersProcessed = 0;
-				emit info(this->name + ": " + tr("Lost processed buffer counter overflow. Counter set to zero."));
-			}
+			this->reportLostFrames(this->fullRateEnabled.loadAcquire() ? framesPerBuffer : 1);
 		}
 	}
 }
+
+void PeakDetector::copyRegion(const char* frame, size_t bytesPerSample, unsigned int samplesPerLine, const QRect& region, char* destination) {
+	TRACE_SCOPE("PeakDetector::copyRegion");
+	size_t bytesPerRegionLine = static_cast<size_t>(region.width())*bytesPerSample;
+	size_t bytesPerFrameLine = static_cast<size_t>(samplesPerLine)*bytesPerSample;
+	const char* source = frame + region.y()*bytesPerFrameLine + region.x()*bytesPerSample;
+
+	//full width regions are contiguous in memory and can be copied at once
+	if(bytesPerRegionLine == bytesPerFrameLine){
+		memcpy(destination, source, bytesPerRegionLine*region.height());
+		return;
+	}
+	for(int y = 0; y < region.height(); y++){
+		memcpy(destination + y*bytesPerRegionLine, source + y*bytesPerFrameLine, bytesPerRegionLine);
+	}
+}
+
+void PeakDetector::reportLostFrames(quint64 frames) {
+	quint64 lostFrames = this->frameRing->countLostFrames(frames);
+	emit info(this->name + ": " + tr("Processed frame lost. Total lost frames: ") + QString::number(lostFrames));
+}
+
+
+void PeakDetector::reportDecimation(qint64 timestampNs) {
+	//update gui about once per second with current decimation ratio and effective rate of analyzed buffers
+	qint64 elapsedNs = timestampNs - this->decimationReportTimestampNs;
+	if(elapsedNs >= 1000000000){
+		double analyzedBuffersPerSecond = static_cast<double>(this->acceptedBuffers)*1.0e9/static_cast<double>(elapsedNs);
+		emit decimationUpdated(this->scheduler->getDecimationRatio(), analyzedBuffersPerSecond, this->scheduler->isTargetReachable());
+		this->acceptedBuffers = 0;
+		this->decimationReportTimestampNs = timestampNs;
+	}
+}
@@ -4,12 +4,19 @@
 
 #include <QCoreApplication>
 #include <QThread>
+#include <QElapsedTimer>
+#include <QMutex>
 #include "octproz_devkit.h"
 #include "peakdetectorform.h"
 #include "peakfinder.h"
+#include "frameringbuffer.h"
+#include "decimationscheduler.h"
+#include "cpufeatures.h"
+#include "latencymonitor.h"
+#include "tracerecorder.h"
 
-#define NUMBER_OF_BUFFERS 2
-
+//with fused ingest a frame is copied at least this often, so a changed roi or parameter can be applied to a recent frame
+#define REANALYSIS_FRAME_INTERVAL_MS 100
 
 class PeakDetector : public Extension
 {
@@ -26,6 +33,8 @@ public:
 	virtual void activateExtension() override;
 	virtual void deactivateExtension() override;
 	virtual void settingsLoaded(QVariantMap settings) override;
+	quint64 getLostFrames() const {return this->frameRing->getLostFrames();}
+	LatencyMonitor* getLatencyMonitor() const {return this->latencyMonitor;}
 
 private:
 	PeakDetectorForm* form;
@@ -33,25 +42,33 @@ private:
 	BUFFER_SOURCE bufferSource;
 	int frameNr;
 	int bufferNr;
-	int nthBuffer;
-	int bufferCounter;
 	bool active;
-	bool isCalculating;
 
-	QVector<void*> frameBuffersRaw;
-	QVector<void*> frameBuffersProcessed;
-	int copyBufferId;
-	size_t bytesPerFrameRaw;
-	size_t bytesPerFrameProcessed;
-	int lostBuffersRaw;
-	int lostBuffersProcessed;
+	FrameRingBuffer* frameRing;
+	QAtomicInt frameRingDepth;
+	QAtomicInt fullRateEnabled;
+	QAtomicInt fusedIngestEnabled;
+	QAtomicInt roiOnlyExtractionEnabled;
+	QAtomicInt surfaceTrackingEnabled;
+	QAtomicInt columnSumsSufficient;
+	QAtomicInt displayVisible;
+	QAtomicInt queuedSlots;
+	QMutex roiMutex;
+	QRect roi;
+	QRect roiBounds;
+	DecimationScheduler* scheduler;
+	LatencyMonitor* latencyMonitor;
+	qint64 decimationReportTimestampNs;
+	qint64 frameKeptTimestampNs;
+	unsigned int acceptedBuffers;
 	unsigned int framesPerBuffer;
 	unsigned int buffersPerVolume;
 
 	void setupGuiConnections();
 	void setupPeakFinder();
-	void initializeFrameBuffers();
-	void releaseFrameBuffers(QVector<void*> buffers);
+	void reportLostFrames(quint64 frames);
+	void reportDecimation(qint64 timestampNs);
+	static void copyRegion(const char* frame, size_t bytesPerSample, unsigned int samplesPerLine, const QRect& region, char* destination);
 
 public slots:
 	void storeParameters();
@@ -59,9 +76,14 @@ public slots:
 	virtual void processedDataReceived(void* buffer, unsigned int bitDepth, unsigned int samplesPerLine, unsigned int linesPerFrame, unsigned int framesPerBuffer, unsigned int buffersPerVolume, unsigned int currentBufferNr) override;
 
 signals:
-	void newFrame(void* frame, unsigned int bitDepth, unsigned int samplesPerLine, unsigned int linesPerFrame);
+	void newFrameView(FrameView frame);
+	void newFrameSlot(FrameSlot* slot);
+	void lastFrameReleaseRequested();
 	void maxFrames(int max);
 	void maxBuffers(int max);
+	void decimationUpdated(int ratio, double analyzedBuffersPerSecond, bool targetReachable);
+	void peakResultFound(PeakResult result);
+	void peakBatchFound(PeakBatch batch);
 };
 
 #endif //PEAKDETECTOREXTENSION_H
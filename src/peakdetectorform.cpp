@@ -1,5 +1,15 @@
 #include "peakdetectorform.h"
 #include "ui_peakdetectorform.h"
+#include "peakinterpolation.h"
+#include "multipeaksearch.h"
+#include "peaktracker.h"
+#include "linefilter.h"
+#include "rowaggregator.h"
+#include "noisefloorestimator.h"
+#include "tracerecorder.h"
+#include <QFileDialog>
+#include <QFile>
+#include <QTextStream>
 
 PeakDetectorForm::PeakDetectorForm(QWidget *parent) :
 	QWidget(parent),
@@ -7,6 +17,8 @@ PeakDetectorForm::PeakDetectorForm(QWidget *parent) :
 	ui->setupUi(this);
 
 	this->firstRun = true;
+	this->estimatedThreshold = 0;
+	this->latencyMonitor = nullptr;
 
 	this->imageDisplay = this->ui->widget_imageDisplay;
 	connect(this->imageDisplay, &ImageDisplay::info, this, &PeakDetectorForm::info);
@@ -16,6 +28,10 @@ PeakDetectorForm::PeakDetectorForm(QWidget *parent) :
 		emit roiChanged(roiRect);
 		emit paramsChanged(this->parameters);
 	});
+	connect(this->imageDisplay, &ImageDisplay::additionalRoisChanged, this, [this](QVector<NamedRoi> rois) {
+		this->parameters.additionalRois = rois;
+		emit paramsChanged(this->parameters);
+	});
 
 	this->linePlot = this->ui->widget_linePlot;
 	connect(this->linePlot, &LinePlot::info, this, &PeakDetectorForm::info);
@@ -42,6 +58,72 @@ PeakDetectorForm::PeakDetectorForm(QWidget *parent) :
 	});
 	this->setMaximumFrameNr(512);	
 
+	//ComboBox feature and SpinBox centroid window
+	this->ui->comboBox_feature->addItem(tr("Maximum"), MAXVALUE);
+	this->ui->comboBox_feature->addItem(tr("Parabolic fit"), PARABOLIC_FIT);
+	this->ui->comboBox_feature->addItem(tr("Gaussian fit"), GAUSSIAN_FIT);
+	this->ui->comboBox_feature->addItem(tr("Centroid"), CENTROID);
+	connect(this->ui->comboBox_feature, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+		this->parameters.feature = static_cast<PEAK_FEATURE>(this->ui->comboBox_feature->itemData(index).toInt());
+		this->ui->spinBox_centroidHalfWidth->setEnabled(this->parameters.feature == CENTROID);
+		emit featureChanged(this->parameters.feature);
+		emit paramsChanged(this->parameters);
+	});
+	this->ui->spinBox_centroidHalfWidth->setMinimum(1);
+	this->ui->spinBox_centroidHalfWidth->setMaximum(MAX_CENTROID_HALF_WIDTH);
+	connect(this->ui->spinBox_centroidHalfWidth, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int halfWidth) {
+		this->parameters.centroidHalfWidth = halfWidth;
+		emit paramsChanged(this->parameters);
+	});
+
+	//ComboBox line filter and SpinBox filter width
+	this->ui->comboBox_lineFilter->addItem(tr("None"), FILTER_NONE);
+	this->ui->comboBox_lineFilter->addItem(tr("Moving average"), FILTER_BOXCAR);
+	this->ui->comboBox_lineFilter->addItem(tr("Savitzky-Golay"), FILTER_SAVITZKY_GOLAY);
+	this->ui->comboBox_lineFilter->addItem(tr("Gaussian"), FILTER_GAUSSIAN);
+	this->ui->spinBox_lineFilterHalfWidth->setRange(1, MAX_LINE_FILTER_HALF_WIDTH);
+	connect(this->ui->comboBox_lineFilter, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+		this->parameters.lineFilter = static_cast<LINE_FILTER>(this->ui->comboBox_lineFilter->itemData(index).toInt());
+		this->updateLineFilterInput();
+		emit paramsChanged(this->parameters);
+	});
+	connect(this->ui->spinBox_lineFilterHalfWidth, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int halfWidth) {
+		this->parameters.lineFilterHalfWidth = halfWidth;
+		emit paramsChanged(this->parameters);
+	});
+
+	//ComboBox row aggregation and DoubleSpinBox trim fraction
+	this->ui->comboBox_rowAggregation->addItem(tr("Mean"), AGGREGATION_MEAN);
+	this->ui->comboBox_rowAggregation->addItem(tr("Median"), AGGREGATION_MEDIAN);
+	this->ui->comboBox_rowAggregation->addItem(tr("Trimmed mean"), AGGREGATION_TRIMMED_MEAN);
+	this->ui->comboBox_rowAggregation->addItem(tr("Maximum"), AGGREGATION_MAX);
+	this->ui->doubleSpinBox_trimFraction->setRange(0.0, MAX_TRIM_FRACTION);
+	this->ui->doubleSpinBox_trimFraction->setSingleStep(0.05);
+	connect(this->ui->comboBox_rowAggregation, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+		this->parameters.rowAggregation = static_cast<ROW_AGGREGATION>(this->ui->comboBox_rowAggregation->itemData(index).toInt());
+		this->updateRowAggregationInput();
+		emit paramsChanged(this->parameters);
+	});
+	connect(this->ui->doubleSpinBox_trimFraction, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, [this](double fraction) {
+		this->parameters.trimFraction = fraction;
+		emit paramsChanged(this->parameters);
+	});
+
+	//LineEdit roi names, the first name belongs to the main roi and every further name adds a roi
+	connect(this->ui->lineEdit_roiNames, &QLineEdit::editingFinished, this, [this]() {
+		QStringList names;
+		for (const QString& name : this->ui->lineEdit_roiNames->text().split(',')) {
+			QString trimmedName = name.trimmed();
+			if (!trimmedName.isEmpty() && !names.contains(trimmedName)) {
+				names.append(trimmedName);
+			}
+		}
+		this->parameters.roiName = names.isEmpty() ? QString(DEFAULT_ROI_NAME) : names.takeFirst();
+		this->imageDisplay->setRoiName(this->parameters.roiName);
+		this->imageDisplay->setAdditionalRoiNames(names);
+		this->updateRoiNamesInput();
+	});
+
 	//DoubleSpinBox minimal threshold
 	this->ui->doubleSpinBox_minThreshold->setMaximum(qPow(2, 32));
 	this->ui->doubleSpinBox_minThreshold->setMinimum(0);
@@ -65,7 +147,37 @@ PeakDetectorForm::PeakDetectorForm(QWidget *parent) :
 		} else {
 			this->parameters.showMinThreshold = false;
 		}
-		this->displayMinThreshold(this->parameters.minThreshold);
+		this->updateThresholdModeInput();
+		emit paramsChanged(this->parameters);
+	});
+
+	//PushButtons of the latency statistics
+	connect(this->ui->pushButton_resetLatency, &QPushButton::clicked, this, [this]() {
+		if (this->latencyMonitor != nullptr) {
+			this->latencyMonitor->reset();
+		}
+		this->displayLatencyStatistics();
+	});
+	connect(this->ui->pushButton_exportLatency, &QPushButton::clicked, this, &PeakDetectorForm::saveLatencyStatistics);
+
+	//CheckBox and PushButton of the trace recorder
+	connect(this->ui->checkBox_trace, &QCheckBox::toggled, this, [this](bool checked) {
+		TraceRecorder::setEnabled(checked);
+	});
+	connect(this->ui->pushButton_saveTrace, &QPushButton::clicked, this, &PeakDetectorForm::saveTrace);
+
+	//ComboBox threshold mode and DoubleSpinBox noise factor of the adaptive threshold
+	this->ui->comboBox_thresholdMode->addItem(tr("Fixed"), THRESHOLD_FIXED);
+	this->ui->comboBox_thresholdMode->addItem(tr("Adaptive"), THRESHOLD_ADAPTIVE);
+	this->ui->doubleSpinBox_noiseFactor->setRange(0.0, MAX_NOISE_FACTOR);
+	this->ui->doubleSpinBox_noiseFactor->setSingleStep(0.5);
+	connect(this->ui->comboBox_thresholdMode, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+		this->parameters.thresholdMode = static_cast<THRESHOLD_MODE>(this->ui->comboBox_thresholdMode->itemData(index).toInt());
+		this->updateThresholdModeInput();
+		emit paramsChanged(this->parameters);
+	});
+	connect(this->ui->doubleSpinBox_noiseFactor, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, [this](double noiseFactor) {
+		this->parameters.noiseFactor = noiseFactor;
 		emit paramsChanged(this->parameters);
 	});
 
@@ -79,6 +191,113 @@ PeakDetectorForm::PeakDetectorForm(QWidget *parent) :
 		emit paramsChanged(this->parameters);
 	});
 
+	//multiple peaks
+	this->ui->spinBox_maxPeaks->setRange(1, MAX_PEAKS);
+	this->ui->spinBox_minPeakDistance->setRange(1, 65535);
+	this->ui->doubleSpinBox_minPeakProminence->setRange(0, qPow(2, 32));
+	connect(this->ui->checkBox_multiPeak, &QCheckBox::stateChanged, this, [this](int state) {
+		this->parameters.multiPeakEnabled = (state == Qt::Checked);
+		this->updateMultiPeakInput();
+		emit paramsChanged(this->parameters);
+	});
+	connect(this->ui->spinBox_maxPeaks, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int maxPeaks) {
+		this->parameters.maxPeaks = maxPeaks;
+		emit paramsChanged(this->parameters);
+	});
+	connect(this->ui->spinBox_minPeakDistance, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int distance) {
+		this->parameters.minPeakDistance = distance;
+		emit paramsChanged(this->parameters);
+	});
+	connect(this->ui->doubleSpinBox_minPeakProminence, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, [this](double prominence) {
+		this->parameters.minPeakProminence = prominence;
+		emit paramsChanged(this->parameters);
+	});
+
+	//tracking over frames
+	this->ui->spinBox_trackingWindow->setRange(1, 65535);
+	this->ui->doubleSpinBox_trackingAlpha->setRange(0.01, 1.0);
+	this->ui->doubleSpinBox_trackingAlpha->setSingleStep(0.05);
+	this->ui->doubleSpinBox_trackingBeta->setRange(0.0, 1.0);
+	this->ui->doubleSpinBox_trackingBeta->setSingleStep(0.05);
+	connect(this->ui->checkBox_tracking, &QCheckBox::stateChanged, this, [this](int state) {
+		this->parameters.trackingEnabled = (state == Qt::Checked);
+		this->updateTrackingInput();
+		emit paramsChanged(this->parameters);
+	});
+	connect(this->ui->spinBox_trackingWindow, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int halfWidth) {
+		this->parameters.trackingWindowHalfWidth = halfWidth;
+		emit paramsChanged(this->parameters);
+	});
+	connect(this->ui->doubleSpinBox_trackingAlpha, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, [this](double alpha) {
+		this->parameters.trackingAlpha = alpha;
+		emit paramsChanged(this->parameters);
+	});
+	connect(this->ui->doubleSpinBox_trackingBeta, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, [this](double beta) {
+		this->parameters.trackingBeta = beta;
+		emit paramsChanged(this->parameters);
+	});
+
+	//surface profile
+	connect(this->ui->checkBox_surfaceTracking, &QCheckBox::stateChanged, this, [this](int state) {
+		this->parameters.surfaceTrackingEnabled = (state == Qt::Checked);
+		this->imageDisplay->setSurfaceProfileVisible(this->parameters.surfaceTrackingEnabled);
+		if (!this->parameters.surfaceTrackingEnabled) {
+			this->ui->label_surface->setText(tr("Surface: -"));
+		}
+		emit surfaceTrackingEnabledChanged(this->parameters.surfaceTrackingEnabled);
+		emit paramsChanged(this->parameters);
+	});
+
+	//SpinBox frame ring depth
+	this->ui->spinBox_frameRingDepth->setMinimum(1);
+	this->ui->spinBox_frameRingDepth->setMaximum(MAX_FRAME_RING_DEPTH);
+	connect(this->ui->spinBox_frameRingDepth, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int depth) {
+		this->parameters.frameRingDepth = depth;
+		emit frameRingDepthChanged(depth);
+		emit paramsChanged(this->parameters);
+	});
+
+	connect(this->ui->checkBox_fullRate, &QCheckBox::stateChanged, this, [this](int state) {
+		this->parameters.fullRateEnabled = (state == Qt::Checked);
+		emit fullRateEnabledChanged(this->parameters.fullRateEnabled);
+		emit paramsChanged(this->parameters);
+	});
+
+	connect(this->ui->checkBox_fusedIngest, &QCheckBox::stateChanged, this, [this](int state) {
+		this->parameters.fusedIngestEnabled = (state == Qt::Checked);
+		emit fusedIngestEnabledChanged(this->parameters.fusedIngestEnabled);
+		emit paramsChanged(this->parameters);
+	});
+
+	connect(this->ui->checkBox_roiOnly, &QCheckBox::stateChanged, this, [this](int state) {
+		this->parameters.roiOnlyExtractionEnabled = (state == Qt::Checked);
+		emit roiOnlyExtractionEnabledChanged(this->parameters.roiOnlyExtractionEnabled);
+		emit paramsChanged(this->parameters);
+	});
+
+	connect(this->ui->checkBox_integralTable, &QCheckBox::stateChanged, this, [this](int state) {
+		this->parameters.integralTableEnabled = (state == Qt::Checked);
+		emit paramsChanged(this->parameters);
+	});
+
+	//ComboBox and DoubleSpinBox decimation target
+	this->ui->comboBox_decimationTarget->addItem(tr("Latency"), TARGET_LATENCY);
+	this->ui->comboBox_decimationTarget->addItem(tr("CPU budget"), TARGET_CPU_BUDGET);
+	connect(this->ui->comboBox_decimationTarget, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+		this->parameters.decimationTarget = static_cast<DECIMATION_TARGET>(this->ui->comboBox_decimationTarget->itemData(index).toInt());
+		this->updateDecimationTargetInput();
+		emit paramsChanged(this->parameters);
+	});
+	connect(this->ui->doubleSpinBox_decimationTarget, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, [this](double value) {
+		if(this->parameters.decimationTarget == TARGET_CPU_BUDGET){
+			this->parameters.cpuBudgetPercent = value;
+		}else{
+			this->parameters.targetLatencyMs = value;
+		}
+		emit decimationTargetChanged(this->parameters.decimationTarget, value);
+		emit paramsChanged(this->parameters);
+	});
+
 	this->installEventFilter(this);
 
 	//default values
@@ -86,42 +305,138 @@ PeakDetectorForm::PeakDetectorForm(QWidget *parent) :
 	this->parameters.bufferSource = PROCESSED;
 	this->parameters.frameNr = 0;
 	this->parameters.feature = MAXVALUE;
+	this->parameters.centroidHalfWidth = DEFAULT_CENTROID_HALF_WIDTH;
+	this->parameters.multiPeakEnabled = false;
+	this->parameters.maxPeaks = DEFAULT_MAX_PEAKS;
+	this->parameters.minPeakDistance = DEFAULT_MIN_PEAK_DISTANCE;
+	this->parameters.minPeakProminence = 0;
+	this->parameters.surfaceTrackingEnabled = false;
+	this->parameters.trackingEnabled = false;
+	this->parameters.trackingWindowHalfWidth = DEFAULT_TRACKING_WINDOW_HALF_WIDTH;
+	this->parameters.trackingAlpha = DEFAULT_TRACKING_ALPHA;
+	this->parameters.trackingBeta = DEFAULT_TRACKING_BETA;
+	this->parameters.lineFilter = FILTER_NONE;
+	this->parameters.lineFilterHalfWidth = DEFAULT_LINE_FILTER_HALF_WIDTH;
+	this->parameters.rowAggregation = AGGREGATION_MEAN;
+	this->parameters.trimFraction = DEFAULT_TRIM_FRACTION;
 	this->parameters.roi = QRect(50,50, 400, 800);
+	this->parameters.roiName = DEFAULT_ROI_NAME;
 	this->parameters.minThreshold = 0;
 	this->parameters.showMinThreshold = false;
+	this->parameters.thresholdMode = THRESHOLD_FIXED;
+	this->parameters.noiseFactor = DEFAULT_NOISE_FACTOR;
 	this->parameters.autoScalingEnabled = true;
+	this->parameters.frameRingDepth = DEFAULT_FRAME_RING_DEPTH;
+	this->parameters.fullRateEnabled = false;
+	this->parameters.fusedIngestEnabled = true;
+	this->parameters.roiOnlyExtractionEnabled = false;
+	this->parameters.integralTableEnabled = false;
+	this->parameters.decimationTarget = TARGET_LATENCY;
+	this->parameters.targetLatencyMs = 50;
+	this->parameters.cpuBudgetPercent = 25;
+	this->updateDecimationTargetInput();
+	this->updateMultiPeakInput();
+	this->updateTrackingInput();
+	this->updateLineFilterInput();
+	this->updateRowAggregationInput();
+	this->updateRoiNamesInput();
+	this->updateThresholdModeInput();
 }
 
 PeakDetectorForm::~PeakDetectorForm() {
 	delete ui;
 }
 
+void PeakDetectorForm::setLatencyMonitor(LatencyMonitor* monitor) {
+	this->latencyMonitor = monitor;
+	this->displayLatencyStatistics();
+}
+
 void PeakDetectorForm::setSettings(QVariantMap settings) {
 	// Update parameters struct
 	if (!settings.isEmpty()) {
 		this->parameters.bufferNr = settings.value(PEAKDETECTOR_BUFFER).toInt();
 		this->parameters.bufferSource = static_cast<BUFFER_SOURCE>(settings.value(PEAKDETECTOR_SOURCE).toInt());
 		this->parameters.feature = static_cast<PEAK_FEATURE>(settings.value(PEAKDETECTOR_FEATURE).toInt());
+		this->parameters.centroidHalfWidth = settings.value(PEAKDETECTOR_CENTROID_HALF_WIDTH, DEFAULT_CENTROID_HALF_WIDTH).toInt();
+		this->parameters.multiPeakEnabled = settings.value(PEAKDETECTOR_MULTI_PEAK_ENABLED, false).toBool();
+		this->parameters.maxPeaks = settings.value(PEAKDETECTOR_MAX_PEAKS, DEFAULT_MAX_PEAKS).toInt();
+		this->parameters.minPeakDistance = settings.value(PEAKDETECTOR_MIN_PEAK_DISTANCE, DEFAULT_MIN_PEAK_DISTANCE).toInt();
+		this->parameters.minPeakProminence = settings.value(PEAKDETECTOR_MIN_PEAK_PROMINENCE, 0).toDouble();
+		this->parameters.surfaceTrackingEnabled = settings.value(PEAKDETECTOR_SURFACE_TRACKING_ENABLED, false).toBool();
+		this->parameters.trackingEnabled = settings.value(PEAKDETECTOR_TRACKING_ENABLED, false).toBool();
+		this->parameters.trackingWindowHalfWidth = settings.value(PEAKDETECTOR_TRACKING_WINDOW, DEFAULT_TRACKING_WINDOW_HALF_WIDTH).toInt();
+		this->parameters.trackingAlpha = settings.value(PEAKDETECTOR_TRACKING_ALPHA, DEFAULT_TRACKING_ALPHA).toDouble();
+		this->parameters.trackingBeta = settings.value(PEAKDETECTOR_TRACKING_BETA, DEFAULT_TRACKING_BETA).toDouble();
+		this->parameters.lineFilter = static_cast<LINE_FILTER>(settings.value(PEAKDETECTOR_LINE_FILTER, FILTER_NONE).toInt());
+		this->parameters.lineFilterHalfWidth = settings.value(PEAKDETECTOR_LINE_FILTER_HALF_WIDTH, DEFAULT_LINE_FILTER_HALF_WIDTH).toInt();
+		this->parameters.rowAggregation = static_cast<ROW_AGGREGATION>(settings.value(PEAKDETECTOR_ROW_AGGREGATION, AGGREGATION_MEAN).toInt());
+		this->parameters.trimFraction = settings.value(PEAKDETECTOR_TRIM_FRACTION, DEFAULT_TRIM_FRACTION).toDouble();
 		this->parameters.frameNr = settings.value(PEAKDETECTOR_FRAME).toInt();
 		int roiX = settings.value(PEAKDETECTOR_ROI_X).toInt();
 		int roiY = settings.value(PEAKDETECTOR_ROI_Y).toInt();
 		int roiWidth = settings.value(PEAKDETECTOR_ROI_WIDTH).toInt();
 		int roiHeight = settings.value(PEAKDETECTOR_ROI_HEIGHT).toInt();
 		this->parameters.roi = QRect(roiX, roiY, roiWidth, roiHeight);
+		this->parameters.roiName = settings.value(PEAKDETECTOR_ROI_NAME, DEFAULT_ROI_NAME).toString();
+		this->imageDisplay->loadAdditionalRois(settings.value(PEAKDETECTOR_ADDITIONAL_ROIS).toList());
+		this->parameters.additionalRois = this->imageDisplay->getAdditionalRois();
 		this->parameters.minThreshold = settings.value(PEAKDETECTOR_MIN_THRESHOLD).toDouble();
 		this->parameters.showMinThreshold = settings.value(PEAKDETECTOR_SHOW_MIN_THRESHOLD).toBool();
+		this->parameters.thresholdMode = static_cast<THRESHOLD_MODE>(settings.value(PEAKDETECTOR_THRESHOLD_MODE, THRESHOLD_FIXED).toInt());
+		this->parameters.noiseFactor = settings.value(PEAKDETECTOR_NOISE_FACTOR, DEFAULT_NOISE_FACTOR).toDouble();
 		this->parameters.autoScalingEnabled = settings.value(PEAKDETECTOR_AUTOSCALING_ENABLED).toBool();
 		this->parameters.windowState = settings.value(PEAKDETECTOR_WINDOW_STATE).toByteArray();
+		this->parameters.frameRingDepth = settings.value(PEAKDETECTOR_FRAME_RING_DEPTH, DEFAULT_FRAME_RING_DEPTH).toInt();
+		this->parameters.fullRateEnabled = settings.value(PEAKDETECTOR_FULL_RATE_ENABLED).toBool();
+		this->parameters.fusedIngestEnabled = settings.value(PEAKDETECTOR_FUSED_INGEST_ENABLED, true).toBool();
+		this->parameters.roiOnlyExtractionEnabled = settings.value(PEAKDETECTOR_ROI_ONLY_EXTRACTION, false).toBool();
+		this->parameters.integralTableEnabled = settings.value(PEAKDETECTOR_INTEGRAL_TABLE_ENABLED, false).toBool();
+		this->parameters.decimationTarget = static_cast<DECIMATION_TARGET>(settings.value(PEAKDETECTOR_DECIMATION_TARGET).toInt());
+		this->parameters.targetLatencyMs = settings.value(PEAKDETECTOR_TARGET_LATENCY, 50).toDouble();
+		this->parameters.cpuBudgetPercent = settings.value(PEAKDETECTOR_CPU_BUDGET, 25).toDouble();
 	}
 
 	// Update GUI elements
 	this->ui->spinBox_buffer->setValue(this->parameters.bufferNr);
 	//this->ui->comboBox_imageFeature->setCurrentIndex(static_cast<int>(this->parameters.imageFeature));
+	this->ui->comboBox_feature->setCurrentIndex(this->ui->comboBox_feature->findData(this->parameters.feature));
+	this->ui->spinBox_centroidHalfWidth->setValue(this->parameters.centroidHalfWidth);
+	this->ui->spinBox_centroidHalfWidth->setEnabled(this->parameters.feature == CENTROID);
+	this->ui->checkBox_multiPeak->setChecked(this->parameters.multiPeakEnabled);
+	this->ui->spinBox_maxPeaks->setValue(this->parameters.maxPeaks);
+	this->ui->spinBox_minPeakDistance->setValue(this->parameters.minPeakDistance);
+	this->ui->doubleSpinBox_minPeakProminence->setValue(this->parameters.minPeakProminence);
+	this->updateMultiPeakInput();
+	this->ui->checkBox_surfaceTracking->setChecked(this->parameters.surfaceTrackingEnabled);
+	this->ui->checkBox_tracking->setChecked(this->parameters.trackingEnabled);
+	this->ui->spinBox_trackingWindow->setValue(this->parameters.trackingWindowHalfWidth);
+	this->ui->doubleSpinBox_trackingAlpha->setValue(this->parameters.trackingAlpha);
+	this->ui->doubleSpinBox_trackingBeta->setValue(this->parameters.trackingBeta);
+	this->updateTrackingInput();
+	this->ui->comboBox_lineFilter->setCurrentIndex(this->ui->comboBox_lineFilter->findData(this->parameters.lineFilter));
+	this->ui->spinBox_lineFilterHalfWidth->setValue(this->parameters.lineFilterHalfWidth);
+	this->updateLineFilterInput();
+	this->ui->comboBox_rowAggregation->setCurrentIndex(this->ui->comboBox_rowAggregation->findData(this->parameters.rowAggregation));
+	this->ui->doubleSpinBox_trimFraction->setValue(this->parameters.trimFraction);
+	this->updateRowAggregationInput();
 	this->ui->horizontalSlider_frame->setValue(this->parameters.frameNr);
 	this->ui->widget_imageDisplay->setRoi(this->parameters.roi);
+	this->ui->widget_imageDisplay->setRoiName(this->parameters.roiName);
+	this->updateRoiNamesInput();
 	this->ui->doubleSpinBox_minThreshold->setValue(this->parameters.minThreshold);
 	this->ui->checkBox_showMinThreshold->setChecked(this->parameters.showMinThreshold);
+	this->ui->comboBox_thresholdMode->setCurrentIndex(this->ui->comboBox_thresholdMode->findData(this->parameters.thresholdMode));
+	this->ui->doubleSpinBox_noiseFactor->setValue(this->parameters.noiseFactor);
+	this->updateThresholdModeInput();
 	this->ui->checkBox_autoscaling->setChecked(this->parameters.autoScalingEnabled);
+	this->ui->spinBox_frameRingDepth->setValue(this->parameters.frameRingDepth);
+	this->ui->checkBox_fullRate->setChecked(this->parameters.fullRateEnabled);
+	this->ui->checkBox_fusedIngest->setChecked(this->parameters.fusedIngestEnabled);
+	this->ui->checkBox_roiOnly->setChecked(this->parameters.roiOnlyExtractionEnabled);
+	this->ui->checkBox_integralTable->setChecked(this->parameters.integralTableEnabled);
+	this->ui->comboBox_decimationTarget->setCurrentIndex(this->ui->comboBox_decimationTarget->findData(this->parameters.decimationTarget));
+	this->updateDecimationTargetInput();
 	this->enableAutoScalingLinePlot(this->parameters.autoScalingEnabled);
 	this->restoreGeometry(this->parameters.windowState);
 }
@@ -134,15 +449,41 @@ void PeakDetectorForm::getSettings(QVariantMap* settings) {
 	settings->insert(PEAKDETECTOR_BUFFER, this->parameters.bufferNr);
 	settings->insert(PEAKDETECTOR_SOURCE, static_cast<int>(this->parameters.bufferSource));
 	settings->insert(PEAKDETECTOR_FEATURE, static_cast<int>(this->parameters.feature));
+	settings->insert(PEAKDETECTOR_CENTROID_HALF_WIDTH, this->parameters.centroidHalfWidth);
+	settings->insert(PEAKDETECTOR_MULTI_PEAK_ENABLED, this->parameters.multiPeakEnabled);
+	settings->insert(PEAKDETECTOR_MAX_PEAKS, this->parameters.maxPeaks);
+	settings->insert(PEAKDETECTOR_MIN_PEAK_DISTANCE, this->parameters.minPeakDistance);
+	settings->insert(PEAKDETECTOR_MIN_PEAK_PROMINENCE, this->parameters.minPeakProminence);
+	settings->insert(PEAKDETECTOR_SURFACE_TRACKING_ENABLED, this->parameters.surfaceTrackingEnabled);
+	settings->insert(PEAKDETECTOR_TRACKING_ENABLED, this->parameters.trackingEnabled);
+	settings->insert(PEAKDETECTOR_TRACKING_WINDOW, this->parameters.trackingWindowHalfWidth);
+	settings->insert(PEAKDETECTOR_TRACKING_ALPHA, this->parameters.trackingAlpha);
+	settings->insert(PEAKDETECTOR_TRACKING_BETA, this->parameters.trackingBeta);
+	settings->insert(PEAKDETECTOR_LINE_FILTER, static_cast<int>(this->parameters.lineFilter));
+	settings->insert(PEAKDETECTOR_LINE_FILTER_HALF_WIDTH, this->parameters.lineFilterHalfWidth);
+	settings->insert(PEAKDETECTOR_ROW_AGGREGATION, static_cast<int>(this->parameters.rowAggregation));
+	settings->insert(PEAKDETECTOR_TRIM_FRACTION, this->parameters.trimFraction);
 	settings->insert(PEAKDETECTOR_FRAME, this->parameters.frameNr);
 	settings->insert(PEAKDETECTOR_ROI_X, this->parameters.roi.x());
 	settings->insert(PEAKDETECTOR_ROI_Y, this->parameters.roi.y());
 	settings->insert(PEAKDETECTOR_ROI_WIDTH, this->parameters.roi.width());
 	settings->insert(PEAKDETECTOR_ROI_HEIGHT, this->parameters.roi.height());
+	settings->insert(PEAKDETECTOR_ROI_NAME, this->parameters.roiName);
+	settings->insert(PEAKDETECTOR_ADDITIONAL_ROIS, this->imageDisplay->saveAdditionalRois());
 	settings->insert(PEAKDETECTOR_MIN_THRESHOLD, this->parameters.minThreshold);
 	settings->insert(PEAKDETECTOR_SHOW_MIN_THRESHOLD, this->parameters.showMinThreshold);
+	settings->insert(PEAKDETECTOR_THRESHOLD_MODE, static_cast<int>(this->parameters.thresholdMode));
+	settings->insert(PEAKDETECTOR_NOISE_FACTOR, this->parameters.noiseFactor);
 	settings->insert(PEAKDETECTOR_AUTOSCALING_ENABLED, this->parameters.autoScalingEnabled);
 	settings->insert(PEAKDETECTOR_WINDOW_STATE, this->parameters.windowState);
+	settings->insert(PEAKDETECTOR_FRAME_RING_DEPTH, this->parameters.frameRingDepth);
+	settings->insert(PEAKDETECTOR_FULL_RATE_ENABLED, this->parameters.fullRateEnabled);
+	settings->insert(PEAKDETECTOR_FUSED_INGEST_ENABLED, this->parameters.fusedIngestEnabled);
+	settings->insert(PEAKDETECTOR_ROI_ONLY_EXTRACTION, this->parameters.roiOnlyExtractionEnabled);
+	settings->insert(PEAKDETECTOR_INTEGRAL_TABLE_ENABLED, this->parameters.integralTableEnabled);
+	settings->insert(PEAKDETECTOR_DECIMATION_TARGET, static_cast<int>(this->parameters.decimationTarget));
+	settings->insert(PEAKDETECTOR_TARGET_LATENCY, this->parameters.targetLatencyMs);
+	settings->insert(PEAKDETECTOR_CPU_BUDGET, this->parameters.cpuBudgetPercent);
 }
 
 bool PeakDetectorForm::eventFilter(QObject* watched, QEvent* event) {
@@ -177,7 +518,7 @@ void PeakDetectorForm::plotLine(QVector<qreal> line) {
 	this->linePlot->plotLine(line);
 }
 
-void PeakDetectorForm::plotPeakPositionIndicator(int pos){
+void PeakDetectorForm::plotPeakPositionIndicator(double pos){
 	if(pos < 0){
 		this->linePlot->setVerticalLineVisible(false);
 	} else {
@@ -186,14 +527,76 @@ void PeakDetectorForm::plotPeakPositionIndicator(int pos){
 	}
 }
 
-void PeakDetectorForm::displayPeakPositionValue(int pos) {
+void PeakDetectorForm::displayPeakPositionValue(double pos) {
 	if(pos < 0){
 		this->ui->lineEdit_peakPosition->setText(tr("No peak detected"));
+	} else if(this->parameters.feature == MAXVALUE){
+		this->ui->lineEdit_peakPosition->setText(QString::number(pos, 'f', 0));
 	} else {
-		this->ui->lineEdit_peakPosition->setText(QString::number(pos));
+		this->ui->lineEdit_peakPosition->setText(QString::number(pos, 'f', 2));
+	}
+}
+
+void PeakDetectorForm::displayPeakResult(PeakResult result) {
+	this->plotPeakPositionIndicator(result.position);
+	this->displayPeakPositionValue(result.position);
+
+	//details of the result are available on hover, so the large position display stays readable
+	QString details = tr("Buffer %1, frame %2").arg(result.bufferNr).arg(result.frameNr);
+	if (result.position >= 0) {
+		details += tr("\nAmplitude: ") + QString::number(result.amplitude, 'f', 1) + tr("\nSNR: ") + QString::number(result.snr, 'f', 1);
+	}
+	details += tr("\nProcessing time: ") + QString::number(static_cast<double>(result.computeNs)/1.0e6, 'f', 3) + tr(" ms");
+	this->ui->lineEdit_peakPosition->setToolTip(details);
+
+	//last hop of the latency measurement, the statistics themselves are only redrawn a few times per second
+	if (this->latencyMonitor != nullptr && result.analyzedNs >= 0) {
+		qint64 displayedNs = this->latencyMonitor->now();
+		this->latencyMonitor->record(STAGE_DISPLAY, result.analyzedNs, displayedNs);
+		this->latencyMonitor->record(STAGE_TOTAL, result.timestampNs, displayedNs);
+		if (!this->latencyDisplayTimer.isValid() || this->latencyDisplayTimer.elapsed() >= LATENCY_DISPLAY_INTERVAL_MS) {
+			this->displayLatencyStatistics();
+		}
 	}
 }
 
+void PeakDetectorForm::plotPeakMarkers(QVector<QPointF> peaks) {
+	this->linePlot->plotMarkers(peaks);
+}
+
+void PeakDetectorForm::displaySurfaceProfile(SurfaceProfile profile) {
+	if (!this->parameters.surfaceTrackingEnabled) {
+		return;
+	}
+	this->imageDisplay->displaySurfaceProfile(profile);
+	if (profile.validLines == 0) {
+		this->ui->label_surface->setText(tr("Surface: no peak detected"));
+		return;
+	}
+	this->ui->label_surface->setText(tr("Surface: mean ") + QString::number(profile.mean, 'f', 1) + tr(", slope ") + QString::number(profile.slope, 'f', 3) + tr("/line, RMS ") + QString::number(profile.rms, 'f', 2) + tr(" (frame ") + QString::number(profile.frameNr) + ")");
+}
+
+void PeakDetectorForm::displayRoiPeaks(QVector<RoiPeak> peaks) {
+	//peak of the main roi is already shown above, the label lists all rois so they can be compared
+	if (peaks.size() < 2) {
+		return;
+	}
+	QStringList texts;
+	for (const RoiPeak& peak : peaks) {
+		QString position = peak.position < 0 ? tr("-") : QString::number(peak.position, 'f', this->parameters.feature == MAXVALUE ? 0 : 2);
+		texts.append(peak.name + ": " + position);
+	}
+	this->ui->label_rois->setText(tr("ROIs: ") + texts.join(", "));
+}
+
+void PeakDetectorForm::displayTrackingState(double position, double velocity, bool locked) {
+	if (!locked) {
+		this->ui->label_tracking->setText(tr("Tracked: searching..."));
+		return;
+	}
+	this->ui->label_tracking->setText(tr("Tracked: ") + QString::number(position, 'f', 2) + tr(" (") + QString::number(velocity, 'f', 2) + tr(" samples/frame)"));
+}
+
 void PeakDetectorForm::displayMinThreshold(double value) {
 	if(this->parameters.showMinThreshold){
 		this->linePlot->setHorizontalLineVisible(true);
@@ -203,6 +606,142 @@ void PeakDetectorForm::displayMinThreshold(double value) {
 	}
 }
 
+void PeakDetectorForm::displayEstimatedThreshold(double value) {
+	//adaptive threshold changes with every analyzed frame, the fixed one is shown when its spin box changes
+	this->estimatedThreshold = value;
+	if (this->parameters.thresholdMode == THRESHOLD_ADAPTIVE) {
+		this->displayMinThreshold(value);
+	}
+}
+
 void PeakDetectorForm::enableAutoScalingLinePlot(bool autoScaleEnabled) {
 	this->linePlot->enableAutoScaling(autoScaleEnabled);
 }
+
+
+void PeakDetectorForm::displayFrameRate(double framesPerSecond) {
+	this->ui->label_frameRate->setText(tr("Analyzed frames/s: ") + QString::number(framesPerSecond, 'f', 1));
+}
+
+void PeakDetectorForm::displayDecimation(int ratio, double analyzedBuffersPerSecond, bool targetReachable) {
+	QString text = tr("Analyzed buffers: 1 of ") + QString::number(ratio) + " (" + QString::number(analyzedBuffersPerSecond, 'f', 1) + tr(" buffers/s)");
+	if(!targetReachable){
+		//a single buffer takes longer than the target latency, decimation can only keep the analysis from falling behind
+		text += tr(" - target latency not reachable");
+	}
+	this->ui->label_decimation->setText(text);
+}
+
+void PeakDetectorForm::updateDecimationTargetInput() {
+	//spin box shows either target latency or cpu budget, depending on selected decimation target
+	double value = 0;
+	this->ui->doubleSpinBox_decimationTarget->blockSignals(true);
+	if(this->parameters.decimationTarget == TARGET_CPU_BUDGET){
+		this->ui->doubleSpinBox_decimationTarget->setRange(1, 100);
+		this->ui->doubleSpinBox_decimationTarget->setSuffix(" %");
+		value = this->parameters.cpuBudgetPercent;
+	}else{
+		this->ui->doubleSpinBox_decimationTarget->setRange(1, 10000);
+		this->ui->doubleSpinBox_decimationTarget->setSuffix(" ms");
+		value = this->parameters.targetLatencyMs;
+	}
+	this->ui->doubleSpinBox_decimationTarget->setValue(value);
+	this->ui->doubleSpinBox_decimationTarget->blockSignals(false);
+	emit decimationTargetChanged(this->parameters.decimationTarget, value);
+}
+
+void PeakDetectorForm::updateMultiPeakInput() {
+	this->ui->spinBox_maxPeaks->setEnabled(this->parameters.multiPeakEnabled);
+	this->ui->spinBox_minPeakDistance->setEnabled(this->parameters.multiPeakEnabled);
+	this->ui->doubleSpinBox_minPeakProminence->setEnabled(this->parameters.multiPeakEnabled);
+
+	//markers of the last detection would stay in the plot otherwise
+	this->linePlot->setMarkersVisible(this->parameters.multiPeakEnabled);
+}
+
+void PeakDetectorForm::updateTrackingInput() {
+	this->ui->spinBox_trackingWindow->setEnabled(this->parameters.trackingEnabled);
+	this->ui->doubleSpinBox_trackingAlpha->setEnabled(this->parameters.trackingEnabled);
+	this->ui->doubleSpinBox_trackingBeta->setEnabled(this->parameters.trackingEnabled);
+	this->ui->label_tracking->setVisible(this->parameters.trackingEnabled);
+	this->ui->label_tracking->setText(tr("Tracked: -"));
+}
+
+void PeakDetectorForm::updateLineFilterInput() {
+	this->ui->spinBox_lineFilterHalfWidth->setEnabled(this->parameters.lineFilter != FILTER_NONE);
+}
+
+void PeakDetectorForm::updateRowAggregationInput() {
+	this->ui->doubleSpinBox_trimFraction->setEnabled(this->parameters.rowAggregation == AGGREGATION_TRIMMED_MEAN);
+}
+
+void PeakDetectorForm::updateRoiNamesInput() {
+	QStringList names(this->parameters.roiName);
+	for (const NamedRoi& roi : this->parameters.additionalRois) {
+		names.append(roi.name);
+	}
+	this->ui->lineEdit_roiNames->setText(names.join(", "));
+	this->ui->label_rois->setVisible(!this->parameters.additionalRois.isEmpty());
+	this->ui->label_rois->setText(tr("ROIs: -"));
+}
+
+void PeakDetectorForm::updateThresholdModeInput() {
+	bool adaptive = this->parameters.thresholdMode == THRESHOLD_ADAPTIVE;
+	this->ui->doubleSpinBox_minThreshold->setEnabled(!adaptive);
+	this->ui->doubleSpinBox_noiseFactor->setEnabled(adaptive);
+	this->displayMinThreshold(adaptive ? this->estimatedThreshold : this->parameters.minThreshold);
+}
+
+void PeakDetectorForm::displayLatencyStatistics() {
+	this->latencyDisplayTimer.start();
+	if (this->latencyMonitor == nullptr) {
+		this->ui->label_latency->setText(tr("Latency: -"));
+		return;
+	}
+	QString text = tr("Latency p50 / p99 / max [ms]");
+	for (int i = 0; i < STAGE_COUNT; ++i) {
+		const LatencyHistogram& histogram = this->latencyMonitor->getHistogram(static_cast<LATENCY_STAGE>(i));
+		text += "\n" + LatencyMonitor::stageName(static_cast<LATENCY_STAGE>(i)) + ": ";
+		if (histogram.getCount() == 0) {
+			text += "-";
+			continue;
+		}
+		text += QString::number(static_cast<double>(histogram.percentile(0.5))/1.0e6, 'f', 3)
+			+ " / " + QString::number(static_cast<double>(histogram.percentile(0.99))/1.0e6, 'f', 3)
+			+ " / " + QString::number(static_cast<double>(histogram.getMax())/1.0e6, 'f', 3);
+	}
+	this->ui->label_latency->setText(text);
+}
+
+void PeakDetectorForm::saveLatencyStatistics() {
+	if (this->latencyMonitor == nullptr) {
+		return;
+	}
+	QString fileName = QFileDialog::getSaveFileName(this, tr("Export Latency Statistics"), QDir::currentPath(), "CSV (*.csv)");
+	if (fileName == "") {
+		emit error(tr("Export of latency statistics canceled."));
+		return;
+	}
+	QFile file(fileName);
+	if (!file.open(QFile::WriteOnly|QFile::Truncate)) {
+		emit error(tr("Could not save latency statistics to ") + fileName);
+		return;
+	}
+	QTextStream stream(&file);
+	stream << this->latencyMonitor->toCsv();
+	file.close();
+	emit info(tr("Latency statistics saved to ") + fileName);
+}
+
+void PeakDetectorForm::saveTrace() {
+	QString fileName = QFileDialog::getSaveFileName(this, tr("Save Trace"), QDir::currentPath(), "JSON (*.json)");
+	if (fileName == "") {
+		emit error(tr("Save trace canceled."));
+		return;
+	}
+	if (!TraceRecorder::saveChromeTrace(fileName)) {
+		emit error(tr("Could not save trace to ") + fileName);
+		return;
+	}
+	emit info(tr("Trace with ") + QString::number(TraceRecorder::getEventCount()) + tr(" events saved to ") + fileName);
+}
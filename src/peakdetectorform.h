@@ -3,9 +3,14 @@
 
 #include <QWidget>
 #include <QRect>
+#include <QElapsedTimer>
 #include "peakdetectorparameters.h"
 #include "lineplot.h"
 #include "imagedisplay.h"
+#include "frameringbuffer.h"
+#include "roipeak.h"
+#include "peakresult.h"
+#include "latencymonitor.h"
 
 namespace Ui {
 class PeakDetectorForm;
@@ -21,6 +26,7 @@ public:
 
 	void setSettings(QVariantMap settings);
 	void getSettings(QVariantMap* settings);
+	void setLatencyMonitor(LatencyMonitor* monitor);
 
 	ImageDisplay* getImageDisplay(){return this->imageDisplay;}
 	LinePlot* getLinePlot(){return this->linePlot;}
@@ -34,16 +40,38 @@ public slots:
 	void setMaximumFrameNr(int maximum);
 	void setMaximumBufferNr(int maximum);
 	void plotLine(QVector<qreal> line);
-	void plotPeakPositionIndicator(int pos);
-	void displayPeakPositionValue(int pos);
+	void plotPeakPositionIndicator(double pos);
+	void displayPeakPositionValue(double pos);
+	void displayPeakResult(PeakResult result);
+	void plotPeakMarkers(QVector<QPointF> peaks);
+	void displaySurfaceProfile(SurfaceProfile profile);
+	void displayRoiPeaks(QVector<RoiPeak> peaks);
+	void displayTrackingState(double position, double velocity, bool locked);
 	void displayMinThreshold(double value);
+	void displayEstimatedThreshold(double value);
 	void enableAutoScalingLinePlot(bool autoScaleEnabled);
+	void displayFrameRate(double framesPerSecond);
+	void displayDecimation(int ratio, double analyzedBuffersPerSecond, bool targetReachable);
 
 private:
 	ImageDisplay* imageDisplay;
 	LinePlot* linePlot;
 	PeakDetectorParameters parameters;
 	bool firstRun;
+	double estimatedThreshold;
+	LatencyMonitor* latencyMonitor;
+	QElapsedTimer latencyDisplayTimer;
+
+	void updateDecimationTargetInput();
+	void updateMultiPeakInput();
+	void updateTrackingInput();
+	void updateLineFilterInput();
+	void updateRowAggregationInput();
+	void updateRoiNamesInput();
+	void updateThresholdModeInput();
+	void displayLatencyStatistics();
+	void saveLatencyStatistics();
+	void saveTrace();
 
 signals:
 	void paramsChanged(PeakDetectorParameters);
@@ -53,6 +81,12 @@ signals:
 	void bufferSourceChanged(BUFFER_SOURCE);
 	void roiChanged(QRect);
 	void minThresholdChanged(double);
+	void frameRingDepthChanged(int);
+	void fullRateEnabledChanged(bool);
+	void fusedIngestEnabledChanged(bool);
+	void roiOnlyExtractionEnabledChanged(bool);
+	void surfaceTrackingEnabledChanged(bool);
+	void decimationTargetChanged(DECIMATION_TARGET target, double value);
 	void info(QString);
 	void error(QString);
 };
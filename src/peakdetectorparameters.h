@@ -5,19 +5,46 @@
 #include <QtGlobal>
 #include <QMetaType>
 #include <QRect>
+#include <QVector>
 
 #define PEAKDETECTOR_SOURCE "image_source"
 #define PEAKDETECTOR_FEATURE "feature"
+#define PEAKDETECTOR_CENTROID_HALF_WIDTH "centroid_half_width"
+#define PEAKDETECTOR_MULTI_PEAK_ENABLED "multi_peak_enabled"
+#define PEAKDETECTOR_MAX_PEAKS "max_peaks"
+#define PEAKDETECTOR_MIN_PEAK_DISTANCE "min_peak_distance"
+#define PEAKDETECTOR_MIN_PEAK_PROMINENCE "min_peak_prominence"
+#define PEAKDETECTOR_SURFACE_TRACKING_ENABLED "surface_tracking_enabled"
+#define PEAKDETECTOR_TRACKING_ENABLED "tracking_enabled"
+#define PEAKDETECTOR_TRACKING_WINDOW "tracking_window_half_width"
+#define PEAKDETECTOR_TRACKING_ALPHA "tracking_alpha"
+#define PEAKDETECTOR_TRACKING_BETA "tracking_beta"
+#define PEAKDETECTOR_LINE_FILTER "line_filter"
+#define PEAKDETECTOR_LINE_FILTER_HALF_WIDTH "line_filter_half_width"
+#define PEAKDETECTOR_ROW_AGGREGATION "row_aggregation"
+#define PEAKDETECTOR_TRIM_FRACTION "trim_fraction"
+#define PEAKDETECTOR_INTEGRAL_TABLE_ENABLED "integral_table_enabled"
 #define PEAKDETECTOR_FRAME "frame_number"
 #define PEAKDETECTOR_BUFFER "buffer_number"
 #define PEAKDETECTOR_ROI_X "roi_x"
 #define PEAKDETECTOR_ROI_Y "roi_y"
 #define PEAKDETECTOR_ROI_WIDTH "roi_width"
 #define PEAKDETECTOR_ROI_HEIGHT "roi_height"
+#define PEAKDETECTOR_ROI_NAME "roi_name"
+#define PEAKDETECTOR_ADDITIONAL_ROIS "additional_rois"
 #define PEAKDETECTOR_MIN_THRESHOLD "min_threshold"
 #define PEAKDETECTOR_SHOW_MIN_THRESHOLD "show_min_threshold"
+#define PEAKDETECTOR_THRESHOLD_MODE "threshold_mode"
+#define PEAKDETECTOR_NOISE_FACTOR "noise_factor"
 #define PEAKDETECTOR_AUTOSCALING_ENABLED "auto_scaling_enabled"
 #define PEAKDETECTOR_WINDOW_STATE "window_state"
+#define PEAKDETECTOR_FRAME_RING_DEPTH "frame_ring_depth"
+#define PEAKDETECTOR_FULL_RATE_ENABLED "full_rate_enabled"
+#define PEAKDETECTOR_FUSED_INGEST_ENABLED "fused_ingest_enabled"
+#define PEAKDETECTOR_ROI_ONLY_EXTRACTION "roi_only_extraction_enabled"
+#define PEAKDETECTOR_DECIMATION_TARGET "decimation_target"
+#define PEAKDETECTOR_TARGET_LATENCY "target_latency_ms"
+#define PEAKDETECTOR_CPU_BUDGET "cpu_budget_percent"
 
 
 enum BUFFER_SOURCE{
@@ -26,19 +53,83 @@ enum BUFFER_SOURCE{
 };
 
 enum PEAK_FEATURE{
-	MAXVALUE
+	MAXVALUE,
+	PARABOLIC_FIT,
+	GAUSSIAN_FIT,
+	CENTROID
 };
 
+enum LINE_FILTER{
+	FILTER_NONE,
+	FILTER_BOXCAR,
+	FILTER_SAVITZKY_GOLAY,
+	FILTER_GAUSSIAN
+};
+
+enum ROW_AGGREGATION{
+	AGGREGATION_MEAN,
+	AGGREGATION_MEDIAN,
+	AGGREGATION_TRIMMED_MEAN,
+	AGGREGATION_MAX
+};
+
+enum THRESHOLD_MODE{
+	THRESHOLD_FIXED,
+	THRESHOLD_ADAPTIVE
+};
+
+enum DECIMATION_TARGET{
+	TARGET_LATENCY,
+	TARGET_CPU_BUDGET
+};
+
+//ROI that is analyzed in addition to the main ROI, its results are identified by the name
+struct NamedRoi {
+	QString name;
+	QRect rect;
+
+	bool operator==(const NamedRoi& other) const {return this->name == other.name && this->rect == other.rect;}
+	bool operator!=(const NamedRoi& other) const {return !(*this == other);}
+};
+
+//Every field starts with its neutral value, so features that are not set explicitly are off and no field is
+//indeterminate before the first parameters arrive. The defaults that are shown to the user are set by the form.
 struct PeakDetectorParameters {
-	BUFFER_SOURCE bufferSource;
-	PEAK_FEATURE feature;
+	BUFFER_SOURCE bufferSource = PROCESSED;
+	PEAK_FEATURE feature = MAXVALUE;
+	int centroidHalfWidth = 0;
+	bool multiPeakEnabled = false;
+	int maxPeaks = 0;
+	int minPeakDistance = 0;
+	double minPeakProminence = 0.0;
+	bool surfaceTrackingEnabled = false;
+	bool trackingEnabled = false;
+	int trackingWindowHalfWidth = 0;
+	double trackingAlpha = 0.0;
+	double trackingBeta = 0.0;
+	LINE_FILTER lineFilter = FILTER_NONE;
+	int lineFilterHalfWidth = 0;
+	ROW_AGGREGATION rowAggregation = AGGREGATION_MEAN;
+	double trimFraction = 0.0;
+	bool integralTableEnabled = false;
 	QRect roi;
-	int frameNr;
-	int bufferNr;
-	double minThreshold;
-	bool showMinThreshold;
-	bool autoScalingEnabled;
+	QString roiName;
+	QVector<NamedRoi> additionalRois;
+	int frameNr = 0;
+	int bufferNr = 0;
+	double minThreshold = 0.0;
+	bool showMinThreshold = false;
+	THRESHOLD_MODE thresholdMode = THRESHOLD_FIXED;
+	double noiseFactor = 0.0;
+	bool autoScalingEnabled = false;
 	QByteArray windowState;
+	int frameRingDepth = 0;
+	bool fullRateEnabled = false;
+	bool fusedIngestEnabled = false;
+	bool roiOnlyExtractionEnabled = false;
+	DECIMATION_TARGET decimationTarget = TARGET_LATENCY;
+	double targetLatencyMs = 0.0;
+	double cpuBudgetPercent = 0.0;
 };
 Q_DECLARE_METATYPE(PeakDetectorParameters)
 
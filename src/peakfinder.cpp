@@ -1,60 +1,613 @@
 #include "peakfinder.h"
+#include "columnaccumulator.h"
+#include "maxsearch.h"
+#include "peakinterpolation.h"
+#include "linepeaksearch.h"
 #include <QtMath>
+#include <cstring>
 
 PeakFinder::PeakFinder(QObject *parent)
 	: QObject(parent),
-	isFeatureExtracting(false)
+	isFeatureExtracting(false),
+	analyzedFrames(0),
+	parallelAccumulator(new ParallelAccumulator()),
+	additionalRoisSwept(false),
+	reanalysisTimer(new QTimer(this)),
+	lastFrameValid(false),
+	heldSlot(nullptr),
+	lastFrameTimestampNs(-1),
+	lastFrameBufferNr(-1),
+	lastFrameNr(-1),
+	batches(PEAK_BATCH_RING_SIZE),
+	batchIndex(0),
+	threshold(0.0),
+	latencyMonitor(nullptr),
+	analysisStartNs(-1)
 {
+	this->result.timestampNs = -1;
+	this->result.bufferNr = -1;
+	this->result.frameNr = -1;
+	this->result.position = -1;
+	this->result.amplitude = 0;
+	this->result.snr = 0;
+	this->result.computeNs = 0;
+	this->result.analyzedNs = -1;
+	for (PeakBatch& batch : this->batches) {
+		batch.timestampNs = -1;
+		batch.bufferNr = -1;
+		batch.firstFrameNr = -1;
+		batch.frameCount = 0;
+	}
+	this->reanalysisTimer->setSingleShot(true);
+	this->reanalysisTimer->setInterval(REANALYSIS_DELAY_MS);
+	connect(this->reanalysisTimer, &QTimer::timeout, this, &PeakFinder::reanalyzeLastFrame);
+}
 
+PeakFinder::~PeakFinder() {
+	delete this->parallelAccumulator;
 }
 
 void PeakFinder::setParams(PeakDetectorParameters params) {
+	//tracked position is meaningless for a different roi or feature
+	bool roiChanged = params.roi != this->params.roi;
+	if (!params.trackingEnabled || roiChanged || params.feature != this->params.feature) {
+		this->peakTracker.reset();
+	}
+	this->peakTracker.setGains(params.trackingAlpha, params.trackingBeta);
+	this->lineFilter.setFilter(params.lineFilter, params.lineFilterHalfWidth);
+	bool changed = analysisChanged(params, this->params);
 	this->params = params;
+	if (changed) {
+		this->scheduleReanalysis();
+	}
 }
 
 void PeakFinder::findPeak(void* frameBuffer, unsigned int bitDepth, unsigned int samplesPerLine, unsigned int linesPerFrame) {
+	this->findPeaksInViews(FrameView::fullFrame(frameBuffer, bitDepth, samplesPerLine, linesPerFrame), 1, 0);
+}
+
+void PeakFinder::findPeaks(void* frames, unsigned int bitDepth, unsigned int samplesPerLine, unsigned int linesPerFrame, unsigned int frameCount) {
+	size_t bytesPerFrame = static_cast<size_t>(samplesPerLine)*linesPerFrame*FrameView::bytesPerSample(bitDepth);
+	this->findPeaksInViews(FrameView::fullFrame(frames, bitDepth, samplesPerLine, linesPerFrame), frameCount, bytesPerFrame);
+}
+
+void PeakFinder::findPeaksInViews(FrameView firstFrame, unsigned int frameCount, size_t bytesPerFrame) {
+	//frames of direct calls stay with the caller, so the last one is copied for a later reanalysis
+	if (this->analyzeViews(firstFrame, frameCount, bytesPerFrame)) {
+		this->lastFrameTimestampNs = this->result.timestampNs;
+		this->lastFrameBufferNr = this->result.bufferNr;
+		this->lastFrameNr = this->result.frameNr;
+		this->keepLastFrame(lastFrameOf(firstFrame, frameCount, bytesPerFrame));
+	}
+}
+
+bool PeakFinder::analyzeViews(const FrameView& firstFrame, unsigned int frameCount, size_t bytesPerFrame) {
+	if (this->isFeatureExtracting) {
+		return false;
+	}
+	this->isFeatureExtracting = true;
+	this->reanalysisTimer->stop();
+	this->computeTimer.start();
+
+	//analyze all frames of the batch and only publish the detailed result of the last one to keep signal traffic independent of frame rate
+	PeakBatch& batch = this->nextPeakBatch(frameCount);
+	this->findPeaksInFrames(firstFrame, frameCount, bytesPerFrame, batch.positions.data(), batch.amplitudes.data(), batch.flags.data());
+	FrameView frame = lastFrameOf(firstFrame, frameCount, bytesPerFrame);
+	double peakPosition = frameCount > 0 ? batch.positions.at(static_cast<int>(frameCount)-1) : -1;
+	this->findAdditionalRoiPeaks(frame);
+	this->publishResults(peakPosition);
+	this->publishPeakBatch();
+	this->findSurfaceProfile(frame, this->result.frameNr);
+
+	this->updateFrameRate(frameCount);
+	this->isFeatureExtracting = false;
+	return true;
+}
+
+FrameView PeakFinder::lastFrameOf(const FrameView& firstFrame, unsigned int frameCount, size_t bytesPerFrame) {
+	FrameView frame = firstFrame;
+	if (frameCount > 0) {
+		frame.data = static_cast<const char*>(firstFrame.data) + (frameCount-1)*bytesPerFrame;
+	}
+	return frame;
+}
+
+int PeakFinder::findPeaksInFrames(const FrameView& firstFrame, unsigned int frameCount, size_t frameStride, double* positions, double* amplitudes, quint8* flags) {
+	//frames are frameStride bytes apart, the outputs need space for frameCount values. Nothing is emitted here
+	FrameView frame = firstFrame;
+	int foundPeaks = 0;
+	for (unsigned int i = 0; i < frameCount; i++) {
+		frame.data = static_cast<const char*>(firstFrame.data) + i*frameStride;
+		double peakPosition = this->analyzeFrame(frame, i+1 == frameCount);
+		if (peakPosition >= 0) {
+			foundPeaks++;
+		}
+		positions[i] = peakPosition;
+		amplitudes[i] = this->amplitudeAt(peakPosition);
+		flags[i] = this->peakFlags(peakPosition);
+	}
+	return foundPeaks;
+}
+
+PeakBatch& PeakFinder::nextPeakBatch(unsigned int frameCount) {
+	//the batch that was emitted PEAK_BATCH_RING_SIZE batches ago is reused, its arrays are normally not shared with a receiver anymore
+	this->batchIndex = (this->batchIndex+1)%PEAK_BATCH_RING_SIZE;
+	PeakBatch& batch = this->batches[this->batchIndex];
+	batch.resize(static_cast<int>(frameCount));
+	return batch;
+}
+
+quint8 PeakFinder::peakFlags(double peakPosition) const {
+	quint8 flags = 0;
+	if (peakPosition >= 0) {
+		flags |= PEAK_FLAG_FOUND;
+	}
+	if (this->params.trackingEnabled && this->peakTracker.isLocked()) {
+		flags |= PEAK_FLAG_TRACKED;
+	}
+	if (this->averagedRoi.isEmpty()) {
+		flags |= PEAK_FLAG_ROI_EMPTY;
+	}
+	return flags;
+}
+
+void PeakFinder::processFrameSlot(FrameSlot* slot) {
+	TRACE_SCOPE("PeakFinder::processFrameSlot");
+	QElapsedTimer processingTimer;
+	processingTimer.start();
+	if (this->latencyMonitor != nullptr) {
+		this->analysisStartNs = this->latencyMonitor->now();
+		this->latencyMonitor->record(STAGE_QUEUE, slot->copiedNs, this->analysisStartNs);
+	}
+
+	//published result belongs to the last frame of the slot
+	this->result.timestampNs = slot->timestampNs;
+	this->result.bufferNr = slot->bufferNr;
+	this->result.frameNr = slot->firstFrameNr + static_cast<int>(qMax(1u, slot->frameCount)) - 1;
+
+	FrameView view;
+	view.data = slot->data;
+	view.bitDepth = slot->bitDepth;
+	view.samplesPerLine = slot->samplesPerLine;
+	view.linesPerFrame = slot->linesPerFrame;
+	view.stride = slot->stride;
+	view.region = slot->region;
+	bool frameAnalyzed = false;
+	if (slot->hasColumnSums) {
+		this->findPeaksInColumnSums(slot->columnSums, slot->roi, slot->samplesPerLine, qMax(1u, slot->frameCount));
+
+		//slot only contains frame data if it was copied for the image display, the surface profile or a later reanalysis.
+		//This can be a different frame of the buffer than the last one the result belongs to
+		if (slot->hasFrameData) {
+			this->findSurfaceProfile(view, slot->dataFrameNr);
+			frameAnalyzed = true;
+		}
+	} else {
+		frameAnalyzed = this->analyzeViews(view, qMax(1u, slot->frameCount), slot->bytesPerFrame);
+		view = lastFrameOf(view, qMax(1u, slot->frameCount), slot->bytesPerFrame);
+	}
+
+	//results of a reanalysis or of direct calls are not part of the latency statistics
+	this->analysisStartNs = -1;
+
+	//processing time is used to adapt the decimation ratio
+	emit processingTimeMeasured(qMax(1u, slot->frameCount), processingTimer.nsecsElapsed());
+
+	//instead of copying the last frame for a reanalysis the slot is kept until the next frame arrives or the producer needs
+	//it back. Slots without frame data are handed back right away and the previously kept frame stays available
+	if (frameAnalyzed && view.data != nullptr && view.region.width() > 0 && view.region.height() > 0) {
+		this->holdLastFrame(slot, view);
+	} else {
+		emit frameSlotReleased(slot);
+	}
+}
+
+void PeakFinder::findPeaksInColumnSums(const quint64* columnSums, QRect roi, unsigned int samplesPerLine, unsigned int frameCount) {
 	if (!this->isFeatureExtracting) {
 		this->isFeatureExtracting = true;
-		int peakPosition = -1;
-
-		QVector<qreal> averagedLine = this->calculateAveragedLine(frameBuffer, bitDepth, samplesPerLine, linesPerFrame);
-		emit averagedLineCalculated(averagedLine);
+		this->reanalysisTimer->stop();
+		this->computeTimer.start();
 
-		//find peak in averaged A-scan based on selected method/feature
-		switch (this->params.feature) {
-			case MAXVALUE:
-				peakPosition = this->findMaxValuePosition(averagedLine, this->params.minThreshold);
-				break;
-			//todo: additional cases for other features
+		//column sums were already calculated while the frames were copied, only averaging and feature extraction is left.
+		//Every frame gets its entry in the batch, the detailed result is only published for the last one
+		this->integralTable.invalidate();
+		PeakBatch& batch = this->nextPeakBatch(frameCount);
+		double peakPosition = -1;
+		for (unsigned int i = 0; i < frameCount; i++) {
+			this->averageColumnSums(columnSums + static_cast<size_t>(i)*roi.width(), roi, samplesPerLine);
+			peakPosition = this->extractFeature();
+			batch.positions[static_cast<int>(i)] = peakPosition;
+			batch.amplitudes[static_cast<int>(i)] = this->amplitudeAt(peakPosition);
+			batch.flags[static_cast<int>(i)] = this->peakFlags(peakPosition);
 		}
 
-		emit peakPositionFound(peakPosition);
+		//column sums are only provided for the main roi, they are not used while additional rois are set
+		this->roiPeaks.clear();
+		this->publishResults(peakPosition);
+		this->publishPeakBatch();
+
+		this->updateFrameRate(frameCount);
 		this->isFeatureExtracting = false;
 	}
 }
 
 void PeakFinder::setRoi(QRect roi) {
+	if (roi == this->params.roi) {
+		return;
+	}
+	this->peakTracker.reset();
 	this->params.roi = roi;
+	this->scheduleReanalysis();
 }
 
 void PeakFinder::setFeature(int featureOption) {
 	this->params.feature = static_cast<PEAK_FEATURE>(featureOption);
+	this->scheduleReanalysis();
 }
 
-int PeakFinder::findMaxValuePosition(const QVector<qreal>& line, double threshold) {
-	if (line.isEmpty()) {
+bool PeakFinder::reanalyzeLastFrame() {
+	TRACE_SCOPE("PeakFinder::reanalyzeLastFrame");
+
+	//a moved roi or changed parameter is applied right away to the last frame, instead of waiting for the next one.
+	//With a valid integral table no pass over the frame is needed
+	if (this->isFeatureExtracting) {
+		return false;
+	}
+	this->reanalysisTimer->stop();
+	this->computeTimer.start();
+
+	//the last frame was already fed into the tracker, it must not be counted twice
+	this->peakTracker.reset();
+	if (this->reanalyzeIntegralTable()) {
+		if (this->lastFrameValid) {
+			this->findSurfaceProfile(this->lastFrame, this->lastFrameNr);
+		}
+		return true;
+	}
+	if (!this->lastFrameValid) {
+		return false;
+	}
+
+	//result is published for the kept frame, which is not necessarily the last analyzed one
+	this->isFeatureExtracting = true;
+	this->result.timestampNs = this->lastFrameTimestampNs;
+	this->result.bufferNr = this->lastFrameBufferNr;
+	this->result.frameNr = this->lastFrameNr;
+	double peakPosition = this->analyzeFrame(this->lastFrame, true);
+	this->findAdditionalRoiPeaks(this->lastFrame);
+	this->publishResults(peakPosition);
+	this->findSurfaceProfile(this->lastFrame, this->lastFrameNr);
+	this->isFeatureExtracting = false;
+	return true;
+}
+
+void PeakFinder::scheduleReanalysis() {
+	//every change restarts the timer, so a burst of changes while the roi is dragged results in a single reanalysis
+	this->reanalysisTimer->start();
+}
+
+void PeakFinder::releaseLastFrame() {
+	//producer needs the kept slot back, the frame is copied once so a reanalysis is still possible
+	if (this->heldSlot == nullptr) {
+		return;
+	}
+	if (this->lastFrameValid) {
+		this->keepLastFrame(this->lastFrame);
+	} else {
+		this->releaseHeldSlot();
+	}
+}
+
+void PeakFinder::keepLastFrame(const FrameView& frame) {
+	//the view is copied into a buffer that only grows, a held slot is not needed anymore afterwards
+	bool valid = frame.data != nullptr && frame.region.width() > 0 && frame.region.height() > 0;
+	if (valid) {
+		size_t bytes = frame.stride*static_cast<size_t>(frame.region.height())*FrameView::bytesPerSample(frame.bitDepth);
+		if (static_cast<size_t>(this->lastFrameData.size()) < bytes) {
+			this->lastFrameData.resize(static_cast<int>(bytes));
+		}
+		memcpy(this->lastFrameData.data(), frame.data, bytes);
+		this->lastFrame = frame;
+		this->lastFrame.data = this->lastFrameData.constData();
+	}
+	this->lastFrameValid = valid;
+	this->releaseHeldSlot();
+}
+
+void PeakFinder::holdLastFrame(FrameSlot* slot, const FrameView& frame) {
+	FrameSlot* previousSlot = this->heldSlot;
+	this->heldSlot = slot;
+	this->lastFrame = frame;
+	this->lastFrameValid = true;
+	this->lastFrameTimestampNs = slot->timestampNs;
+	this->lastFrameBufferNr = slot->bufferNr;
+	this->lastFrameNr = slot->dataFrameNr;
+	if (previousSlot != nullptr) {
+		emit frameSlotReleased(previousSlot);
+	}
+}
+
+void PeakFinder::releaseHeldSlot() {
+	if (this->heldSlot == nullptr) {
+		return;
+	}
+	FrameSlot* slot = this->heldSlot;
+	this->heldSlot = nullptr;
+	emit frameSlotReleased(slot);
+}
+
+bool PeakFinder::analysisChanged(const PeakDetectorParameters& a, const PeakDetectorParameters& b) {
+	//window state, buffer selection and producer settings do not change the result for a frame that is already there
+	return a.feature != b.feature
+		|| a.centroidHalfWidth != b.centroidHalfWidth
+		|| a.multiPeakEnabled != b.multiPeakEnabled
+		|| a.maxPeaks != b.maxPeaks
+		|| a.minPeakDistance != b.minPeakDistance
+		|| a.minPeakProminence != b.minPeakProminence
+		|| a.surfaceTrackingEnabled != b.surfaceTrackingEnabled
+		|| a.trackingEnabled != b.trackingEnabled
+		|| a.trackingWindowHalfWidth != b.trackingWindowHalfWidth
+		|| a.lineFilter != b.lineFilter
+		|| a.lineFilterHalfWidth != b.lineFilterHalfWidth
+		|| a.rowAggregation != b.rowAggregation
+		|| a.trimFraction != b.trimFraction
+		|| a.integralTableEnabled != b.integralTableEnabled
+		|| a.roi != b.roi
+		|| a.roiName != b.roiName
+		|| a.additionalRois != b.additionalRois
+		|| a.minThreshold != b.minThreshold
+		|| a.thresholdMode != b.thresholdMode
+		|| a.noiseFactor != b.noiseFactor;
+}
+
+double PeakFinder::analyzeFrame(const FrameView& frame, bool lastFrame) {
+	//only the additional rois of the last frame of a batch are published, so they are not summed up for the other frames
+	this->calculateAveragedLine(frame, lastFrame);
+	return this->extractFeature();
+}
+
+double PeakFinder::extractFeature() {
+	this->threshold = this->estimateThreshold(this->averagedLine.constData() + this->averagedRoi.x(), this->averagedRoi.width());
+	if (this->params.trackingEnabled) {
+		return this->trackPeak();
+	}
+
+	int maxPosition = this->findMaxValuePosition(this->averagedLine, this->threshold);
+	if (maxPosition < 0) {
 		return -1;
 	}
-	qreal max = line[0];
-	int maxPos = -1;
-	for (int i = 1; i < line.size(); i++) {
-		if (line[i] > threshold && line[i] > max) {
-			max = line[i];
-			maxPos = i;
+
+	return this->refinePeakPosition(maxPosition);
+}
+
+double PeakFinder::estimateThreshold(const qreal* line, int length) {
+	//the noise floor is estimated only from the part of the line that belongs to the roi, the rest of the line is zero
+	if (this->params.thresholdMode != THRESHOLD_ADAPTIVE || length <= 0) {
+		return this->params.minThreshold;
+	}
+	return this->noiseFloorEstimator.estimate(line, length, this->params.noiseFactor);
+}
+
+double PeakFinder::trackPeak() {
+	//while the tracker is locked only a window around the predicted position is searched, bright artifacts outside of it are ignored
+	if (this->peakTracker.isLocked()) {
+		int maxPosition = this->findMaxValuePositionInWindow(this->peakTracker.predict(), this->params.trackingWindowHalfWidth, this->threshold);
+		if (maxPosition >= 0) {
+			double peakPosition = this->refinePeakPosition(maxPosition);
+			this->peakTracker.update(peakPosition);
+			return peakPosition;
+		}
+		this->peakTracker.miss();
+		if (this->peakTracker.isLocked()) {
+			return -1;
 		}
 	}
 
-	return maxPos;
+	//full search to acquire the peak, initially or after the lock was lost
+	int maxPosition = this->findMaxValuePosition(this->averagedLine, this->threshold);
+	if (maxPosition < 0) {
+		return -1;
+	}
+	double peakPosition = this->refinePeakPosition(maxPosition);
+	this->peakTracker.acquire(peakPosition);
+	return peakPosition;
+}
+
+void PeakFinder::publishResults(double peakPosition) {
+	TRACE_SCOPE("PeakFinder::publishResults");
+	emit averagedLineCalculated(this->averagedLine);
+	emit peakPositionFound(peakPosition);
+	if (this->params.thresholdMode == THRESHOLD_ADAPTIVE) {
+		emit thresholdEstimated(this->threshold);
+	}
+	this->publishPeakResult(peakPosition);
+	this->findMultiplePeaks();
+	if (this->params.trackingEnabled) {
+		emit peakTracked(this->peakTracker.isLocked() ? this->peakTracker.getPosition() : -1.0, this->peakTracker.getVelocity(), this->peakTracker.isLocked());
+	}
+	this->publishRoiPeaks();
+}
+
+void PeakFinder::publishPeakResult(double peakPosition) {
+	//frame identification and timestamp were set when the slot was received, a reanalysis uses those of the kept frame
+	this->result.position = peakPosition;
+	this->result.amplitude = this->amplitudeAt(peakPosition);
+	this->result.snr = peakPosition >= 0 ? estimateSnr(this->averagedLine.constData() + this->averagedRoi.x(), this->averagedRoi.width(), this->result.amplitude) : 0;
+	this->result.computeNs = this->computeTimer.isValid() ? this->computeTimer.nsecsElapsed() : 0;
+	this->result.analyzedNs = -1;
+	if (this->latencyMonitor != nullptr && this->analysisStartNs >= 0) {
+		this->result.analyzedNs = this->latencyMonitor->now();
+		this->latencyMonitor->record(STAGE_ANALYSIS, this->analysisStartNs, this->result.analyzedNs);
+	}
+	emit peakResultFound(this->result);
+}
+
+void PeakFinder::publishPeakBatch() {
+	//the batch is emitted as a whole and shares its arrays with the receivers until it is written again
+	PeakBatch& batch = this->batches[this->batchIndex];
+	batch.timestampNs = this->result.timestampNs;
+	batch.bufferNr = this->result.bufferNr;
+	batch.firstFrameNr = this->result.frameNr - batch.frameCount + 1;
+	emit peakBatchFound(batch);
+}
+
+double PeakFinder::amplitudeAt(double peakPosition) const {
+	int maxPosition = qRound(peakPosition);
+	return peakPosition >= 0 && maxPosition < this->averagedLine.size() ? this->averagedLine.at(maxPosition) : 0;
+}
+
+double PeakFinder::estimateSnr(const qreal* line, int length, double amplitude) {
+	//mean and standard deviation of the roi part of the averaged line, the peak itself is included as it is only a few samples
+	if (length < 2) {
+		return 0;
+	}
+	double sum = 0;
+	double squaredSum = 0;
+	for (int i = 0; i < length; ++i) {
+		sum += line[i];
+		squaredSum += line[i]*line[i];
+	}
+	double mean = sum/length;
+	double variance = qMax(0.0, squaredSum/length - mean*mean);
+	return variance > 0 ? (amplitude - mean)/qSqrt(variance) : 0;
+}
+
+void PeakFinder::publishRoiPeaks() {
+	//main roi first, followed by the additional rois, all of them from the same frame
+	QVector<RoiPeak> peaks;
+	peaks.reserve(1 + this->roiPeaks.size());
+	RoiPeak mainPeak;
+	mainPeak.name = this->params.roiName;
+	mainPeak.roi = this->averagedRoi;
+	mainPeak.position = this->result.position;
+	mainPeak.value = this->result.amplitude;
+	peaks.append(mainPeak);
+	peaks += this->roiPeaks;
+	emit roiPeaksFound(peaks);
+}
+
+double PeakFinder::refinePeakPosition(int maxPosition) {
+	return this->refinePeakPosition(this->averagedLine.constData(), this->averagedLine.size(), maxPosition);
+}
+
+double PeakFinder::refinePeakPosition(const qreal* line, int length, int maxPosition) {
+	//refine position of maximum in averaged A-scan based on selected method/feature
+	double peakPosition = maxPosition;
+	switch (this->params.feature) {
+		case MAXVALUE:
+			break;
+		case PARABOLIC_FIT:
+			peakPosition = PeakInterpolation::parabolic(line, length, maxPosition);
+			break;
+		case GAUSSIAN_FIT:
+			peakPosition = PeakInterpolation::gaussian(line, length, maxPosition);
+			break;
+		case CENTROID:
+			peakPosition = PeakInterpolation::centroid(line, length, maxPosition, this->params.centroidHalfWidth);
+			break;
+	}
+
+	return peakPosition;
+}
+
+void PeakFinder::findMultiplePeaks() {
+	if (!this->params.multiPeakEnabled) {
+		return;
+	}
+
+	//only the last line of a batch is searched for multiple peaks, just like only its main peak is published
+	int peakCount = this->multiPeakSearch.findPeaks(this->averagedLine.constData(), this->averagedLine.size(), this->threshold, this->params.maxPeaks, this->params.minPeakDistance, this->params.minPeakProminence);
+	this->detectedPeaks.resize(peakCount);
+	for (int i = 0; i < peakCount; i++) {
+		const DetectedPeak& peak = this->multiPeakSearch.getPeaks().at(i);
+		this->detectedPeaks[i] = QPointF(this->refinePeakPosition(peak.position), peak.height);
+	}
+	emit peaksFound(this->detectedPeaks);
+}
+
+void PeakFinder::findSurfaceProfile(const FrameView& frame, int frameNr) {
+	if (!this->params.surfaceTrackingEnabled) {
+		return;
+	}
+
+	//peak of every line of the roi. Positions of all lines are kept in one buffer that is reused for every frame
+	QRect clampedRoi = this->clampRoi(this->params.roi, frame.samplesPerLine, frame.linesPerFrame).intersected(frame.region);
+	int lines = clampedRoi.width() > 0 ? qMax(0, clampedRoi.height()) : 0;
+	if (this->linePeakPositions.size() < lines) {
+		this->linePeakPositions.resize(lines);
+	}
+	this->surfaceProfile.frameNr = frameNr;
+	this->surfaceProfile.firstLine = clampedRoi.y();
+	this->surfaceProfile.positions.resize(lines);
+	if (lines > 0) {
+		LinePeakSearch::findLinePeaks(frame.data, frame.bitDepth, frame.stride, clampedRoi.translated(-frame.region.x(), -frame.region.y()), this->threshold, this->linePeakPositions.data());
+	}
+	for (int i = 0; i < lines; i++) {
+		int position = this->linePeakPositions.at(i);
+		this->surfaceProfile.positions[i] = position < 0 ? -1.0 : static_cast<double>(clampedRoi.x() + position);
+	}
+	this->surfaceProfile.updateStatistics();
+	emit surfaceProfileFound(this->surfaceProfile);
+}
+
+void PeakFinder::averageColumnSums(const quint64* columnSums, QRect roi, unsigned int samplesPerLine) {
+	this->resetAveragedLine(samplesPerLine);
+	if (roi.width() <= 0 || roi.height() <= 0) {
+		this->averagedRoi = QRect();
+		return;
+	}
+	this->averagedRoi = roi;
+	for (int i = 0; i < roi.width(); ++i) {
+		this->averagedLine[roi.x() + i] = static_cast<qreal>(columnSums[i]) / roi.height();
+	}
+	this->filterAveragedLine(roi);
+}
+
+void PeakFinder::resetAveragedLine(unsigned int samplesPerLine) {
+	if (this->averagedLine.size() != static_cast<int>(samplesPerLine)) {
+		this->averagedLine.resize(samplesPerLine);
+	}
+	this->averagedLine.fill(0);
+}
+
+void PeakFinder::filterAveragedLine(QRect roi) {
+	//only the roi part is filtered, the zeros outside of it would pull down the samples at the roi borders
+	if (this->lineFilter.isActive()) {
+		this->lineFilter.apply(this->averagedLine.data() + roi.x(), roi.width());
+	}
+}
+
+void PeakFinder::updateFrameRate(unsigned int frames) {
+	if (!this->frameRateTimer.isValid()) {
+		this->frameRateTimer.start();
+		this->analyzedFrames = 0;
+		return;
+	}
+
+	//report sustained frame rate about once per second
+	this->analyzedFrames += frames;
+	qint64 elapsed = this->frameRateTimer.nsecsElapsed();
+	if (elapsed >= 1000000000) {
+		emit frameRateMeasured(static_cast<double>(this->analyzedFrames)*1.0e9/static_cast<double>(elapsed));
+		this->analyzedFrames = 0;
+		this->frameRateTimer.restart();
+	}
+}
+
+int PeakFinder::findMaxValuePosition(const QVector<qreal>& line, double threshold) {
+	return MaxSearch::findMaxValuePosition(line.constData(), line.size(), threshold);
+}
+
+int PeakFinder::findMaxValuePositionInWindow(double center, int halfWidth, double threshold) {
+	int begin = qMax(0, qRound(center) - halfWidth);
+	int end = qMin(this->averagedLine.size()-1, qRound(center) + halfWidth);
+	if (end <= begin) {
+		return -1;
+	}
+
+	//like the full search, the maximum has to be larger than the first value of the window, so a peak that left the window on its left side is not confused with the window border
+	int maxPosition = MaxSearch::findMaxValuePosition(this->averagedLine.constData() + begin, end-begin+1, threshold);
+	return maxPosition < 0 ? -1 : begin + maxPosition;
 }
 
 QRect PeakFinder::clampRoi(QRect roi, unsigned int samplesPerLine, unsigned int linesPerFrame) {
@@ -89,52 +642,160 @@ QRect PeakFinder::clampRoi(QRect roi, unsigned int samplesPerLine, unsigned int
 	return clampedRoi;
 }
 
-QVector<qreal> PeakFinder::calculateAveragedLine(void *frameBuffer, unsigned int bitDepth, unsigned int samplesPerLine, unsigned int linesPerFrame) {
-	QVector<qreal> averagedLine;
+void PeakFinder::calculateAveragedLine(const FrameView& frame, bool sweepAllRois) {
+	//only the part of the roi that is available in the view can be used
+	QRect clampedRoi = this->clampRoi(this->params.roi, frame.samplesPerLine, frame.linesPerFrame).intersected(frame.region);
+
+	//the main roi and all additional rois are summed up together in a single sweep over the frame
+	this->additionalRoisSwept = sweepAllRois && !this->params.additionalRois.isEmpty() && this->params.rowAggregation == AGGREGATION_MEAN && !this->params.integralTableEnabled;
+	if (this->additionalRoisSwept) {
+		this->sweepRois(frame, clampedRoi);
+	}
+
+	//if roi is out of the frame clampedRoi(..) will return a QRect with 0 width and 0 height
+	if (clampedRoi.width() <= 0 || clampedRoi.height() <= 0) {
+		this->averageColumnSums(nullptr, QRect(), frame.samplesPerLine);
+		return;
+	}
 
-	if (bitDepth <= 8) {
-		unsigned char* frame = static_cast<unsigned char*>(frameBuffer);
-		averagedLine = this->calculateAveragedLine<unsigned char>(this->params.roi, frame, samplesPerLine, linesPerFrame);
-	} else if (bitDepth > 8 && bitDepth <= 16) {
-		unsigned short* frame = static_cast<unsigned short*>(frameBuffer);
-		averagedLine = this->calculateAveragedLine<unsigned short>(this->params.roi, frame, samplesPerLine, linesPerFrame);
-	} else if (bitDepth > 16 && bitDepth <= 32) {
-		unsigned long* frame = static_cast<unsigned long*>(frameBuffer);
-		averagedLine = this->calculateAveragedLine<unsigned long>(this->params.roi, frame, samplesPerLine, linesPerFrame);
+	//median, trimmed mean and maximum need every sample of a column and can not be derived from column sums
+	QRect frameRoi = clampedRoi.translated(-frame.region.x(), -frame.region.y());
+	if (this->params.rowAggregation != AGGREGATION_MEAN) {
+		this->resetAveragedLine(frame.samplesPerLine);
+		this->averagedRoi = clampedRoi;
+		this->rowAggregator.aggregate(frame.data, frame.bitDepth, frame.stride, frameRoi, this->params.rowAggregation, this->params.trimFraction, this->averagedLine.data() + clampedRoi.x());
+		this->filterAveragedLine(clampedRoi);
+		return;
 	}
 
-	return averagedLine;
+	//sum up roi in integer lanes, the conversion to floating point is done only once per column while averaging.
+	//columnSums is reused for every frame to avoid allocations in the processing loop
+	if (this->columnSums.size() < clampedRoi.width()) {
+		this->columnSums.resize(clampedRoi.width());
+	}
+	//the integral table costs a pass over the whole view, but any other roi of this frame can be read out of it afterwards
+	if (this->params.integralTableEnabled) {
+		this->integralTable.build(frame);
+		this->integralTable.columnSums(clampedRoi, this->columnSums.data());
+	} else if (this->additionalRoisSwept) {
+		this->averageColumnSums(this->multiRoiAccumulator.getColumnSums(0), clampedRoi, frame.samplesPerLine);
+		return;
+	} else {
+		//large rois are split into bands of rows that are reduced in parallel
+		this->integralTable.invalidate();
+		this->parallelAccumulator->accumulate(frame.data, frame.bitDepth, frame.stride, frameRoi, this->columnSums.data());
+	}
+	this->averageColumnSums(this->columnSums.constData(), clampedRoi, frame.samplesPerLine);
 }
 
-template<typename T>
-QVector<qreal> PeakFinder::calculateAveragedLine(QRect roi, T* frame, unsigned int samplesPerLine, unsigned int linesPerFrame) {
-	QVector<qreal> averagedLine(samplesPerLine, 0);
-	QRect clampedRoi = this->clampRoi(roi, samplesPerLine, linesPerFrame);
-	int roiY = clampedRoi.y();
-	int roiHeight = clampedRoi.height();
-	int roiX = clampedRoi.x();
-	int roiWidth = clampedRoi.width();
+bool PeakFinder::reanalyzeIntegralTable() {
+	//roi of the last frame is read out of its integral table without touching the frame again
+	if (this->isFeatureExtracting || !this->params.integralTableEnabled || this->params.rowAggregation != AGGREGATION_MEAN) {
+		return false;
+	}
+	unsigned int samplesPerLine = this->integralTable.getSamplesPerLine();
+	QRect clampedRoi = this->clampRoi(this->params.roi, samplesPerLine, this->integralTable.getLinesPerFrame()).intersected(this->integralTable.getRegion());
+	if (!this->integralTable.covers(clampedRoi)) {
+		return false;
+	}
+	if (this->columnSums.size() < clampedRoi.width()) {
+		this->columnSums.resize(clampedRoi.width());
+	}
+	this->integralTable.columnSums(clampedRoi, this->columnSums.data());
+	this->averageColumnSums(this->columnSums.constData(), clampedRoi, samplesPerLine);
+	double peakPosition = this->extractFeature();
 
-	//if roi is out of the frame clampedRoi(..) will return a QRect with 0 width and 0 height
-	if (roiWidth <= 0 || roiHeight <= 0) {
-		return averagedLine;
+	//additional rois are read out of the same table, a view without data makes sure nothing else is accessed
+	FrameView tableView;
+	tableView.data = nullptr;
+	tableView.samplesPerLine = samplesPerLine;
+	tableView.linesPerFrame = this->integralTable.getLinesPerFrame();
+	tableView.region = this->integralTable.getRegion();
+	this->additionalRoisSwept = false;
+	this->findAdditionalRoiPeaks(tableView);
+	this->publishResults(peakPosition);
+	return true;
+}
+
+void PeakFinder::sweepRois(const FrameView& frame, const QRect& clampedRoi) {
+	//main roi is always the first roi of the sweep, rois outside of the view are kept as empty rois so the indices stay the same
+	int roiCount = 1 + this->params.additionalRois.size();
+	this->sweptRois.resize(roiCount);
+	this->sweptRois[0] = clampedRoi.translated(-frame.region.x(), -frame.region.y());
+	for (int i = 1; i < roiCount; i++) {
+		QRect roi = this->clampRoi(this->params.additionalRois.at(i-1).rect, frame.samplesPerLine, frame.linesPerFrame).intersected(frame.region);
+		this->sweptRois[i] = roi.translated(-frame.region.x(), -frame.region.y());
 	}
+	this->multiRoiAccumulator.accumulate(frame.data, frame.bitDepth, frame.stride, this->sweptRois);
+}
 
-	//loop through ROI and sum up the values
-	int endY = roiY + roiHeight;
-	int endX = roiX + roiWidth;
-	QVector<qreal> sumLine(roiWidth, 0);
+void PeakFinder::findAdditionalRoiPeaks(const FrameView& frame) {
+	int roiCount = this->params.additionalRois.size();
+	this->roiPeaks.resize(roiCount);
+	for (int i = 0; i < roiCount; i++) {
+		const NamedRoi& namedRoi = this->params.additionalRois.at(i);
+		RoiPeak& peak = this->roiPeaks[i];
+		peak.name = namedRoi.name;
+		peak.roi = this->clampRoi(namedRoi.rect, frame.samplesPerLine, frame.linesPerFrame).intersected(frame.region);
+		peak.position = -1;
+		peak.value = 0;
+		if (peak.roi.width() <= 0 || peak.roi.height() <= 0) {
+			continue;
+		}
+		if (this->roiLine.size() < peak.roi.width()) {
+			this->roiLine.resize(peak.roi.width());
+		}
+		if (this->averageAdditionalRoi(frame, i, peak.roi)) {
+			this->findRoiLinePeak(peak);
+		}
+	}
+}
 
-	for (int y = roiY; y < endY; ++y) {
-		for (int x = roiX; x < endX; ++x) {
-			sumLine[x - roiX] += frame[y * samplesPerLine + x];
+bool PeakFinder::averageAdditionalRoi(const FrameView& frame, int index, const QRect& roi) {
+	//line of an additional roi only covers the roi itself and not the whole A-scan
+	qreal* line = this->roiLine.data();
+	QRect frameRoi = roi.translated(-frame.region.x(), -frame.region.y());
+	if (this->params.rowAggregation != AGGREGATION_MEAN) {
+		if (frame.data == nullptr) {
+			return false;
 		}
+		this->rowAggregator.aggregate(frame.data, frame.bitDepth, frame.stride, frameRoi, this->params.rowAggregation, this->params.trimFraction, line);
+		return true;
 	}
 
-	// compute average per column in ROI
-	for (int i = 0; i < roiWidth; ++i) {
-		averagedLine[roiX + i] = sumLine[i] / roiHeight;
+	const quint64* sums = nullptr;
+	if (this->additionalRoisSwept) {
+		sums = this->multiRoiAccumulator.getColumnSums(index+1);
+	} else {
+		if (this->columnSums.size() < roi.width()) {
+			this->columnSums.resize(roi.width());
+		}
+		if (this->integralTable.covers(roi)) {
+			this->integralTable.columnSums(roi, this->columnSums.data());
+		} else if (frame.data != nullptr) {
+			ColumnAccumulator::accumulate(frame.data, frame.bitDepth, frame.stride, frameRoi, this->columnSums.data());
+		} else {
+			return false;
+		}
+		sums = this->columnSums.constData();
+	}
+	for (int x = 0; x < roi.width(); ++x) {
+		line[x] = static_cast<qreal>(sums[x]) / roi.height();
 	}
+	return true;
+}
 
-	return averagedLine;
+void PeakFinder::findRoiLinePeak(RoiPeak& peak) {
+	//same filter, threshold mode and feature as for the main roi, but without tracking. An adaptive threshold is estimated from the line of this roi
+	qreal* line = this->roiLine.data();
+	int length = peak.roi.width();
+	if (this->lineFilter.isActive()) {
+		this->lineFilter.apply(line, length);
+	}
+	int maxPosition = MaxSearch::findMaxValuePosition(line, length, this->estimateThreshold(line, length));
+	if (maxPosition < 0) {
+		return;
+	}
+	peak.value = line[maxPosition];
+	peak.position = peak.roi.x() + this->refinePeakPosition(line, length, maxPosition);
 }
@@ -6,7 +6,32 @@
 #include <QRect>
 #include <QApplication>
 #include <QtMath>
+#include <QElapsedTimer>
+#include <QPointF>
+#include <QTimer>
+#include <QByteArray>
 #include "peakdetectorparameters.h"
+#include "frameringbuffer.h"
+#include "frameview.h"
+#include "parallelaccumulator.h"
+#include "multipeaksearch.h"
+#include "surfaceprofile.h"
+#include "peaktracker.h"
+#include "linefilter.h"
+#include "rowaggregator.h"
+#include "columnintegraltable.h"
+#include "multiroiaccumulator.h"
+#include "roipeak.h"
+#include "peakresult.h"
+#include "peakbatch.h"
+#include "noisefloorestimator.h"
+#include "latencymonitor.h"
+#include "tracerecorder.h"
+
+//changes of roi and parameters within this time are collected and applied to the last frame at once
+#define REANALYSIS_DELAY_MS 20
+//batches are written round robin, so a receiver can keep this many batches before their arrays have to be reallocated
+#define PEAK_BATCH_RING_SIZE 4
 
 
 class PeakFinder : public QObject
@@ -14,28 +39,115 @@ class PeakFinder : public QObject
 	Q_OBJECT
 public:
 	explicit PeakFinder(QObject *parent = nullptr);
+	~PeakFinder();
+
+	static QRect clampRoi(QRect roi, unsigned int samplesPerLine, unsigned int linesPerFrame);
+	void setLatencyMonitor(LatencyMonitor* monitor) {this->latencyMonitor = monitor;}
+	int findPeaksInFrames(const FrameView& firstFrame, unsigned int frameCount, size_t frameStride, double* positions, double* amplitudes, quint8* flags);
 
 private:
 	bool isFeatureExtracting;
 	PeakDetectorParameters params;
+	QVector<qreal> averagedLine;
+	QVector<quint64> columnSums;
+	QElapsedTimer frameRateTimer;
+	quint64 analyzedFrames;
+	ParallelAccumulator* parallelAccumulator;
+	MultiPeakSearch multiPeakSearch;
+	QVector<QPointF> detectedPeaks;
+	SurfaceProfile surfaceProfile;
+	QVector<int> linePeakPositions;
+	PeakTracker peakTracker;
+	LineFilter lineFilter;
+	RowAggregator rowAggregator;
+	ColumnIntegralTable integralTable;
+	MultiRoiAccumulator multiRoiAccumulator;
+	QVector<QRect> sweptRois;
+	bool additionalRoisSwept;
+	QRect averagedRoi;
+	QVector<RoiPeak> roiPeaks;
+	QVector<qreal> roiLine;
+	QTimer* reanalysisTimer;
+	QByteArray lastFrameData;
+	FrameView lastFrame;
+	bool lastFrameValid;
+	FrameSlot* heldSlot;
+	qint64 lastFrameTimestampNs;
+	int lastFrameBufferNr;
+	int lastFrameNr;
+	PeakResult result;
+	QElapsedTimer computeTimer;
+	QVector<PeakBatch> batches;
+	int batchIndex;
+	NoiseFloorEstimator noiseFloorEstimator;
+	double threshold;
+	LatencyMonitor* latencyMonitor;
+	qint64 analysisStartNs;
 
+	double analyzeFrame(const FrameView& frame, bool lastFrame);
+	double extractFeature();
+	double estimateThreshold(const qreal* line, int length);
+	double trackPeak();
+	void publishResults(double peakPosition);
+	double refinePeakPosition(int maxPosition);
+	double refinePeakPosition(const qreal* line, int length, int maxPosition);
+	void findMultiplePeaks();
+	void findSurfaceProfile(const FrameView& frame, int frameNr);
 	int findMaxValuePosition(const QVector<qreal>& line, double threshold);
-	QRect clampRoi(QRect roi, unsigned int samplesPerLine, unsigned int linesPerFrame);
-	QVector<qreal> calculateAveragedLine(void* frameBuffer, unsigned int bitDepth, unsigned int samplesPerLine, unsigned int linesPerFrame);
-	template <typename T> QVector<qreal> calculateAveragedLine(QRect roi, T* frame, unsigned int samplesPerLine, unsigned int linesPerFrame);
+	int findMaxValuePositionInWindow(double center, int halfWidth, double threshold);
+	void averageColumnSums(const quint64* columnSums, QRect roi, unsigned int samplesPerLine);
+	void resetAveragedLine(unsigned int samplesPerLine);
+	void filterAveragedLine(QRect roi);
+	void calculateAveragedLine(const FrameView& frame, bool sweepAllRois);
+	void sweepRois(const FrameView& frame, const QRect& clampedRoi);
+	void findAdditionalRoiPeaks(const FrameView& frame);
+	bool averageAdditionalRoi(const FrameView& frame, int index, const QRect& roi);
+	void findRoiLinePeak(RoiPeak& peak);
+	void publishRoiPeaks();
+	void publishPeakResult(double peakPosition);
+	void publishPeakBatch();
+	PeakBatch& nextPeakBatch(unsigned int frameCount);
+	quint8 peakFlags(double peakPosition) const;
+	double amplitudeAt(double peakPosition) const;
+	static double estimateSnr(const qreal* line, int length, double amplitude);
+	bool reanalyzeIntegralTable();
+	bool analyzeViews(const FrameView& firstFrame, unsigned int frameCount, size_t bytesPerFrame);
+	static FrameView lastFrameOf(const FrameView& firstFrame, unsigned int frameCount, size_t bytesPerFrame);
+	void keepLastFrame(const FrameView& frame);
+	void holdLastFrame(FrameSlot* slot, const FrameView& frame);
+	void releaseHeldSlot();
+	void scheduleReanalysis();
+	static bool analysisChanged(const PeakDetectorParameters& a, const PeakDetectorParameters& b);
+	void updateFrameRate(unsigned int frames);
 
 
 signals:
 	void averagedLineCalculated(QVector<qreal>);
-	void peakPositionFound(int);
+	void peakPositionFound(double);
+	void thresholdEstimated(double);
+	void peakResultFound(PeakResult);
+	void peakBatchFound(PeakBatch);
+	void peaksFound(QVector<QPointF>);
+	void surfaceProfileFound(SurfaceProfile);
+	void roiPeaksFound(QVector<RoiPeak>);
+	void peakTracked(double position, double velocity, bool locked);
+	void frameSlotReleased(FrameSlot*);
+	void frameRateMeasured(double framesPerSecond);
+	void processingTimeMeasured(unsigned int frames, qint64 nsecs);
 	void info(QString);
 	void error(QString);
 
 public slots:
 	void findPeak(void* frameBuffer, unsigned int bitDepth, unsigned int samplesPerLine, unsigned int linesPerFrame);
+	void findPeaks(void* frames, unsigned int bitDepth, unsigned int samplesPerLine, unsigned int linesPerFrame, unsigned int frameCount);
+	void findPeaksInViews(FrameView firstFrame, unsigned int frameCount, size_t bytesPerFrame);
+	void findPeaksInColumnSums(const quint64* columnSums, QRect roi, unsigned int samplesPerLine, unsigned int frameCount);
+	void processFrameSlot(FrameSlot* slot);
 	void setRoi(QRect roi);
 	void setFeature(int featureOption);
 	void setParams(PeakDetectorParameters params);
+	bool reanalyzeLastFrame();
+	void releaseLastFrame();
 };
 
 #endif //PEAKFINDER
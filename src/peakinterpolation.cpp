@@ -0,0 +1,59 @@
+#include "peakinterpolation.h"
+#include <QtMath>
+
+
+double PeakInterpolation::parabolic(const qreal* line, int length, int peakPosition) {
+	if (peakPosition < 1 || peakPosition >= length-1) {
+		return peakPosition;
+	}
+	return peakPosition + vertexOffset(line[peakPosition-1], line[peakPosition], line[peakPosition+1]);
+}
+
+double PeakInterpolation::gaussian(const qreal* line, int length, int peakPosition) {
+	if (peakPosition < 1 || peakPosition >= length-1) {
+		return peakPosition;
+	}
+	double left = line[peakPosition-1];
+	double center = line[peakPosition];
+	double right = line[peakPosition+1];
+	if (left <= 0 || center <= 0 || right <= 0) {
+		return peakPosition;
+	}
+
+	//a gaussian is a parabola in log space, so the parabolic vertex of the logarithms is the center of the gaussian
+	return peakPosition + vertexOffset(qLn(left), qLn(center), qLn(right));
+}
+
+double PeakInterpolation::centroid(const qreal* line, int length, int peakPosition, int halfWidth) {
+	if (peakPosition < 0 || peakPosition >= length) {
+		return peakPosition;
+	}
+	int begin = qMax(0, peakPosition-halfWidth);
+	int end = qMin(length-1, peakPosition+halfWidth);
+
+	//subtract minimum of window, otherwise the background pulls the centroid towards the center of the window
+	double minimum = line[begin];
+	for (int i = begin+1; i <= end; i++) {
+		minimum = qMin(minimum, static_cast<double>(line[i]));
+	}
+	double weightedSum = 0;
+	double sum = 0;
+	for (int i = begin; i <= end; i++) {
+		double weight = line[i] - minimum;
+		weightedSum += weight*i;
+		sum += weight;
+	}
+	if (sum <= 0) {
+		return peakPosition;
+	}
+	return weightedSum/sum;
+}
+
+double PeakInterpolation::vertexOffset(double left, double center, double right) {
+	//vertex of the parabola through (-1, left), (0, center), (1, right). It lies within half a sample of the maximum
+	double curvature = left - 2.0*center + right;
+	if (curvature >= 0) {
+		return 0;
+	}
+	return qBound(-0.5, 0.5*(left-right)/curvature, 0.5);
+}
@@ -0,0 +1,24 @@
+#ifndef PEAKINTERPOLATION_H
+#define PEAKINTERPOLATION_H
+
+#include <QtGlobal>
+
+#define DEFAULT_CENTROID_HALF_WIDTH 3
+#define MAX_CENTROID_HALF_WIDTH 64
+
+
+//Refines the integer position of a maximum in a line to sub-sample precision. All methods only look at the direct
+//neighborhood of the maximum, so the cost per frame is a handful of operations. If a fit is not possible (maximum at the
+//border of the line, flat neighborhood or non-positive values for the gaussian fit) the integer position is returned.
+class PeakInterpolation
+{
+public:
+	static double parabolic(const qreal* line, int length, int peakPosition);
+	static double gaussian(const qreal* line, int length, int peakPosition);
+	static double centroid(const qreal* line, int length, int peakPosition, int halfWidth);
+
+private:
+	static double vertexOffset(double left, double center, double right);
+};
+
+#endif //PEAKINTERPOLATION_H
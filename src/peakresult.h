@@ -0,0 +1,25 @@
+#ifndef PEAKRESULT_H
+#define PEAKRESULT_H
+
+#include <QtGlobal>
+#include <QMetaType>
+
+
+//Result of the last analyzed frame of a batch. It is a plain struct without any heap allocated members, so it can be
+//copied into queued signals cheaply. timestampNs is taken from a monotonic clock when the buffer was received from
+//OCTproZ, -1 if the frame was not received this way. position is -1 if there is no peak above threshold, snr is the
+//distance of the amplitude from the mean of the averaged line within the roi in units of its standard deviation.
+//analyzedNs is the time on the same clock at which the result was ready, -1 if the latency was not measured.
+struct PeakResult {
+	qint64 timestampNs;
+	int bufferNr;
+	int frameNr;
+	double position;
+	double amplitude;
+	double snr;
+	qint64 computeNs;
+	qint64 analyzedNs;
+};
+Q_DECLARE_METATYPE(PeakResult)
+
+#endif //PEAKRESULT_H
@@ -0,0 +1,55 @@
+#include "peaktracker.h"
+
+
+PeakTracker::PeakTracker()
+	: alpha(DEFAULT_TRACKING_ALPHA),
+	beta(DEFAULT_TRACKING_BETA)
+{
+	this->reset();
+}
+
+void PeakTracker::setGains(double alpha, double beta) {
+	//gains outside of (0, 1] make the filter unstable
+	this->alpha = qBound(0.01, alpha, 1.0);
+	this->beta = qBound(0.0, beta, 1.0);
+}
+
+void PeakTracker::acquire(double measuredPosition) {
+	this->position = measuredPosition;
+	this->velocity = 0;
+	this->locked = true;
+	this->misses = 0;
+}
+
+void PeakTracker::update(double measuredPosition) {
+	if (!this->locked) {
+		this->acquire(measuredPosition);
+		return;
+	}
+	double predictedPosition = this->predict();
+	double residual = measuredPosition - predictedPosition;
+	this->position = predictedPosition + this->alpha*residual;
+	this->velocity = this->velocity + this->beta*residual;
+	this->misses = 0;
+}
+
+void PeakTracker::miss() {
+	if (!this->locked) {
+		return;
+	}
+
+	//coast along the prediction until the peak shows up again or too many frames were missed
+	this->position = this->predict();
+	this->misses++;
+	if (this->misses > TRACKING_MAX_MISSES) {
+		this->locked = false;
+		this->velocity = 0;
+	}
+}
+
+void PeakTracker::reset() {
+	this->position = -1;
+	this->velocity = 0;
+	this->locked = false;
+	this->misses = 0;
+}
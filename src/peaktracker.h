@@ -0,0 +1,42 @@
+#ifndef PEAKTRACKER_H
+#define PEAKTRACKER_H
+
+#include <QtGlobal>
+
+#define DEFAULT_TRACKING_WINDOW_HALF_WIDTH 20
+#define DEFAULT_TRACKING_ALPHA 0.5
+#define DEFAULT_TRACKING_BETA 0.1
+#define TRACKING_MAX_MISSES 5
+
+
+//Alpha-beta filter that follows the peak position from frame to frame. Position and velocity (samples per frame) are
+//predicted for the next frame and corrected with the measured position, weighted with alpha and beta. While the tracker
+//is locked only a window around the prediction has to be searched. If no peak is found in the window the prediction is
+//used as position, after more than TRACKING_MAX_MISSES consecutive misses the lock is lost and a full search is needed
+//to acquire the peak again.
+class PeakTracker
+{
+public:
+	PeakTracker();
+
+	void setGains(double alpha, double beta);
+	void acquire(double measuredPosition);
+	void update(double measuredPosition);
+	void miss();
+	void reset();
+
+	double predict() const {return this->position + this->velocity;}
+	double getPosition() const {return this->position;}
+	double getVelocity() const {return this->velocity;}
+	bool isLocked() const {return this->locked;}
+
+private:
+	double alpha;
+	double beta;
+	double position;
+	double velocity;
+	bool locked;
+	int misses;
+};
+
+#endif //PEAKTRACKER_H
@@ -0,0 +1,55 @@
+# Processing part of the extension without any widgets. It is shared by the extension, the unit tests, the benchmarks
+# and the headless harness, so a new source file only has to be added here.
+
+INCLUDEPATH += \
+	$$PWD
+
+SOURCES += \
+	$$PWD/peakfinder.cpp \
+	$$PWD/bitdepthconverter.cpp \
+	$$PWD/frameringbuffer.cpp \
+	$$PWD/decimationscheduler.cpp \
+	$$PWD/columnaccumulator.cpp \
+	$$PWD/cpufeatures.cpp \
+	$$PWD/maxsearch.cpp \
+	$$PWD/parallelaccumulator.cpp \
+	$$PWD/peakinterpolation.cpp \
+	$$PWD/multipeaksearch.cpp \
+	$$PWD/linepeaksearch.cpp \
+	$$PWD/peaktracker.cpp \
+	$$PWD/linefilter.cpp \
+	$$PWD/rowaggregator.cpp \
+	$$PWD/columnintegraltable.cpp \
+	$$PWD/multiroiaccumulator.cpp \
+	$$PWD/noisefloorestimator.cpp \
+	$$PWD/latencyhistogram.cpp \
+	$$PWD/latencymonitor.cpp \
+	$$PWD/tracerecorder.cpp
+
+HEADERS += \
+	$$PWD/peakdetectorparameters.h \
+	$$PWD/peakfinder.h \
+	$$PWD/bitdepthconverter.h \
+	$$PWD/frameringbuffer.h \
+	$$PWD/frameview.h \
+	$$PWD/decimationscheduler.h \
+	$$PWD/columnaccumulator.h \
+	$$PWD/cpufeatures.h \
+	$$PWD/maxsearch.h \
+	$$PWD/parallelaccumulator.h \
+	$$PWD/peakinterpolation.h \
+	$$PWD/multipeaksearch.h \
+	$$PWD/linepeaksearch.h \
+	$$PWD/surfaceprofile.h \
+	$$PWD/peaktracker.h \
+	$$PWD/linefilter.h \
+	$$PWD/rowaggregator.h \
+	$$PWD/columnintegraltable.h \
+	$$PWD/multiroiaccumulator.h \
+	$$PWD/roipeak.h \
+	$$PWD/peakresult.h \
+	$$PWD/peakbatch.h \
+	$$PWD/noisefloorestimator.h \
+	$$PWD/latencyhistogram.h \
+	$$PWD/latencymonitor.h \
+	$$PWD/tracerecorder.h
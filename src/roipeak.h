@@ -0,0 +1,21 @@
+#ifndef ROIPEAK_H
+#define ROIPEAK_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QRect>
+#include <QMetaType>
+
+
+//Peak found in one named ROI. roi is the part of the ROI that was analyzed in frame coordinates, position is -1 if
+//there is no peak above threshold. The peaks of all ROIs of a frame are published together in one QVector<RoiPeak>,
+//so e.g. the positions of a reference and a sample surface always belong to the same frame.
+struct RoiPeak {
+	QString name;
+	QRect roi;
+	double position;
+	qreal value;
+};
+Q_DECLARE_METATYPE(RoiPeak)
+
+#endif //ROIPEAK_H
@@ -0,0 +1,495 @@
+#include "rowaggregator.h"
+#include "columnaccumulator.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef CPUFEATURES_X86
+#include <immintrin.h>
+#endif
+
+#define HISTOGRAM_BINS 256
+
+
+RowAggregator::RowAggregator()
+{
+
+}
+
+void RowAggregator::aggregate(const void* data, unsigned int bitDepth, size_t stride, const QRect& roi, ROW_AGGREGATION mode, double trimFraction, qreal* line) {
+	this->aggregate(data, bitDepth, stride, roi, mode, trimFraction, line, CpuFeatures::getKernel());
+}
+
+void RowAggregator::aggregate(const void* data, unsigned int bitDepth, size_t stride, const QRect& roi, ROW_AGGREGATION mode, double trimFraction, qreal* line, SIMD_KERNEL kernel) {
+	if (roi.width() <= 0 || roi.height() <= 0 || bitDepth > 32) {
+		return;
+	}
+
+	if (mode == AGGREGATION_MAX) {
+		if (bitDepth <= 8) {
+			maxProjection<quint8>(static_cast<const quint8*>(data), stride, roi, line, kernel);
+		} else if (bitDepth <= 16) {
+			maxProjection<quint16>(static_cast<const quint16*>(data), stride, roi, line, kernel);
+		} else {
+			maxProjection<quint32>(static_cast<const quint32*>(data), stride, roi, line, kernel);
+		}
+	} else if (mode == AGGREGATION_MEDIAN || mode == AGGREGATION_TRIMMED_MEAN) {
+		int trimmed = trimmedRows(roi.height(), mode, trimFraction);
+		if (bitDepth <= 8) {
+			this->trimmedMean(static_cast<const quint8*>(data), stride, roi, trimmed, line);
+		} else if (bitDepth <= 16) {
+			this->trimmedMean(static_cast<const quint16*>(data), stride, roi, trimmed, line);
+		} else {
+			this->trimmedMean(static_cast<const quint32*>(data), stride, roi, trimmed, line);
+		}
+	} else {
+		this->mean(data, bitDepth, stride, roi, line, kernel);
+	}
+}
+
+int RowAggregator::trimmedRows(int rows, ROW_AGGREGATION mode, double trimFraction) {
+	//at least one rank has to be left in the middle
+	int maxTrimmed = qMax(0, (rows-1)/2);
+	if (mode == AGGREGATION_MEDIAN) {
+		return maxTrimmed;
+	} else if (mode == AGGREGATION_TRIMMED_MEAN) {
+		return qBound(0, static_cast<int>(trimFraction*rows), maxTrimmed);
+	}
+	return 0;
+}
+
+void RowAggregator::mean(const void* data, unsigned int bitDepth, size_t stride, const QRect& roi, qreal* line, SIMD_KERNEL kernel) {
+	if (this->columnSums.size() < roi.width()) {
+		this->columnSums.resize(roi.width());
+	}
+	ColumnAccumulator::accumulate(data, bitDepth, stride, roi, this->columnSums.data(), kernel);
+	for (int x = 0; x < roi.width(); ++x) {
+		line[x] = static_cast<qreal>(this->columnSums.at(x)) / roi.height();
+	}
+}
+
+void RowAggregator::trimmedMean(const quint8* data, size_t stride, const QRect& roi, int trimmed, qreal* line) {
+	int roiWidth = roi.width();
+	int rows = roi.height();
+	int histogramSize = roiWidth*HISTOGRAM_BINS;
+	if (this->histograms.size() < histogramSize) {
+		this->histograms.resize(histogramSize);
+	}
+	quint32* histograms = this->histograms.data();
+	memset(histograms, 0, static_cast<size_t>(histogramSize)*sizeof(quint32));
+
+	//histograms of all columns are filled row by row, so the frame is read only once and in memory order
+	int endY = roi.y() + rows;
+	for (int y = roi.y(); y < endY; ++y) {
+		const quint8* row = data + static_cast<size_t>(y)*stride + roi.x();
+		for (int x = 0; x < roiWidth; ++x) {
+			histograms[x*HISTOGRAM_BINS + row[x]]++;
+		}
+	}
+
+	//sum up the part of every bin that lies within the ranks [trimmed, rows-trimmed)
+	int begin = trimmed;
+	int end = rows - trimmed;
+	for (int x = 0; x < roiWidth; ++x) {
+		const quint32* histogram = histograms + x*HISTOGRAM_BINS;
+		quint64 sum = 0;
+		int rank = 0;
+		for (int value = 0; value < HISTOGRAM_BINS && rank < end; ++value) {
+			int count = static_cast<int>(histogram[value]);
+			int overlap = qMin(rank + count, end) - qMax(rank, begin);
+			if (overlap > 0) {
+				sum += static_cast<quint64>(overlap)*value;
+			}
+			rank += count;
+		}
+		line[x] = static_cast<qreal>(sum) / (end - begin);
+	}
+}
+
+void RowAggregator::trimmedMean(const quint16* data, size_t stride, const QRect& roi, int trimmed, qreal* line) {
+	int roiWidth = roi.width();
+	int rows = roi.height();
+	int histogramSize = roiWidth*HISTOGRAM_BINS;
+	if (this->histograms.size() < histogramSize) {
+		this->histograms.resize(histogramSize);
+	}
+	if (this->fineHistograms.size() < 2*histogramSize) {
+		this->fineHistograms.resize(2*histogramSize);
+	}
+	if (this->lowValues.size() < roiWidth) {
+		this->lowValues.resize(roiWidth);
+		this->highValues.resize(roiWidth);
+		this->lowRanks.resize(roiWidth);
+		this->highRanks.resize(roiWidth);
+	}
+	quint32* histograms = this->histograms.data();
+	quint32* lowHistograms = this->fineHistograms.data();
+	quint32* highHistograms = lowHistograms + histogramSize;
+	quint32* lowValues = this->lowValues.data();
+	quint32* highValues = this->highValues.data();
+	memset(histograms, 0, static_cast<size_t>(histogramSize)*sizeof(quint32));
+	memset(lowHistograms, 0, static_cast<size_t>(2*histogramSize)*sizeof(quint32));
+	int endY = roi.y() + rows;
+
+	//first pass: histogram of the high bytes gives the bins of the lowest and highest rank that is kept
+	for (int y = roi.y(); y < endY; ++y) {
+		const quint16* row = data + static_cast<size_t>(y)*stride + roi.x();
+		for (int x = 0; x < roiWidth; ++x) {
+			histograms[x*HISTOGRAM_BINS + (row[x] >> 8)]++;
+		}
+	}
+	for (int x = 0; x < roiWidth; ++x) {
+		lowValues[x] = static_cast<quint32>(selectBin(histograms + x*HISTOGRAM_BINS, trimmed, &this->lowRanks[x]));
+		highValues[x] = static_cast<quint32>(selectBin(histograms + x*HISTOGRAM_BINS, rows-1-trimmed, &this->highRanks[x]));
+	}
+
+	//second pass: histograms of the low bytes of the samples in these two bins give the exact values
+	for (int y = roi.y(); y < endY; ++y) {
+		const quint16* row = data + static_cast<size_t>(y)*stride + roi.x();
+		for (int x = 0; x < roiWidth; ++x) {
+			quint32 highByte = row[x] >> 8;
+			if (highByte == lowValues[x]) {
+				lowHistograms[x*HISTOGRAM_BINS + (row[x] & 0xFF)]++;
+			}
+			if (highByte == highValues[x]) {
+				highHistograms[x*HISTOGRAM_BINS + (row[x] & 0xFF)]++;
+			}
+		}
+	}
+	for (int x = 0; x < roiWidth; ++x) {
+		int unused = 0;
+		lowValues[x] = (lowValues[x] << 8) | static_cast<quint32>(selectBin(lowHistograms + x*HISTOGRAM_BINS, this->lowRanks.at(x), &unused));
+		highValues[x] = (highValues[x] << 8) | static_cast<quint32>(selectBin(highHistograms + x*HISTOGRAM_BINS, this->highRanks.at(x), &unused));
+	}
+
+	//third pass is only needed if more than the two middle ranks are averaged
+	bool innerValuesNeeded = rows - 2*trimmed > 2;
+	if (innerValuesNeeded) {
+		this->countInnerValues(data, stride, roi);
+	}
+	for (int x = 0; x < roiWidth; ++x) {
+		if (innerValuesNeeded) {
+			line[x] = averageRanks(this->innerSums.at(x), this->innerCounts.at(x), this->lowerOrEqualCounts.at(x), lowValues[x], highValues[x], rows, trimmed);
+		} else {
+			line[x] = (static_cast<qreal>(lowValues[x]) + highValues[x]) / 2.0;
+		}
+	}
+}
+
+void RowAggregator::trimmedMean(const quint32* data, size_t stride, const QRect& roi, int trimmed, qreal* line) {
+	int rows = roi.height();
+	if (this->columnBuffer.size() < rows) {
+		this->columnBuffer.resize(rows);
+	}
+	quint32* column = this->columnBuffer.data();
+
+	//after partitioning around both kept border ranks the kept ranks are exactly the elements in between
+	int low = trimmed;
+	int high = rows-1-trimmed;
+	for (int x = 0; x < roi.width(); ++x) {
+		const quint32* sample = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		for (int y = 0; y < rows; ++y) {
+			column[y] = sample[static_cast<size_t>(y)*stride];
+		}
+		std::nth_element(column, column + low, column + rows);
+		if (high > low) {
+			std::nth_element(column + low + 1, column + high, column + rows);
+		}
+		quint64 sum = 0;
+		for (int i = low; i <= high; ++i) {
+			sum += column[i];
+		}
+		line[x] = static_cast<qreal>(sum) / (high - low + 1);
+	}
+}
+
+template<typename T>
+void RowAggregator::countInnerValues(const T* data, size_t stride, const QRect& roi) {
+	int roiWidth = roi.width();
+	this->lowerOrEqualCounts.fill(0, roiWidth);
+	this->innerCounts.fill(0, roiWidth);
+	this->innerSums.fill(0, roiWidth);
+	quint32* lowerOrEqualCounts = this->lowerOrEqualCounts.data();
+	quint32* innerCounts = this->innerCounts.data();
+	quint64* innerSums = this->innerSums.data();
+	const quint32* lowValues = this->lowValues.constData();
+	const quint32* highValues = this->highValues.constData();
+
+	int endY = roi.y() + roi.height();
+	for (int y = roi.y(); y < endY; ++y) {
+		const T* row = data + static_cast<size_t>(y)*stride + roi.x();
+		for (int x = 0; x < roiWidth; ++x) {
+			quint32 value = row[x];
+			if (value <= lowValues[x]) {
+				lowerOrEqualCounts[x]++;
+			} else if (value < highValues[x]) {
+				innerCounts[x]++;
+				innerSums[x] += value;
+			}
+		}
+	}
+}
+
+int RowAggregator::selectBin(const quint32* histogram, int rank, int* remainingRank) {
+	for (int bin = 0; bin < HISTOGRAM_BINS; ++bin) {
+		int count = static_cast<int>(histogram[bin]);
+		if (rank < count) {
+			*remainingRank = rank;
+			return bin;
+		}
+		rank -= count;
+	}
+	*remainingRank = 0;
+	return HISTOGRAM_BINS-1;
+}
+
+qreal RowAggregator::averageRanks(quint64 innerSum, quint32 innerCount, quint32 lowerOrEqualCount, quint32 low, quint32 high, int rows, int trimmed) {
+	//ranks [trimmed, rows-trimmed) consist of some samples equal to low, all samples between low and high and the rest equal to high
+	int keptRanks = rows - 2*trimmed;
+	if (low == high) {
+		return low;
+	}
+	quint64 lowCount = lowerOrEqualCount - static_cast<quint32>(trimmed);
+	quint64 highCount = static_cast<quint64>(keptRanks) - innerCount - lowCount;
+	return static_cast<qreal>(innerSum + lowCount*low + highCount*high) / keptRanks;
+}
+
+template<typename T>
+void RowAggregator::maxProjection(const T* data, size_t stride, const QRect& roi, qreal* line, SIMD_KERNEL kernel) {
+	//vector kernels process as many full strips of columns as possible, the remaining columns are handled by the scalar loop
+	int processedColumns = 0;
+#ifdef CPUFEATURES_X86
+	if (kernel == KERNEL_AVX512) {
+		processedColumns = maxProjectionAvx512(data, stride, roi, line);
+	} else if (kernel == KERNEL_AVX2) {
+		processedColumns = maxProjectionAvx2(data, stride, roi, line);
+	} else if (kernel == KERNEL_SSE2) {
+		processedColumns = maxProjectionSse2(data, stride, roi, line);
+	}
+#else
+	Q_UNUSED(kernel)
+#endif
+	if (processedColumns < roi.width()) {
+		QRect remainingRoi(roi.x() + processedColumns, roi.y(), roi.width() - processedColumns, roi.height());
+		maxProjectionScalar<T>(data, stride, remainingRoi, line + processedColumns);
+	}
+}
+
+template<typename T>
+void RowAggregator::maxProjectionScalar(const T* data, size_t stride, const QRect& roi, qreal* line) {
+	int roiWidth = roi.width();
+	int endY = roi.y() + roi.height();
+	for (int x = 0; x < roiWidth; ++x) {
+		line[x] = 0;
+	}
+	for (int y = roi.y(); y < endY; ++y) {
+		const T* row = data + static_cast<size_t>(y)*stride + roi.x();
+		for (int x = 0; x < roiWidth; ++x) {
+			line[x] = qMax(line[x], static_cast<qreal>(row[x]));
+		}
+	}
+}
+
+#ifdef CPUFEATURES_X86
+//Like the column accumulator the vector kernels walk down strips of 64 bytes (two cache lines for avx-512) and keep the
+//maxima of the strip in registers. Sse2 lacks unsigned 16-bit and 32-bit max, there the sign bit is flipped and the
+//signed max or compare is used instead.
+
+TARGET_SSE2 int RowAggregator::maxProjectionSse2(const quint8* data, size_t stride, const QRect& roi, qreal* line) {
+	int x = 0;
+	for (; x + 64 <= roi.width(); x += 64) {
+		const quint8* strip = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		__m128i maxValues[4];
+		for (int i = 0; i < 4; i++) {
+			maxValues[i] = _mm_setzero_si128();
+		}
+		for (int y = 0; y < roi.height(); ++y) {
+			const __m128i* row = reinterpret_cast<const __m128i*>(strip + static_cast<size_t>(y)*stride);
+			for (int i = 0; i < 4; i++) {
+				maxValues[i] = _mm_max_epu8(maxValues[i], _mm_loadu_si128(row + i));
+			}
+		}
+		alignas(16) quint8 lanes[64];
+		for (int i = 0; i < 4; i++) {
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanes) + i, maxValues[i]);
+		}
+		for (int i = 0; i < 64; i++) {
+			line[x + i] = lanes[i];
+		}
+	}
+	return x;
+}
+
+TARGET_SSE2 int RowAggregator::maxProjectionSse2(const quint16* data, size_t stride, const QRect& roi, qreal* line) {
+	const __m128i signBit = _mm_set1_epi16(static_cast<short>(0x8000));
+	int x = 0;
+	for (; x + 32 <= roi.width(); x += 32) {
+		const quint16* strip = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		__m128i maxValues[4];
+		for (int i = 0; i < 4; i++) {
+			maxValues[i] = signBit;
+		}
+		for (int y = 0; y < roi.height(); ++y) {
+			const __m128i* row = reinterpret_cast<const __m128i*>(strip + static_cast<size_t>(y)*stride);
+			for (int i = 0; i < 4; i++) {
+				maxValues[i] = _mm_max_epi16(maxValues[i], _mm_xor_si128(_mm_loadu_si128(row + i), signBit));
+			}
+		}
+		alignas(16) quint16 lanes[32];
+		for (int i = 0; i < 4; i++) {
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanes) + i, _mm_xor_si128(maxValues[i], signBit));
+		}
+		for (int i = 0; i < 32; i++) {
+			line[x + i] = lanes[i];
+		}
+	}
+	return x;
+}
+
+TARGET_SSE2 int RowAggregator::maxProjectionSse2(const quint32* data, size_t stride, const QRect& roi, qreal* line) {
+	const __m128i signBit = _mm_set1_epi32(static_cast<int>(0x80000000));
+	int x = 0;
+	for (; x + 16 <= roi.width(); x += 16) {
+		const quint32* strip = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		__m128i maxValues[4];
+		for (int i = 0; i < 4; i++) {
+			maxValues[i] = signBit;
+		}
+		for (int y = 0; y < roi.height(); ++y) {
+			const __m128i* row = reinterpret_cast<const __m128i*>(strip + static_cast<size_t>(y)*stride);
+			for (int i = 0; i < 4; i++) {
+				__m128i samples = _mm_xor_si128(_mm_loadu_si128(row + i), signBit);
+				__m128i greater = _mm_cmpgt_epi32(samples, maxValues[i]);
+				maxValues[i] = _mm_or_si128(_mm_and_si128(greater, samples), _mm_andnot_si128(greater, maxValues[i]));
+			}
+		}
+		alignas(16) quint32 lanes[16];
+		for (int i = 0; i < 4; i++) {
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanes) + i, _mm_xor_si128(maxValues[i], signBit));
+		}
+		for (int i = 0; i < 16; i++) {
+			line[x + i] = lanes[i];
+		}
+	}
+	return x;
+}
+
+TARGET_AVX2 int RowAggregator::maxProjectionAvx2(const quint8* data, size_t stride, const QRect& roi, qreal* line) {
+	int x = 0;
+	for (; x + 64 <= roi.width(); x += 64) {
+		const quint8* strip = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		__m256i maxValues[2] = {_mm256_setzero_si256(), _mm256_setzero_si256()};
+		for (int y = 0; y < roi.height(); ++y) {
+			const __m256i* row = reinterpret_cast<const __m256i*>(strip + static_cast<size_t>(y)*stride);
+			maxValues[0] = _mm256_max_epu8(maxValues[0], _mm256_loadu_si256(row));
+			maxValues[1] = _mm256_max_epu8(maxValues[1], _mm256_loadu_si256(row + 1));
+		}
+		alignas(32) quint8 lanes[64];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), maxValues[0]);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes) + 1, maxValues[1]);
+		for (int i = 0; i < 64; i++) {
+			line[x + i] = lanes[i];
+		}
+	}
+	return x;
+}
+
+TARGET_AVX2 int RowAggregator::maxProjectionAvx2(const quint16* data, size_t stride, const QRect& roi, qreal* line) {
+	int x = 0;
+	for (; x + 32 <= roi.width(); x += 32) {
+		const quint16* strip = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		__m256i maxValues[2] = {_mm256_setzero_si256(), _mm256_setzero_si256()};
+		for (int y = 0; y < roi.height(); ++y) {
+			const __m256i* row = reinterpret_cast<const __m256i*>(strip + static_cast<size_t>(y)*stride);
+			maxValues[0] = _mm256_max_epu16(maxValues[0], _mm256_loadu_si256(row));
+			maxValues[1] = _mm256_max_epu16(maxValues[1], _mm256_loadu_si256(row + 1));
+		}
+		alignas(32) quint16 lanes[32];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), maxValues[0]);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes) + 1, maxValues[1]);
+		for (int i = 0; i < 32; i++) {
+			line[x + i] = lanes[i];
+		}
+	}
+	return x;
+}
+
+TARGET_AVX2 int RowAggregator::maxProjectionAvx2(const quint32* data, size_t stride, const QRect& roi, qreal* line) {
+	int x = 0;
+	for (; x + 16 <= roi.width(); x += 16) {
+		const quint32* strip = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		__m256i maxValues[2] = {_mm256_setzero_si256(), _mm256_setzero_si256()};
+		for (int y = 0; y < roi.height(); ++y) {
+			const __m256i* row = reinterpret_cast<const __m256i*>(strip + static_cast<size_t>(y)*stride);
+			maxValues[0] = _mm256_max_epu32(maxValues[0], _mm256_loadu_si256(row));
+			maxValues[1] = _mm256_max_epu32(maxValues[1], _mm256_loadu_si256(row + 1));
+		}
+		alignas(32) quint32 lanes[16];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), maxValues[0]);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes) + 1, maxValues[1]);
+		for (int i = 0; i < 16; i++) {
+			line[x + i] = lanes[i];
+		}
+	}
+	return x;
+}
+
+TARGET_AVX512 int RowAggregator::maxProjectionAvx512(const quint8* data, size_t stride, const QRect& roi, qreal* line) {
+	int x = 0;
+	for (; x + 128 <= roi.width(); x += 128) {
+		const quint8* strip = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		__m512i maxValues[2] = {_mm512_setzero_si512(), _mm512_setzero_si512()};
+		for (int y = 0; y < roi.height(); ++y) {
+			const quint8* row = strip + static_cast<size_t>(y)*stride;
+			maxValues[0] = _mm512_max_epu8(maxValues[0], _mm512_loadu_si512(row));
+			maxValues[1] = _mm512_max_epu8(maxValues[1], _mm512_loadu_si512(row + 64));
+		}
+		alignas(64) quint8 lanes[128];
+		_mm512_store_si512(lanes, maxValues[0]);
+		_mm512_store_si512(lanes + 64, maxValues[1]);
+		for (int i = 0; i < 128; i++) {
+			line[x + i] = lanes[i];
+		}
+	}
+	return x;
+}
+
+TARGET_AVX512 int RowAggregator::maxProjectionAvx512(const quint16* data, size_t stride, const QRect& roi, qreal* line) {
+	int x = 0;
+	for (; x + 64 <= roi.width(); x += 64) {
+		const quint16* strip = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		__m512i maxValues[2] = {_mm512_setzero_si512(), _mm512_setzero_si512()};
+		for (int y = 0; y < roi.height(); ++y) {
+			const quint16* row = strip + static_cast<size_t>(y)*stride;
+			maxValues[0] = _mm512_max_epu16(maxValues[0], _mm512_loadu_si512(row));
+			maxValues[1] = _mm512_max_epu16(maxValues[1], _mm512_loadu_si512(row + 32));
+		}
+		alignas(64) quint16 lanes[64];
+		_mm512_store_si512(lanes, maxValues[0]);
+		_mm512_store_si512(lanes + 32, maxValues[1]);
+		for (int i = 0; i < 64; i++) {
+			line[x + i] = lanes[i];
+		}
+	}
+	return x;
+}
+
+TARGET_AVX512 int RowAggregator::maxProjectionAvx512(const quint32* data, size_t stride, const QRect& roi, qreal* line) {
+	int x = 0;
+	for (; x + 32 <= roi.width(); x += 32) {
+		const quint32* strip = data + static_cast<size_t>(roi.y())*stride + roi.x() + x;
+		__m512i maxValues[2] = {_mm512_setzero_si512(), _mm512_setzero_si512()};
+		for (int y = 0; y < roi.height(); ++y) {
+			const quint32* row = strip + static_cast<size_t>(y)*stride;
+			maxValues[0] = _mm512_max_epu32(maxValues[0], _mm512_loadu_si512(row));
+			maxValues[1] = _mm512_max_epu32(maxValues[1], _mm512_loadu_si512(row + 16));
+		}
+		alignas(64) quint32 lanes[32];
+		_mm512_store_si512(lanes, maxValues[0]);
+		_mm512_store_si512(lanes + 16, maxValues[1]);
+		for (int i = 0; i < 32; i++) {
+			line[x + i] = lanes[i];
+		}
+	}
+	return x;
+}
+#endif
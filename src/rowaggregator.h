@@ -0,0 +1,65 @@
+#ifndef ROWAGGREGATOR_H
+#define ROWAGGREGATOR_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QRect>
+#include "cpufeatures.h"
+#include "peakdetectorparameters.h"
+
+#define DEFAULT_TRIM_FRACTION 0.1
+#define MAX_TRIM_FRACTION 0.5
+
+
+//Reduces the rows of a ROI column by column to a single line with a robust alternative to the mean. The roi is given
+//relative to data and consecutive lines are stride samples apart, like for ColumnAccumulator.
+//Median and trimmed mean both average the ranks [k, n-k) of every column, the median is the special case k = (n-1)/2.
+//The ranks are found with a counting histogram per column for 8-bit data and with a two level radix histogram (high
+//byte, then low byte of the selected bin) for 16-bit data, so no column has to be sorted. 32-bit samples are gathered
+//per column and partitioned with nth_element. The maximum projection is vectorized like the column accumulation.
+class RowAggregator
+{
+public:
+	RowAggregator();
+
+	void aggregate(const void* data, unsigned int bitDepth, size_t stride, const QRect& roi, ROW_AGGREGATION mode, double trimFraction, qreal* line);
+	void aggregate(const void* data, unsigned int bitDepth, size_t stride, const QRect& roi, ROW_AGGREGATION mode, double trimFraction, qreal* line, SIMD_KERNEL kernel);
+	static int trimmedRows(int rows, ROW_AGGREGATION mode, double trimFraction);
+
+private:
+	QVector<quint64> columnSums;
+	QVector<quint32> histograms;
+	QVector<quint32> fineHistograms;
+	QVector<quint32> lowValues;
+	QVector<quint32> highValues;
+	QVector<int> lowRanks;
+	QVector<int> highRanks;
+	QVector<quint32> lowerOrEqualCounts;
+	QVector<quint32> innerCounts;
+	QVector<quint64> innerSums;
+	QVector<quint32> columnBuffer;
+
+	void mean(const void* data, unsigned int bitDepth, size_t stride, const QRect& roi, qreal* line, SIMD_KERNEL kernel);
+	void trimmedMean(const quint8* data, size_t stride, const QRect& roi, int trimmed, qreal* line);
+	void trimmedMean(const quint16* data, size_t stride, const QRect& roi, int trimmed, qreal* line);
+	void trimmedMean(const quint32* data, size_t stride, const QRect& roi, int trimmed, qreal* line);
+	template <typename T> void countInnerValues(const T* data, size_t stride, const QRect& roi);
+	static int selectBin(const quint32* histogram, int rank, int* remainingRank);
+	static qreal averageRanks(quint64 innerSum, quint32 innerCount, quint32 lowerOrEqualCount, quint32 low, quint32 high, int rows, int trimmed);
+
+	template <typename T> static void maxProjection(const T* data, size_t stride, const QRect& roi, qreal* line, SIMD_KERNEL kernel);
+	template <typename T> static void maxProjectionScalar(const T* data, size_t stride, const QRect& roi, qreal* line);
+#ifdef CPUFEATURES_X86
+	static int maxProjectionSse2(const quint8* data, size_t stride, const QRect& roi, qreal* line);
+	static int maxProjectionSse2(const quint16* data, size_t stride, const QRect& roi, qreal* line);
+	static int maxProjectionSse2(const quint32* data, size_t stride, const QRect& roi, qreal* line);
+	static int maxProjectionAvx2(const quint8* data, size_t stride, const QRect& roi, qreal* line);
+	static int maxProjectionAvx2(const quint16* data, size_t stride, const QRect& roi, qreal* line);
+	static int maxProjectionAvx2(const quint32* data, size_t stride, const QRect& roi, qreal* line);
+	static int maxProjectionAvx512(const quint8* data, size_t stride, const QRect& roi, qreal* line);
+	static int maxProjectionAvx512(const quint16* data, size_t stride, const QRect& roi, qreal* line);
+	static int maxProjectionAvx512(const quint32* data, size_t stride, const QRect& roi, qreal* line);
+#endif
+};
+
+#endif //ROWAGGREGATOR_H
@@ -0,0 +1,65 @@
+#ifndef SURFACEPROFILE_H
+#define SURFACEPROFILE_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QMetaType>
+#include <QtMath>
+
+
+//Peak position of every line (A-scan) of a ROI in frame coordinates, -1 for lines without a peak above threshold.
+//The statistics are calculated over all lines with a peak: slope is the change of the peak position per line of a
+//straight line fitted to the positions, rms is the root mean square deviation from that line, so a tilted but flat
+//surface has a rms of zero. frameNr is the frame within the buffer the profile was found in.
+struct SurfaceProfile {
+	int frameNr;
+	int firstLine;
+	QVector<double> positions;
+	int validLines;
+	double mean;
+	double slope;
+	double rms;
+
+	void updateStatistics() {
+		this->validLines = 0;
+		this->mean = 0;
+		this->slope = 0;
+		this->rms = 0;
+		double sumLines = 0;
+		double sumPositions = 0;
+		for (int i = 0; i < this->positions.size(); i++) {
+			if (this->positions.at(i) >= 0) {
+				sumLines += i;
+				sumPositions += this->positions.at(i);
+				this->validLines++;
+			}
+		}
+		if (this->validLines == 0) {
+			return;
+		}
+		double meanLine = sumLines/this->validLines;
+		this->mean = sumPositions/this->validLines;
+
+		//least squares fit of position over line index
+		double covariance = 0;
+		double variance = 0;
+		for (int i = 0; i < this->positions.size(); i++) {
+			if (this->positions.at(i) >= 0) {
+				covariance += (i-meanLine)*(this->positions.at(i)-this->mean);
+				variance += (i-meanLine)*(i-meanLine);
+			}
+		}
+		this->slope = variance > 0 ? covariance/variance : 0;
+		double squaredResiduals = 0;
+		for (int i = 0; i < this->positions.size(); i++) {
+			if (this->positions.at(i) >= 0) {
+				double residual = this->positions.at(i) - (this->mean + this->slope*(i-meanLine));
+				squaredResiduals += residual*residual;
+			}
+		}
+		this->rms = qSqrt(squaredResiduals/this->validLines);
+	}
+};
+Q_DECLARE_METATYPE(SurfaceProfile)
+
+#endif //SURFACEPROFILE_H
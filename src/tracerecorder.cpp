@@ -0,0 +1,160 @@
+#include "tracerecorder.h"
+#include <QThread>
+#include <QFile>
+
+
+QAtomicInt TraceRecorder::enabled(0);
+QAtomicInt TraceRecorder::generation(0);
+TraceThreadBuffer* TraceRecorder::buffers = nullptr;
+QElapsedTimer TraceRecorder::clock;
+
+//ring claimed by the current thread, it is handed back when the thread finishes so pool threads that come and go do
+//not use up all rings
+struct TraceRingClaim {
+	TraceThreadBuffer* buffer = nullptr;
+	bool exhausted = false;
+	~TraceRingClaim() {
+		if (this->buffer != nullptr) {
+			this->buffer->claimed.storeRelease(0);
+		}
+	}
+};
+static thread_local TraceRingClaim ringClaim;
+
+void TraceRecorder::setEnabled(bool enable) {
+	if (!enable) {
+		enabled.storeRelease(0);
+		return;
+	}
+	if (enabled.loadAcquire() != 0) {
+		return;
+	}
+
+	//rings are never freed, a thread that is still recording after tracing was disabled can not write into released memory
+	if (buffers == nullptr) {
+		buffers = new TraceThreadBuffer[TRACE_MAX_THREADS];
+		for (int i = 0; i < TRACE_MAX_THREADS; ++i) {
+			buffers[i].claimed.storeRelease(0);
+			buffers[i].threadId = 0;
+			buffers[i].generation.storeRelease(-1);
+			buffers[i].firstEvent.storeRelease(0);
+			buffers[i].writtenEvents.storeRelease(0);
+		}
+	}
+	generation.fetchAndAddOrdered(1);
+	if (!clock.isValid()) {
+		clock.start();
+	}
+	enabled.storeRelease(1);
+}
+
+int TraceRecorder::getThreadCount() {
+	int threads = 0;
+	for (int i = 0; buffers != nullptr && i < TRACE_MAX_THREADS; ++i) {
+		if (isCurrent(buffers[i])) {
+			threads++;
+		}
+	}
+	return threads;
+}
+
+quint64 TraceRecorder::getEventCount() {
+	quint64 count = 0;
+	for (int i = 0; buffers != nullptr && i < TRACE_MAX_THREADS; ++i) {
+		if (isCurrent(buffers[i])) {
+			quint64 written = buffers[i].writtenEvents.loadAcquire();
+			count += written - firstExportedEvent(buffers[i], written);
+		}
+	}
+	return count;
+}
+
+quint64 TraceRecorder::firstExportedEvent(const TraceThreadBuffer& buffer, quint64 written) {
+	//a full ring only holds the latest events of the session
+	quint64 first = qMin(buffer.firstEvent.loadAcquire(), written);
+	return qMax(first, written - qMin(written, static_cast<quint64>(TRACE_EVENTS_PER_THREAD)));
+}
+
+void TraceRecorder::record(const char* name, TRACE_PHASE phase) {
+	if (!isEnabled()) {
+		return;
+	}
+	TraceThreadBuffer* buffer = threadBuffer();
+	if (buffer == nullptr) {
+		return;
+	}
+	quint64 written = buffer->writtenEvents.loadAcquire();
+	TraceEvent& event = buffer->events[written % TRACE_EVENTS_PER_THREAD];
+	event.name = name;
+	event.timestampNs = clock.nsecsElapsed();
+	event.phase = phase;
+	buffer->writtenEvents.storeRelease(written + 1);
+}
+
+TraceThreadBuffer* TraceRecorder::threadBuffer() {
+	//a thread claims a free ring with its first event. Threads beyond TRACE_MAX_THREADS are not traced
+	TraceRingClaim& claim = ringClaim;
+	if (claim.buffer == nullptr) {
+		if (claim.exhausted) {
+			return nullptr;
+		}
+		//rings of finished threads that still hold events of the current session are only reused if no other ring is free
+		for (int pass = 0; pass < 2 && claim.buffer == nullptr; ++pass) {
+			for (int i = 0; i < TRACE_MAX_THREADS && claim.buffer == nullptr; ++i) {
+				if ((pass > 0 || !isCurrent(buffers[i])) && buffers[i].claimed.testAndSetOrdered(0, 1)) {
+					claim.buffer = &buffers[i];
+					claim.buffer->generation.storeRelease(-1);
+					claim.buffer->threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+				}
+			}
+		}
+		if (claim.buffer == nullptr) {
+			claim.exhausted = true;
+			return nullptr;
+		}
+	}
+
+	//first event of a new session, the events of earlier ones are skipped instead of resetting the ring
+	TraceThreadBuffer* buffer = claim.buffer;
+	int currentGeneration = generation.loadAcquire();
+	if (buffer->generation.loadAcquire() != currentGeneration) {
+		buffer->firstEvent.storeRelease(buffer->writtenEvents.loadAcquire());
+		buffer->generation.storeRelease(currentGeneration);
+	}
+	return buffer;
+}
+
+void TraceRecorder::writeChromeTrace(QTextStream& stream) {
+	//timestamps of the trace event format are in microseconds, the ring index of a thread is used as its id
+	stream << "{\"traceEvents\":[";
+	bool first = true;
+	for (int i = 0; buffers != nullptr && i < TRACE_MAX_THREADS; ++i) {
+		const TraceThreadBuffer& buffer = buffers[i];
+		if (!isCurrent(buffer)) {
+			continue;
+		}
+		quint64 written = buffer.writtenEvents.loadAcquire();
+		quint64 firstEvent = firstExportedEvent(buffer, written);
+		stream << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i
+			<< ",\"args\":{\"name\":\"Thread 0x" << QString::number(static_cast<qulonglong>(buffer.threadId), 16) << "\"}}";
+		first = false;
+		for (quint64 j = firstEvent; j < written; ++j) {
+			const TraceEvent& event = buffer.events[j % TRACE_EVENTS_PER_THREAD];
+			stream << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"" << (event.phase == TRACE_BEGIN ? "B" : "E")
+				<< "\",\"ts\":" << QString::number(static_cast<double>(event.timestampNs)/1000.0, 'f', 3)
+				<< ",\"pid\":1,\"tid\":" << i << "}";
+		}
+	}
+	stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+bool TraceRecorder::saveChromeTrace(const QString& fileName) {
+	QFile file(fileName);
+	if (!file.open(QFile::WriteOnly|QFile::Truncate)) {
+		return false;
+	}
+	QTextStream stream(&file);
+	writeChromeTrace(stream);
+	file.close();
+	return true;
+}
@@ -0,0 +1,97 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QAtomicInt>
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+#define TRACE_MAX_THREADS 32
+#define TRACE_EVENTS_PER_THREAD 8192
+
+//scope that is traced from its declaration to the end of the enclosing block, name has to be a string literal
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+
+
+enum TRACE_PHASE{
+	TRACE_BEGIN,
+	TRACE_END
+};
+
+struct TraceEvent {
+	const char* name;
+	qint64 timestampNs;
+	TRACE_PHASE phase;
+};
+
+//ring of the events of one thread, it is only written by the thread that claimed it. Events before firstEvent belong
+//to an earlier tracing session
+struct TraceThreadBuffer {
+	QAtomicInt claimed;
+	quintptr threadId;
+	QAtomicInt generation;
+	QAtomicInteger<quint64> firstEvent;
+	QAtomicInteger<quint64> writtenEvents;
+	TraceEvent events[TRACE_EVENTS_PER_THREAD];
+};
+
+
+//Records begin and end events of the hot path into one ring per thread, so recording needs neither locks nor
+//allocations. The rings are allocated once when tracing is enabled for the first time, every thread claims one of them
+//with its first event and hands it back when it finishes, so a later thread can reuse it. A ring is never reset while
+//its owner may write into it: enabling tracing again only starts a new session and the owner skips the events of
+//earlier sessions with its first event in the new one. While tracing is disabled every traced scope costs a single
+//predicted branch, a scope that began in an earlier session or is closed after tracing was disabled does not record
+//its end. Full rings keep the latest events. The events are exported in the trace event format of chrome://tracing,
+//events that are overwritten while exporting may appear torn.
+class TraceRecorder
+{
+public:
+	static bool isEnabled() {return Q_UNLIKELY(enabled.loadAcquire() != 0);}
+	static int getGeneration() {return generation.loadAcquire();}
+	static void setEnabled(bool enable);
+	static void begin(const char* name) {record(name, TRACE_BEGIN);}
+	static void end(const char* name) {record(name, TRACE_END);}
+	static int getThreadCount();
+	static quint64 getEventCount();
+	static void writeChromeTrace(QTextStream& stream);
+	static bool saveChromeTrace(const QString& fileName);
+
+private:
+	static QAtomicInt enabled;
+	static QAtomicInt generation;
+	static TraceThreadBuffer* buffers;
+	static QElapsedTimer clock;
+
+	static void record(const char* name, TRACE_PHASE phase);
+	static TraceThreadBuffer* threadBuffer();
+	static bool isCurrent(const TraceThreadBuffer& buffer) {return buffer.generation.loadAcquire() == generation.loadAcquire();}
+	static quint64 firstExportedEvent(const TraceThreadBuffer& buffer, quint64 written);
+};
+
+
+class TraceScope
+{
+public:
+	explicit TraceScope(const char* name) : name(TraceRecorder::isEnabled() ? name : nullptr), generation(-1) {
+		if (this->name != nullptr) {
+			this->generation = TraceRecorder::getGeneration();
+			TraceRecorder::begin(this->name);
+		}
+	}
+	~TraceScope() {
+		if (this->name != nullptr && TraceRecorder::isEnabled() && TraceRecorder::getGeneration() == this->generation) {
+			TraceRecorder::end(this->name);
+		}
+	}
+
+private:
+	const char* name;
+	int generation;
+};
+
+#endif //TRACERECORDER_H
@@ -0,0 +1,10 @@
+# Helpers shared by the unit tests, the benchmarks and the headless harness
+
+INCLUDEPATH += \
+	$$PWD
+
+SOURCES += \
+	$$PWD/syntheticframegenerator.cpp
+
+HEADERS += \
+	$$PWD/syntheticframegenerator.h
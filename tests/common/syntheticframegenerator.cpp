@@ -0,0 +1,187 @@
+#include "syntheticframegenerator.h"
+#include <QtMath>
+#include <cstring>
+
+//splitmix64, small and fast enough to draw several random numbers per sample of large frames
+static inline quint64 nextRandom(quint64& state)
+{
+	state += Q_UINT64_C(0x9E3779B97F4A7C15);
+	quint64 z = state;
+	z = (z ^ (z >> 30))*Q_UINT64_C(0xBF58476D1CE4E5B9);
+	z = (z ^ (z >> 27))*Q_UINT64_C(0x94D049BB133111EB);
+	return z ^ (z >> 31);
+}
+
+//uniform in (0, 1], so the logarithm below is always defined
+static inline double nextUniform(quint64& state)
+{
+	return (static_cast<double>(nextRandom(state) >> 11) + 1.0)/9007199254740992.0;
+}
+
+//box-muller transform. Both values are drawn in a fixed order, the evaluation order of operands within one expression is unspecified
+static inline double nextGaussian(quint64& state)
+{
+	double u1 = nextUniform(state);
+	double u2 = nextUniform(state);
+	return qSqrt(-2.0*qLn(u1))*qCos(2.0*M_PI*u2);
+}
+
+//rayleigh distribution scaled to a mean of 1
+static inline double nextRayleigh(quint64& state)
+{
+	return qSqrt(2.0/M_PI)*qSqrt(-2.0*qLn(nextUniform(state)));
+}
+
+
+SyntheticFrameGenerator::SyntheticFrameGenerator(const SyntheticFrameParameters& params)
+	: params(params),
+	frameNr(0),
+	bufferCount(0)
+{
+
+}
+
+void SyntheticFrameGenerator::setParameters(const SyntheticFrameParameters& params) {
+	this->params = params;
+	this->reset();
+}
+
+void SyntheticFrameGenerator::reset() {
+	this->frameNr = 0;
+	this->bufferCount = 0;
+}
+
+unsigned int SyntheticFrameGenerator::getCurrentBufferNr() const {
+	if (this->bufferCount == 0 || this->params.buffersPerVolume == 0) {
+		return 0;
+	}
+	return static_cast<unsigned int>((this->bufferCount-1) % this->params.buffersPerVolume);
+}
+
+size_t SyntheticFrameGenerator::getBytesPerSample() const {
+	return static_cast<size_t>((this->params.bitDepth+7)/8);
+}
+
+size_t SyntheticFrameGenerator::getBytesPerFrame() const {
+	return static_cast<size_t>(this->params.samplesPerLine)*this->params.linesPerFrame*this->getBytesPerSample();
+}
+
+size_t SyntheticFrameGenerator::getBytesPerBuffer() const {
+	return this->getBytesPerFrame()*this->params.framesPerBuffer;
+}
+
+double SyntheticFrameGenerator::motionOffset(quint64 frameNr) const {
+	double period = this->params.motionPeriod > 0.0 ? this->params.motionPeriod : 1.0;
+	double phase = static_cast<double>(frameNr)/period;
+	switch (this->params.motion) {
+		case MOTION_LINEAR:
+			return this->params.motionAmplitude*phase;
+		case MOTION_SINE:
+			return this->params.motionAmplitude*qSin(2.0*M_PI*phase);
+		case MOTION_STEP:
+			return (static_cast<quint64>(phase) % 2) == 1 ? this->params.motionAmplitude : 0.0;
+		default:
+			return 0.0;
+	}
+}
+
+double SyntheticFrameGenerator::reflectorDepth(int reflector, quint64 frameNr) const {
+	if (reflector < 0 || reflector >= this->params.reflectors.size()) {
+		return -1.0;
+	}
+	return this->params.reflectors.at(reflector).depth + this->motionOffset(frameNr);
+}
+
+double SyntheticFrameGenerator::groundTruthPeak(quint64 frameNr) const {
+	int strongest = -1;
+	for (int i = 0; i < this->params.reflectors.size(); ++i) {
+		if (strongest < 0 || this->params.reflectors.at(i).amplitude > this->params.reflectors.at(strongest).amplitude) {
+			strongest = i;
+		}
+	}
+	return this->reflectorDepth(strongest, frameNr);
+}
+
+void SyntheticFrameGenerator::generateFrame(quint64 frameNr, void* frame) const {
+	int samplesPerLine = static_cast<int>(this->params.samplesPerLine);
+	int linesPerFrame = static_cast<int>(this->params.linesPerFrame);
+	size_t bytesPerSample = this->getBytesPerSample();
+	double fullScale = static_cast<double>(this->maxValue());
+	double contrast = qBound(0.0, this->params.speckleContrast, 1.0);
+	uchar* destination = static_cast<uchar*>(frame);
+	if (frame == nullptr || bytesPerSample == 0 || bytesPerSample > 4) {
+		return;
+	}
+
+	//noise free reflector profile of this frame, the speckle is applied per sample on top of it
+	QVector<double> profile(samplesPerLine, 0.0);
+	for (int i = 0; i < this->params.reflectors.size(); ++i) {
+		const SyntheticReflector& reflector = this->params.reflectors.at(i);
+		double depth = this->reflectorDepth(i, frameNr);
+		double width = qMax(reflector.width, 0.1);
+		int begin = qMax(0, static_cast<int>(qFloor(depth - 5.0*width)));
+		int end = qMin(samplesPerLine, static_cast<int>(qCeil(depth + 5.0*width)) + 1);
+		for (int x = begin; x < end; ++x) {
+			double distance = (x - depth)/width;
+			profile[x] += reflector.amplitude*qExp(-0.5*distance*distance);
+		}
+	}
+
+	quint64 state = this->params.seed ^ (frameNr*Q_UINT64_C(0xD1B54A32D192ED03));
+	for (int y = 0; y < linesPerFrame; ++y) {
+		for (int x = 0; x < samplesPerLine; ++x) {
+			double value = this->params.noiseFloor;
+			if (this->params.noiseSigma > 0.0) {
+				value += this->params.noiseSigma*nextGaussian(state);
+			}
+			if (profile.at(x) > 0.0) {
+				double speckle = contrast > 0.0 ? (1.0 - contrast) + contrast*nextRayleigh(state) : 1.0;
+				value += profile.at(x)*speckle;
+			}
+			//clipping to the range of the bit depth is the saturation of the detector
+			double scaled = qBound(0.0, qRound64(value*fullScale)*1.0, fullScale);
+			this->writeSample(destination, static_cast<quint64>(scaled));
+			destination += bytesPerSample;
+		}
+	}
+}
+
+void SyntheticFrameGenerator::generateBuffer(void* buffer) {
+	uchar* destination = static_cast<uchar*>(buffer);
+	size_t bytesPerFrame = this->getBytesPerFrame();
+	for (unsigned int i = 0; i < this->params.framesPerBuffer; ++i) {
+		this->generateFrame(this->frameNr + i, destination + i*bytesPerFrame);
+	}
+	this->frameNr += this->params.framesPerBuffer;
+	this->bufferCount++;
+}
+
+QByteArray SyntheticFrameGenerator::generateBuffer() {
+	QByteArray buffer(static_cast<int>(this->getBytesPerBuffer()), 0);
+	this->generateBuffer(buffer.data());
+	return buffer;
+}
+
+quint64 SyntheticFrameGenerator::maxValue() const {
+	unsigned int bitDepth = qBound(1u, this->params.bitDepth, 32u);
+	return (Q_UINT64_C(1) << bitDepth) - 1;
+}
+
+void SyntheticFrameGenerator::writeSample(uchar* destination, quint64 value) const {
+	//samples are written as host integers, 24-bit samples as three bytes starting with the lowest one
+	size_t bytesPerSample = this->getBytesPerSample();
+	if (bytesPerSample == 1) {
+		*destination = static_cast<quint8>(value);
+	} else if (bytesPerSample == 2) {
+		quint16 sample = static_cast<quint16>(value);
+		memcpy(destination, &sample, sizeof(sample));
+	} else if (bytesPerSample == 4) {
+		quint32 sample = static_cast<quint32>(value);
+		memcpy(destination, &sample, sizeof(sample));
+	} else {
+		quint32 sample = static_cast<quint32>(value);
+		for (size_t i = 0; i < bytesPerSample; ++i) {
+			destination[i] = static_cast<uchar>(sample >> (8*i));
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef SYNTHETICFRAMEGENERATOR_H
+#define SYNTHETICFRAMEGENERATOR_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QByteArray>
+
+enum MOTION_TRAJECTORY{
+	MOTION_NONE,
+	MOTION_LINEAR,
+	MOTION_SINE,
+	MOTION_STEP
+};
+
+//Reflector at a depth (sample index within a line) with an amplitude relative to the full scale of the bit depth and a
+//gaussian axial point spread function of the given standard deviation in samples. Amplitudes above 1 saturate.
+struct SyntheticReflector {
+	double depth;
+	double amplitude;
+	double width;
+};
+
+//noiseFloor and noiseSigma are relative to the full scale. speckleContrast blends the reflectors from a constant
+//amplitude (0) to fully developed speckle with a unit mean rayleigh distribution (1). All reflectors are shifted by the
+//motion trajectory, which is evaluated once per frame with motionAmplitude in samples and motionPeriod in frames.
+struct SyntheticFrameParameters {
+	unsigned int bitDepth;
+	unsigned int samplesPerLine;
+	unsigned int linesPerFrame;
+	unsigned int framesPerBuffer;
+	unsigned int buffersPerVolume;
+	QVector<SyntheticReflector> reflectors;
+	double noiseFloor;
+	double noiseSigma;
+	double speckleContrast;
+	MOTION_TRAJECTORY motion;
+	double motionAmplitude;
+	double motionPeriod;
+	quint64 seed;
+
+	//single reflector at a quarter of the line depth above a low noise floor with moderate speckle, no motion
+	static SyntheticFrameParameters defaults(unsigned int bitDepth, unsigned int samplesPerLine, unsigned int linesPerFrame) {
+		SyntheticFrameParameters params;
+		params.bitDepth = bitDepth;
+		params.samplesPerLine = samplesPerLine;
+		params.linesPerFrame = linesPerFrame;
+		params.framesPerBuffer = 1;
+		params.buffersPerVolume = 1;
+		SyntheticReflector reflector;
+		reflector.depth = samplesPerLine/4.0;
+		reflector.amplitude = 0.6;
+		reflector.width = 2.0;
+		params.reflectors.append(reflector);
+		params.noiseFloor = 0.1;
+		params.noiseSigma = 0.02;
+		params.speckleContrast = 0.5;
+		params.motion = MOTION_NONE;
+		params.motionAmplitude = 0.0;
+		params.motionPeriod = 100.0;
+		params.seed = 1;
+		return params;
+	}
+};
+
+
+//Generates B-scans with the memory layout of the processed buffers that OCTproZ passes to processedDataReceived: each
+//buffer holds framesPerBuffer frames of linesPerFrame lines (A-scans) with samplesPerLine samples, every sample is an
+//unsigned integer of ceil(bitDepth/8) bytes in host byte order in the range of the bit depth. Every frame only depends
+//on the parameters and its frame number, so frames can be generated in any order and runs are reproducible. The ground
+//truth of the peak is the depth of the strongest reflector at that frame. getCurrentBufferNr() is the number within the
+//volume of the last generated buffer, like currentBufferNr of processedDataReceived.
+class SyntheticFrameGenerator
+{
+public:
+	SyntheticFrameGenerator(const SyntheticFrameParameters& params);
+
+	void setParameters(const SyntheticFrameParameters& params);
+	SyntheticFrameParameters getParameters() const {return this->params;}
+	void reset();
+
+	size_t getBytesPerSample() const;
+	size_t getBytesPerFrame() const;
+	size_t getBytesPerBuffer() const;
+	quint64 getFrameNr() const {return this->frameNr;}
+	quint64 getBufferCount() const {return this->bufferCount;}
+	unsigned int getCurrentBufferNr() const;
+
+	double motionOffset(quint64 frameNr) const;
+	double reflectorDepth(int reflector, quint64 frameNr) const;
+	double groundTruthPeak(quint64 frameNr) const;
+
+	void generateFrame(quint64 frameNr, void* frame) const;
+	void generateBuffer(void* buffer);
+	QByteArray generateBuffer();
+
+private:
+	SyntheticFrameParameters params;
+	quint64 frameNr;
+	quint64 bufferCount;
+
+	quint64 maxValue() const;
+	void writeSample(uchar* destination, quint64 value) const;
+};
+
+#endif // SYNTHETICFRAMEGENERATOR_H
\ No newline at end of file
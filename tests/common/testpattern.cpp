@@ -0,0 +1,23 @@
+#include "testpattern.h"
+#include "frameview.h"
+
+
+QByteArray TestPattern::frame(unsigned int bitDepth, unsigned int samplesPerLine, unsigned int linesPerFrame, int modulus)
+{
+	//samples occupy whole bytes, so bit depths that are not a multiple of 8 are rounded up like in the frame views
+	size_t bytes = static_cast<size_t>(samplesPerLine)*linesPerFrame*FrameView::bytesPerSample(bitDepth);
+	QByteArray frame(static_cast<int>(bytes), 0);
+	for (int i = 0; i < frame.size(); i++) {
+		frame[i] = static_cast<char>(value(i, modulus));
+	}
+	return frame;
+}
+
+QVector<qreal> TestPattern::line(int length, int modulus)
+{
+	QVector<qreal> line(length);
+	for (int i = 0; i < length; i++) {
+		line[i] = static_cast<qreal>(value(i, modulus));
+	}
+	return line;
+}
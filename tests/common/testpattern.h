@@ -0,0 +1,23 @@
+#ifndef TESTPATTERN_H
+#define TESTPATTERN_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <QByteArray>
+
+//default range of the pattern values, prime so the pattern does not repeat with the line length
+#define TEST_PATTERN_MODULUS 251
+
+
+//Deterministic pseudo random pattern for comparing vector kernels against their scalar version. Every byte of a frame
+//gets a value in [0, modulus), so multi byte samples of any bit depth get a wide and irregular value range. A small
+//modulus makes the same value occur several times per line.
+class TestPattern
+{
+public:
+	static int value(int index, int modulus = TEST_PATTERN_MODULUS) {return (index*7919 + 13) % modulus;}
+	static QByteArray frame(unsigned int bitDepth, unsigned int samplesPerLine, unsigned int linesPerFrame, int modulus = TEST_PATTERN_MODULUS);
+	static QVector<qreal> line(int length, int modulus = TEST_PATTERN_MODULUS);
+};
+
+#endif //TESTPATTERN_H
\ No newline at end of file
@@ -2,6 +2,22 @@
 #include <QApplication>
 #include "test_peakfinder.h"
 #include "test_bitdepthconverter.h"
+#include "test_frameringbuffer.h"
+#include "test_decimationscheduler.h"
+#include "test_columnaccumulator.h"
+#include "test_cpufeatures.h"
+#include "test_peakinterpolation.h"
+#include "test_multipeaksearch.h"
+#include "test_linepeaksearch.h"
+#include "test_peaktracker.h"
+#include "test_linefilter.h"
+#include "test_rowaggregator.h"
+#include "test_columnintegraltable.h"
+#include "test_multiroiaccumulator.h"
+#include "test_noisefloorestimator.h"
+#include "test_latencymonitor.h"
+#include "test_tracerecorder.h"
+#include "test_syntheticframegenerator.h"
 
 Q_DECLARE_METATYPE(uchar*)
 
@@ -22,5 +38,85 @@ int main(int argc, char *argv[])
 		status |= QTest::qExec(&tc, argc, argv);
 	}
 	
+	{
+		TestFrameRingBuffer tc;
+		status |= QTest::qExec(&tc, argc, argv);
+	}
+	
+	{
+		TestDecimationScheduler tc;
+		status |= QTest::qExec(&tc, argc, argv);
+	}
+	
+	{
+		TestColumnAccumulator tc;
+		status |= QTest::qExec(&tc, argc, argv);
+	}
+	
+	{
+		TestCpuFeatures tc;
+		status |= QTest::qExec(&tc, argc, argv);
+	}
+	
+	{
+		TestPeakInterpolation tc;
+		status |= QTest::qExec(&tc, argc, argv);
+	}
+	
+	{
+		TestMultiPeakSearch tc;
+		status |= QTest::qExec(&tc, argc, argv);
+	}
+	
+	{
+		TestLinePeakSearch tc;
+		status |= QTest::qExec(&tc, argc, argv);
+	}
+	
+	{
+		TestPeakTracker tc;
+		status |= QTest::qExec(&tc, argc, argv);
+	}
+	
+	{
+		TestLineFilter tc;
+		status |= QTest::qExec(&tc, argc, argv);
+	}
+	
+	{
+		TestRowAggregator tc;
+		status |= QTest::qExec(&tc, argc, argv);
+	}
+	
+	{
+		TestColumnIntegralTable tc;
+		status |= QTest::qExec(&tc, argc, argv);
+	}
+	
+	{
+		TestMultiRoiAccumulator tc;
+		status |= QTest::qExec(&tc, argc, argv);
+	}
+	
+	{
+		TestNoiseFloorEstimator tc;
+		status |= QTest::qExec(&tc, argc, argv);
+	}
+	
+	{
+		TestLatencyMonitor tc;
+		status |= QTest::qExec(&tc, argc, argv);
+	}
+	
+	{
+		TestTraceRecorder tc;
+		status |= QTest::qExec(&tc, argc, argv);
+	}
+	
+	{
+		TestSyntheticFrameGenerator tc;
+		status |= QTest::qExec(&tc, argc, argv);
+	}
+	
 	return status;
 }
\ No newline at end of file
@@ -95,4 +95,37 @@ void TestBitDepthConverter::testErrorHandling()
 	
 	//error signal should be emitted
 	QVERIFY(spy.count() > 0);
+}
+
+void TestBitDepthConverter::testKernelsMatchScalar()
+{
+	//odd length so vector kernels have to convert remaining samples with the scalar loop, maximum values included
+	const int length = 1000 + 7;
+	QVector<quint16> input16(length);
+	QVector<quint32> input32(length);
+	for (int i = 0; i < length; i++) {
+		input16[i] = static_cast<quint16>((i*40503) & 0x0FFF);
+		input32[i] = static_cast<quint32>(i)*2654435761u;
+	}
+	input16[3] = 0x0FFF;
+	input32[5] = 0xFFFFFFFF;
+	
+	QVector<uchar> expected16(length);
+	QVector<uchar> expected32(length);
+	QVERIFY(BitDepthConverter::convertTo8bit(input16.constData(), expected16.data(), length, 12, KERNEL_SCALAR));
+	QVERIFY(BitDepthConverter::convertTo8bit(input32.constData(), expected32.data(), length, 32, KERNEL_SCALAR));
+	QCOMPARE(expected16[3], uchar(255));
+	
+	QList<SIMD_KERNEL> kernels = {KERNEL_SSE2, KERNEL_AVX2, KERNEL_AVX512};
+	for (SIMD_KERNEL kernel : kernels) {
+		if (!CpuFeatures::isSupported(kernel)) {
+			qDebug() << "Kernel not supported on this CPU:" << CpuFeatures::getKernelName(kernel);
+			continue;
+		}
+		QVector<uchar> output(length);
+		QVERIFY(BitDepthConverter::convertTo8bit(input16.constData(), output.data(), length, 12, kernel));
+		QCOMPARE(output, expected16);
+		QVERIFY(BitDepthConverter::convertTo8bit(input32.constData(), output.data(), length, 32, kernel));
+		QCOMPARE(output, expected32);
+	}
 }
\ No newline at end of file
@@ -12,6 +12,7 @@ private slots:
 	void testConvert8BitData();
 	void testConvert16BitData();
 	void testErrorHandling();
+	void testKernelsMatchScalar();
 };
 
 #endif // TEST_BITDEPTHCONVERTER_H
\ No newline at end of file
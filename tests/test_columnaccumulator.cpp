@@ -0,0 +1,94 @@
+#include "test_columnaccumulator.h"
+
+void TestColumnAccumulator::testKernelsMatchScalar_data()
+{
+	QTest::addColumn<int>("bitDepth");
+	QTest::newRow("8 bit") << 8;
+	QTest::newRow("12 bit") << 12;
+	QTest::newRow("16 bit") << 16;
+	QTest::newRow("32 bit") << 32;
+}
+
+void TestColumnAccumulator::testKernelsMatchScalar()
+{
+	QFETCH(int, bitDepth);
+	
+	//odd frame and roi dimensions so vector kernels have to process remaining columns with the scalar loop
+	const unsigned int samplesPerLine = 211;
+	const unsigned int linesPerFrame = 97;
+	QByteArray frame = TestPattern::frame(bitDepth, samplesPerLine, linesPerFrame);
+	QRect roi(5, 3, 177, 90);
+	
+	QVector<quint64> expected(roi.width());
+	ColumnAccumulator::accumulate(frame.constData(), bitDepth, samplesPerLine, roi, expected.data(), KERNEL_SCALAR);
+	
+	QList<SIMD_KERNEL> kernels = {KERNEL_SSE2, KERNEL_AVX2, KERNEL_AVX512};
+	for (SIMD_KERNEL kernel : kernels) {
+		if (!CpuFeatures::isSupported(kernel)) {
+			qDebug() << "Kernel not supported on this CPU:" << kernel;
+			continue;
+		}
+		QVector<quint64> columnSums(roi.width(), 1);
+		ColumnAccumulator::accumulate(frame.constData(), bitDepth, samplesPerLine, roi, columnSums.data(), kernel);
+		QCOMPARE(columnSums, expected);
+	}
+}
+
+void TestColumnAccumulator::testLaneOverflow_data()
+{
+	QTest::addColumn<int>("bitDepth");
+	QTest::newRow("8 bit") << 8;
+	QTest::newRow("16 bit") << 16;
+}
+
+void TestColumnAccumulator::testLaneOverflow()
+{
+	QFETCH(int, bitDepth);
+	
+	//maximum sample values in more rows than the intermediate lanes can hold
+	const unsigned int samplesPerLine = 64;
+	const unsigned int linesPerFrame = bitDepth == 8 ? 3*ACCUMULATOR_ROWS_8BIT+1 : ACCUMULATOR_ROWS_16BIT+3;
+	size_t bytesPerSample = FrameView::bytesPerSample(bitDepth);
+	QByteArray frame(static_cast<int>(samplesPerLine*linesPerFrame*bytesPerSample), static_cast<char>(0xFF));
+	QRect roi(0, 0, samplesPerLine, linesPerFrame);
+	quint64 maxValue = bitDepth == 8 ? 255 : 65535;
+	
+	QList<SIMD_KERNEL> kernels = {KERNEL_SCALAR, KERNEL_SSE2, KERNEL_AVX2, KERNEL_AVX512};
+	for (SIMD_KERNEL kernel : kernels) {
+		if (!CpuFeatures::isSupported(kernel)) {
+			continue;
+		}
+		QVector<quint64> columnSums(roi.width());
+		ColumnAccumulator::accumulate(frame.constData(), bitDepth, samplesPerLine, roi, columnSums.data(), kernel);
+		QCOMPARE(columnSums.first(), maxValue*linesPerFrame);
+		QCOMPARE(columnSums.last(), maxValue*linesPerFrame);
+	}
+}
+
+void TestColumnAccumulator::testParallelMatchesSingleThreaded()
+{
+	//roi large enough to be split into several bands, height not a multiple of the band height
+	const unsigned int samplesPerLine = 1024;
+	const unsigned int linesPerFrame = 1500;
+	QVector<quint16> frame(samplesPerLine*linesPerFrame);
+	for (int i = 0; i < frame.size(); i++) {
+		frame[i] = static_cast<quint16>((i*2654435761u) >> 16);
+	}
+	QRect roi(3, 7, 1000, 1491);
+	QVERIFY(roi.height() % ParallelAccumulator::calculateBandHeight(roi.width(), 16) != 0);
+	QCOMPARE(ParallelAccumulator::calculateThreadCount(roi, 16, 4), 4);
+	QCOMPARE(ParallelAccumulator::calculateThreadCount(QRect(0, 0, 100, 100), 16, 4), 1);
+	
+	QVector<quint64> expected(roi.width());
+	ColumnAccumulator::accumulate(frame.constData(), 16, samplesPerLine, roi, expected.data());
+	
+	ParallelAccumulator parallelAccumulator(4);
+	QVector<quint64> columnSums(roi.width());
+	QCOMPARE(parallelAccumulator.accumulate(frame.constData(), 16, samplesPerLine, roi, columnSums.data()), 4);
+	QCOMPARE(columnSums, expected);
+	
+	//second run reuses the partial sums of the first one
+	columnSums.fill(0);
+	parallelAccumulator.accumulate(frame.constData(), 16, samplesPerLine, roi, columnSums.data());
+	QCOMPARE(columnSums, expected);
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef TEST_COLUMNACCUMULATOR_H
+#define TEST_COLUMNACCUMULATOR_H
+
+#include <QtTest>
+#include "columnaccumulator.h"
+#include "parallelaccumulator.h"
+#include "frameview.h"
+#include "testpattern.h"
+
+class TestColumnAccumulator : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void testKernelsMatchScalar_data();
+	void testKernelsMatchScalar();
+	void testLaneOverflow_data();
+	void testLaneOverflow();
+	void testParallelMatchesSingleThreaded();
+};
+
+#endif // TEST_COLUMNACCUMULATOR_H
\ No newline at end of file
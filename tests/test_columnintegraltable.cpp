@@ -0,0 +1,106 @@
+#include "test_columnintegraltable.h"
+
+void TestColumnIntegralTable::testMatchesColumnAccumulator_data()
+{
+	QTest::addColumn<int>("bitDepth");
+	QTest::newRow("8 bit") << 8;
+	QTest::newRow("16 bit") << 16;
+	QTest::newRow("32 bit") << 32;
+}
+
+void TestColumnIntegralTable::testMatchesColumnAccumulator()
+{
+	QFETCH(int, bitDepth);
+	
+	//view of a region inside a larger frame, the rois are given in frame coordinates
+	const unsigned int samplesPerLine = 97;
+	const unsigned int linesPerFrame = 61;
+	size_t bytesPerSample = FrameView::bytesPerSample(bitDepth);
+	QByteArray frame = TestPattern::frame(bitDepth, samplesPerLine, linesPerFrame);
+	FrameView view = FrameView::fullFrame(frame.constData(), bitDepth, samplesPerLine, linesPerFrame);
+	view.region = QRect(10, 5, 80, 50);
+	view.data = frame.constData() + (static_cast<size_t>(view.region.y())*samplesPerLine + view.region.x())*bytesPerSample;
+	
+	ColumnIntegralTable table;
+	table.build(view);
+	QVERIFY(table.isValid());
+	
+	QList<QRect> rois = {QRect(10, 5, 80, 50), QRect(13, 7, 31, 1), QRect(40, 20, 50, 35)};
+	for (const QRect& roi : rois) {
+		QVector<quint64> expected(roi.width());
+		ColumnAccumulator::accumulate(frame.constData(), bitDepth, samplesPerLine, roi, expected.data());
+		QVector<quint64> sums(roi.width());
+		QVERIFY(table.columnSums(roi, sums.data()));
+		QCOMPARE(sums, expected);
+	}
+	
+	//rois that are not fully inside the view can not be read out
+	QVector<quint64> sums(100);
+	QVERIFY(!table.covers(QRect(5, 5, 20, 20)));
+	QVERIFY(!table.columnSums(QRect(60, 40, 20, 20), sums.data()));
+}
+
+void TestColumnIntegralTable::testWideSums()
+{
+	//more than 65537 lines of 16-bit samples could overflow 32-bit sums, the table has to switch to 64-bit entries
+	const unsigned int samplesPerLine = 3;
+	const unsigned int linesPerFrame = 70000;
+	QVector<quint16> frame(samplesPerLine*linesPerFrame, 65535);
+	ColumnIntegralTable table;
+	table.build(FrameView::fullFrame(frame.constData(), 16, samplesPerLine, linesPerFrame));
+	
+	QVector<quint64> sums(samplesPerLine);
+	QVERIFY(table.columnSums(QRect(0, 0, samplesPerLine, linesPerFrame), sums.data()));
+	QCOMPARE(sums.at(0), static_cast<quint64>(65535)*linesPerFrame);
+	QVERIFY(table.getAllocatedBytes() >= static_cast<size_t>(linesPerFrame+1)*samplesPerLine*sizeof(quint64));
+}
+
+void TestColumnIntegralTable::testMemoryReused()
+{
+	QVector<quint8> largeFrame(64*64, 1);
+	QVector<quint8> smallFrame(32*32, 2);
+	ColumnIntegralTable table;
+	table.build(FrameView::fullFrame(largeFrame.constData(), 8, 64, 64));
+	size_t allocatedBytes = table.getAllocatedBytes();
+	
+	//a smaller frame fits into the table of the larger one
+	table.build(FrameView::fullFrame(smallFrame.constData(), 8, 32, 32));
+	QCOMPARE(table.getAllocatedBytes(), allocatedBytes);
+	QVector<quint64> sums(32);
+	QVERIFY(table.columnSums(QRect(0, 0, 32, 32), sums.data()));
+	QCOMPARE(sums.at(31), static_cast<quint64>(64));
+	
+	table.invalidate();
+	QVERIFY(!table.columnSums(QRect(0, 0, 32, 32), sums.data()));
+}
+
+void TestColumnIntegralTable::testRoiChangeReanalyzesFrame()
+{
+	//two peaks in different rows of the frame, moving the roi to the other rows finds the second peak without a new frame
+	const unsigned int samplesPerLine = 50;
+	const unsigned int linesPerFrame = 40;
+	QVector<unsigned char> frame(samplesPerLine*linesPerFrame, 10);
+	for (unsigned int y = 0; y < 20; y++) {
+		frame[y*samplesPerLine + 12] = 200;
+	}
+	for (unsigned int y = 20; y < linesPerFrame; y++) {
+		frame[y*samplesPerLine + 37] = 200;
+	}
+	
+	PeakFinder peakFinder;
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.minThreshold = 0.0;
+	params.roi = QRect(0, 0, samplesPerLine, 20);
+	params.integralTableEnabled = true;
+	peakFinder.setParams(params);
+	
+	QSignalSpy spy(&peakFinder, &PeakFinder::peakPositionFound);
+	peakFinder.findPeak(frame.data(), 8, samplesPerLine, linesPerFrame);
+	frame.fill(0);
+	peakFinder.setRoi(QRect(0, 20, samplesPerLine, 20));
+	
+	QTRY_COMPARE(spy.count(), 2);
+	QCOMPARE(spy.at(0).at(0).toDouble(), 12.0);
+	QCOMPARE(spy.at(1).at(0).toDouble(), 37.0);
+}
\ No newline at end of file
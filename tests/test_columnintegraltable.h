@@ -0,0 +1,22 @@
+#ifndef TEST_COLUMNINTEGRALTABLE_H
+#define TEST_COLUMNINTEGRALTABLE_H
+
+#include <QtTest>
+#include "columnintegraltable.h"
+#include "columnaccumulator.h"
+#include "peakfinder.h"
+#include "testpattern.h"
+
+class TestColumnIntegralTable : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void testMatchesColumnAccumulator_data();
+	void testMatchesColumnAccumulator();
+	void testWideSums();
+	void testMemoryReused();
+	void testRoiChangeReanalyzesFrame();
+};
+
+#endif // TEST_COLUMNINTEGRALTABLE_H
\ No newline at end of file
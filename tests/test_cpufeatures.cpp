@@ -0,0 +1,53 @@
+#include "test_cpufeatures.h"
+
+void TestCpuFeatures::testForceScalar()
+{
+	SIMD_KERNEL bestKernel = CpuFeatures::detectBestKernel();
+	QVERIFY(CpuFeatures::isSupported(bestKernel));
+	
+	qputenv(PEAKDETECTOR_FORCE_SCALAR_ENV, "1");
+	QCOMPARE(CpuFeatures::initialize(), KERNEL_SCALAR);
+	QCOMPARE(CpuFeatures::getKernel(), KERNEL_SCALAR);
+	
+	qputenv(PEAKDETECTOR_FORCE_SCALAR_ENV, "0");
+	QCOMPARE(CpuFeatures::initialize(), bestKernel);
+	
+	qunsetenv(PEAKDETECTOR_FORCE_SCALAR_ENV);
+	QCOMPARE(CpuFeatures::initialize(), bestKernel);
+}
+
+void TestCpuFeatures::testSetKernelFallsBack()
+{
+	//selecting an unsupported kernel must fall back to the best supported one below it
+	CpuFeatures::setKernel(KERNEL_AVX512);
+	QVERIFY(CpuFeatures::isSupported(CpuFeatures::getKernel()));
+	QVERIFY(CpuFeatures::getKernel() <= KERNEL_AVX512);
+	
+	CpuFeatures::setKernel(KERNEL_SCALAR);
+	QCOMPARE(CpuFeatures::getKernel(), KERNEL_SCALAR);
+	
+	CpuFeatures::initialize();
+}
+
+void TestCpuFeatures::testMaxSearchKernelsMatchScalar()
+{
+	QList<SIMD_KERNEL> kernels = {KERNEL_SSE2, KERNEL_AVX2, KERNEL_AVX512};
+	
+	//small integer values produce many equal maxima, so the position of the first maximum is checked as well
+	for (int length = 0; length < 70; length++) {
+		QVector<qreal> line(length);
+		for (int i = 0; i < length; i++) {
+			line[i] = static_cast<qreal>((i*37 + length*11) % 17);
+		}
+		QList<qreal> thresholds = {-1.0, 5.0, 15.5, 20.0};
+		for (qreal threshold : thresholds) {
+			int expected = MaxSearch::findMaxValuePosition(line.constData(), length, threshold, KERNEL_SCALAR);
+			for (SIMD_KERNEL kernel : kernels) {
+				if (!CpuFeatures::isSupported(kernel)) {
+					continue;
+				}
+				QCOMPARE(MaxSearch::findMaxValuePosition(line.constData(), length, threshold, kernel), expected);
+			}
+		}
+	}
+}
\ No newline at end of file
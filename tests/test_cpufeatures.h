@@ -0,0 +1,18 @@
+#ifndef TEST_CPUFEATURES_H
+#define TEST_CPUFEATURES_H
+
+#include <QtTest>
+#include "cpufeatures.h"
+#include "maxsearch.h"
+
+class TestCpuFeatures : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void testForceScalar();
+	void testSetKernelFallsBack();
+	void testMaxSearchKernelsMatchScalar();
+};
+
+#endif // TEST_CPUFEATURES_H
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "test_decimationscheduler.h"
+
+void TestDecimationScheduler::testAcceptAllWithoutMeasurement()
+{
+	DecimationScheduler scheduler;
+	
+	//without any processing time measurement every buffer is accepted
+	for (int i = 0; i < 10; i++) {
+		QVERIFY(scheduler.acceptBuffer(i*1000000, 1, 0));
+	}
+	QCOMPARE(scheduler.getDecimationRatio(), 1);
+}
+
+void TestDecimationScheduler::testCpuBudget()
+{
+	DecimationScheduler scheduler;
+	scheduler.setTarget(TARGET_CPU_BUDGET, 50);
+	
+	//10 ms per frame and a new buffer every 1 ms. With 50 % cpu budget only every 20th buffer can be analyzed
+	scheduler.reportProcessingTime(1, 10000000);
+	int accepted = 0;
+	for (int i = 0; i < 200; i++) {
+		if (scheduler.acceptBuffer(i*1000000, 1, 0)) {
+			accepted++;
+		}
+	}
+	QCOMPARE(scheduler.getDecimationRatio(), 20);
+	QVERIFY(accepted >= 9 && accepted <= 11);
+}
+
+void TestDecimationScheduler::testLatencyIncreaseAndDecrease()
+{
+	DecimationScheduler scheduler;
+	scheduler.setTarget(TARGET_LATENCY, 5);
+	
+	//4 ms per frame, new buffer every 10 ms: queued slots exceed target latency, so ratio has to go up
+	scheduler.reportProcessingTime(1, 4000000);
+	qint64 timestamp = 0;
+	for (int i = 0; i < 10; i++) {
+		scheduler.acceptBuffer(timestamp, 1, 3);
+		timestamp += 10000000;
+	}
+	int overloadedRatio = scheduler.getDecimationRatio();
+	QVERIFY(overloadedRatio > 1);
+	
+	//processing got faster and queue is empty: ratio goes back to 1
+	for (int i = 0; i < 10; i++) {
+		scheduler.reportProcessingTime(1, 100000);
+	}
+	for (int i = 0; i < 2*overloadedRatio; i++) {
+		scheduler.acceptBuffer(timestamp, 1, 0);
+		timestamp += 10000000;
+	}
+	QCOMPARE(scheduler.getDecimationRatio(), 1);
+}
+
+void TestDecimationScheduler::testUnreachableLatencyTarget()
+{
+	DecimationScheduler scheduler;
+	scheduler.setTarget(TARGET_LATENCY, 5);
+	
+	//20 ms per buffer can never meet a 5 ms target, only every 2nd buffer of a 10 ms interval can be kept up with
+	qint64 timestamp = 0;
+	for (int i = 0; i < 100; i++) {
+		scheduler.reportProcessingTime(1, 20000000);
+		scheduler.acceptBuffer(timestamp, 1, 3);
+		timestamp += 10000000;
+	}
+	QCOMPARE(scheduler.getDecimationRatio(), 2);
+	QVERIFY(!scheduler.isTargetReachable());
+	
+	//faster analysis makes the target reachable again
+	for (int i = 0; i < 50; i++) {
+		scheduler.reportProcessingTime(1, 1000000);
+		scheduler.acceptBuffer(timestamp, 1, 0);
+		timestamp += 10000000;
+	}
+	QVERIFY(scheduler.isTargetReachable());
+	QCOMPARE(scheduler.getDecimationRatio(), 1);
+}
+
+void TestDecimationScheduler::testRatioStepsOncePerCostReport()
+{
+	DecimationScheduler scheduler;
+	scheduler.setTarget(TARGET_LATENCY, 10);
+	
+	//a queue depth spike without new cost measurements changes the ratio only once
+	scheduler.reportProcessingTime(1, 4000000);
+	qint64 timestamp = 0;
+	for (int i = 0; i < 1000; i++) {
+		scheduler.acceptBuffer(timestamp, 1, 8);
+		timestamp += 1000000;
+	}
+	QCOMPARE(scheduler.getDecimationRatio(), 4);
+	
+	//with new measurements the ratio is still limited to the one that drains the queue within the target
+	for (int i = 0; i < 1000; i++) {
+		scheduler.reportProcessingTime(1, 4000000);
+		scheduler.acceptBuffer(timestamp, 1, 8);
+		timestamp += 1000000;
+	}
+	QCOMPARE(scheduler.getDecimationRatio(), 26);
+}
\ No newline at end of file
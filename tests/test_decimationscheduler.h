@@ -0,0 +1,19 @@
+#ifndef TEST_DECIMATIONSCHEDULER_H
+#define TEST_DECIMATIONSCHEDULER_H
+
+#include <QtTest>
+#include "decimationscheduler.h"
+
+class TestDecimationScheduler : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void testAcceptAllWithoutMeasurement();
+	void testCpuBudget();
+	void testLatencyIncreaseAndDecrease();
+	void testUnreachableLatencyTarget();
+	void testRatioStepsOncePerCostReport();
+};
+
+#endif // TEST_DECIMATIONSCHEDULER_H
\ No newline at end of file
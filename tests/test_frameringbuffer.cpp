@@ -0,0 +1,94 @@
+#include "test_frameringbuffer.h"
+
+void TestFrameRingBuffer::testAcquireAndRelease()
+{
+	FrameRingBuffer ring(2);
+	QVERIFY(ring.resize(2, 16));
+	QCOMPARE(ring.getDepth(), 2);
+	QCOMPARE(ring.getUsedSlots(), 0);
+
+	FrameSlot* slot = ring.acquire();
+	QVERIFY(slot != nullptr);
+	QVERIFY(slot->data != nullptr);
+	QCOMPARE(ring.getUsedSlots(), 1);
+
+	//slot is handed back to producer only after all readers released it
+	ring.publish(slot, 2);
+	ring.release(slot);
+	QCOMPARE(ring.getUsedSlots(), 1);
+	ring.release(slot);
+	QCOMPARE(ring.getUsedSlots(), 0);
+}
+
+void TestFrameRingBuffer::testDropWhenFull()
+{
+	FrameRingBuffer ring(2);
+	QVERIFY(ring.resize(2, 16));
+
+	FrameSlot* slotA = ring.acquire();
+	FrameSlot* slotB = ring.acquire();
+	QVERIFY(slotA != nullptr);
+	QVERIFY(slotB != nullptr);
+	QVERIFY(slotA != slotB);
+	ring.publish(slotA, 1);
+	ring.publish(slotB, 1);
+
+	//ring is full, producer has to drop frame
+	QVERIFY(ring.acquire() == nullptr);
+	QCOMPARE(ring.countLostFrames(), quint64(1));
+
+	//after consumer returned the oldest slot the producer can continue
+	ring.release(slotA);
+	QCOMPARE(ring.acquire(), slotA);
+	QCOMPARE(ring.getLostFrames(), quint64(1));
+}
+
+void TestFrameRingBuffer::testSkipHeldSlot()
+{
+	FrameRingBuffer ring(3);
+	QVERIFY(ring.resize(3, 16));
+
+	//first slot is kept by a consumer, producer continues with the other ones
+	FrameSlot* heldSlot = ring.acquire();
+	ring.publish(heldSlot, 1);
+	for(int i = 0; i < 4; i++){
+		FrameSlot* slot = ring.acquire();
+		QVERIFY(slot != nullptr);
+		QVERIFY(slot != heldSlot);
+		ring.publish(slot, 1);
+		ring.release(slot);
+	}
+	QCOMPARE(ring.getUsedSlots(), 1);
+
+	ring.release(heldSlot);
+	QCOMPARE(ring.getUsedSlots(), 0);
+}
+
+void TestFrameRingBuffer::testReleaseByAddress()
+{
+	FrameRingBuffer ring(2);
+	QVERIFY(ring.resize(2, 16));
+
+	FrameSlot* slot = ring.acquire();
+	ring.publish(slot, 1);
+
+	//any address inside the slot data identifies the slot
+	ring.release(slot->data + 8);
+	QCOMPARE(ring.getUsedSlots(), 0);
+}
+
+void TestFrameRingBuffer::testResizeWhileInUse()
+{
+	FrameRingBuffer ring(2);
+	QVERIFY(ring.resize(2, 16));
+
+	FrameSlot* slot = ring.acquire();
+	ring.publish(slot, 1);
+	QVERIFY(!ring.resize(4, 32));
+	QCOMPARE(ring.getDepth(), 2);
+
+	ring.release(slot);
+	QVERIFY(ring.resize(4, 32));
+	QCOMPARE(ring.getDepth(), 4);
+	QCOMPARE(ring.getBytesPerSlot(), size_t(32));
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef TEST_FRAMERINGBUFFER_H
+#define TEST_FRAMERINGBUFFER_H
+
+#include <QtTest>
+#include "frameringbuffer.h"
+
+class TestFrameRingBuffer : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void testAcquireAndRelease();
+	void testDropWhenFull();
+	void testSkipHeldSlot();
+	void testReleaseByAddress();
+	void testResizeWhileInUse();
+};
+
+#endif // TEST_FRAMERINGBUFFER_H
\ No newline at end of file
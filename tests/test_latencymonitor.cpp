@@ -0,0 +1,102 @@
+#include "test_latencymonitor.h"
+#include <QThreadPool>
+#include <QRunnable>
+
+//records the same values from several threads into one histogram
+class RecordingTask : public QRunnable
+{
+public:
+	RecordingTask(LatencyHistogram* histogram) : histogram(histogram) {}
+	void run() override {
+		for (int i = 1; i <= 10000; i++) {
+			this->histogram->record(i);
+		}
+	}
+
+private:
+	LatencyHistogram* histogram;
+};
+
+void TestLatencyMonitor::testBucketBounds()
+{
+	//every value lies in its bucket, buckets are contiguous and at most 1/16 of the value wide
+	qint64 previousUpperBound = -1;
+	for (int index = 0; index < LATENCY_BUCKETS; index++) {
+		qint64 upperBound = LatencyHistogram::bucketUpperBound(index);
+		qint64 lowerBound = previousUpperBound + 1;
+		QVERIFY(upperBound >= lowerBound);
+		QCOMPARE(LatencyHistogram::bucketIndex(static_cast<quint64>(lowerBound)), index);
+		QCOMPARE(LatencyHistogram::bucketIndex(static_cast<quint64>(upperBound)), index);
+		QVERIFY(upperBound - lowerBound <= lowerBound/LATENCY_SUB_BUCKETS);
+		previousUpperBound = upperBound;
+	}
+	QCOMPARE(previousUpperBound, (Q_INT64_C(1) << LATENCY_MAX_EXPONENT) - 1);
+	QCOMPARE(LatencyHistogram::bucketIndex(Q_UINT64_C(1) << 50), LATENCY_BUCKETS-1);
+}
+
+void TestLatencyMonitor::testPercentiles()
+{
+	LatencyHistogram histogram;
+	QCOMPARE(histogram.percentile(0.5), Q_INT64_C(0));
+	
+	//latencies of 1 to 1000 us
+	for (int i = 1; i <= 1000; i++) {
+		histogram.record(static_cast<qint64>(i)*1000);
+	}
+	QCOMPARE(histogram.getCount(), Q_UINT64_C(1000));
+	QCOMPARE(histogram.getMax(), Q_INT64_C(1000000));
+	QCOMPARE(histogram.getMean(), 500500.0);
+	qint64 median = histogram.percentile(0.5);
+	qint64 p99 = histogram.percentile(0.99);
+	QVERIFY(median >= 500000 && median <= 500000 + 500000/LATENCY_SUB_BUCKETS);
+	QVERIFY(p99 >= 990000 && p99 <= 1000000);
+	QCOMPARE(histogram.percentile(1.0), Q_INT64_C(1000000));
+	
+	//negative latencies of unsynchronized timestamps are counted as 0
+	histogram.reset();
+	QCOMPARE(histogram.getCount(), Q_UINT64_C(0));
+	QCOMPARE(histogram.getMax(), Q_INT64_C(0));
+	histogram.record(-5);
+	QCOMPARE(histogram.getCount(), Q_UINT64_C(1));
+	QCOMPARE(histogram.percentile(0.5), Q_INT64_C(0));
+}
+
+void TestLatencyMonitor::testConcurrentRecording()
+{
+	LatencyHistogram histogram;
+	QThreadPool pool;
+	pool.setMaxThreadCount(4);
+	for (int i = 0; i < 4; i++) {
+		pool.start(new RecordingTask(&histogram));
+	}
+	pool.waitForDone();
+	
+	//no increment is lost without locks
+	QCOMPARE(histogram.getCount(), Q_UINT64_C(40000));
+	QCOMPARE(histogram.getMax(), Q_INT64_C(10000));
+	QCOMPARE(histogram.getMean(), 5000.5);
+}
+
+void TestLatencyMonitor::testStagesAndCsv()
+{
+	LatencyMonitor monitor;
+	qint64 start = monitor.now();
+	QVERIFY(monitor.now() >= start);
+	
+	monitor.record(STAGE_COPY, 1000, 3000);
+	monitor.record(STAGE_TOTAL, 8000);
+	
+	//skipped hops are marked with -1 and not recorded
+	monitor.record(STAGE_QUEUE, -1, 3000);
+	QCOMPARE(monitor.getHistogram(STAGE_COPY).getCount(), Q_UINT64_C(1));
+	QCOMPARE(monitor.getHistogram(STAGE_COPY).getMax(), Q_INT64_C(2000));
+	QCOMPARE(monitor.getHistogram(STAGE_QUEUE).getCount(), Q_UINT64_C(0));
+	
+	QStringList lines = monitor.toCsv().trimmed().split("\n");
+	QCOMPARE(lines.size(), 1 + STAGE_COUNT);
+	QCOMPARE(lines.at(1 + STAGE_COPY), QString("Copy;1;2.000;2.000;2.000;2.000;2.000"));
+	QCOMPARE(lines.at(1 + STAGE_TOTAL), QString("Total;1;8.000;8.000;8.000;8.000;8.000"));
+	
+	monitor.reset();
+	QCOMPARE(monitor.getHistogram(STAGE_TOTAL).getCount(), Q_UINT64_C(0));
+}
\ No newline at end of file
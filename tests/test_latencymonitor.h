@@ -0,0 +1,18 @@
+#ifndef TEST_LATENCYMONITOR_H
+#define TEST_LATENCYMONITOR_H
+
+#include <QtTest>
+#include "latencymonitor.h"
+
+class TestLatencyMonitor : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void testBucketBounds();
+	void testPercentiles();
+	void testConcurrentRecording();
+	void testStagesAndCsv();
+};
+
+#endif // TEST_LATENCYMONITOR_H
\ No newline at end of file
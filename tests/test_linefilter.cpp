@@ -0,0 +1,132 @@
+#include "test_linefilter.h"
+
+void TestLineFilter::testKernelsMatchScalar_data()
+{
+	QTest::addColumn<int>("filter");
+	QTest::addColumn<int>("halfWidth");
+	QTest::newRow("boxcar 4") << static_cast<int>(FILTER_BOXCAR) << 4;
+	QTest::newRow("savitzky-golay 5") << static_cast<int>(FILTER_SAVITZKY_GOLAY) << 5;
+	QTest::newRow("gaussian 9") << static_cast<int>(FILTER_GAUSSIAN) << 9;
+}
+
+void TestLineFilter::testKernelsMatchScalar()
+{
+	QFETCH(int, filter);
+	QFETCH(int, halfWidth);
+	
+	//odd length so vector kernels have to process remaining samples with the scalar loop
+	QVector<qreal> line = TestPattern::line(1003);
+	LineFilter lineFilter;
+	lineFilter.setFilter(static_cast<LINE_FILTER>(filter), halfWidth);
+	
+	QVector<qreal> expected = line;
+	lineFilter.apply(expected.data(), expected.size(), KERNEL_SCALAR);
+	
+	QList<SIMD_KERNEL> kernels = {KERNEL_SSE2, KERNEL_AVX2, KERNEL_AVX512};
+	for (SIMD_KERNEL kernel : kernels) {
+		if (!CpuFeatures::isSupported(kernel)) {
+			qDebug() << "Kernel not supported on this CPU:" << kernel;
+			continue;
+		}
+		QVector<qreal> filtered = line;
+		lineFilter.apply(filtered.data(), filtered.size(), kernel);
+		for (int i = 0; i < line.size(); i++) {
+			QVERIFY(qAbs(filtered.at(i) - expected.at(i)) < 1e-9);
+		}
+	}
+}
+
+void TestLineFilter::testConstantLine()
+{
+	//all kernels have a gain of 1 and the borders are padded with the outermost samples
+	QList<LINE_FILTER> filters = {FILTER_BOXCAR, FILTER_SAVITZKY_GOLAY, FILTER_GAUSSIAN};
+	for (LINE_FILTER filter : filters) {
+		LineFilter lineFilter;
+		lineFilter.setFilter(filter, 6);
+		QVector<qreal> line(50, 42.0);
+		lineFilter.apply(line.data(), line.size());
+		for (int i = 0; i < line.size(); i++) {
+			QVERIFY(qAbs(line.at(i) - 42.0) < 1e-9);
+		}
+	}
+}
+
+void TestLineFilter::testPolynomialPreserved()
+{
+	//away from the borders savitzky-golay reproduces a parabola and the boxcar reproduces a ramp
+	const int halfWidth = 4;
+	QVector<qreal> parabola(60);
+	QVector<qreal> ramp(60);
+	for (int i = 0; i < parabola.size(); i++) {
+		parabola[i] = 100.0 - 0.25*(i-30)*(i-30);
+		ramp[i] = 3.0*i + 1.0;
+	}
+	
+	LineFilter savitzkyGolay;
+	savitzkyGolay.setFilter(FILTER_SAVITZKY_GOLAY, halfWidth);
+	QVector<qreal> filteredParabola = parabola;
+	savitzkyGolay.apply(filteredParabola.data(), filteredParabola.size());
+	
+	LineFilter boxcar;
+	boxcar.setFilter(FILTER_BOXCAR, halfWidth);
+	QVector<qreal> filteredRamp = ramp;
+	boxcar.apply(filteredRamp.data(), filteredRamp.size());
+	
+	for (int i = halfWidth; i < parabola.size() - halfWidth; i++) {
+		QVERIFY(qAbs(filteredParabola.at(i) - parabola.at(i)) < 1e-9);
+		QVERIFY(qAbs(filteredRamp.at(i) - ramp.at(i)) < 1e-9);
+	}
+}
+
+void TestLineFilter::testGaussianCoefficients()
+{
+	LineFilter lineFilter;
+	lineFilter.setFilter(FILTER_GAUSSIAN, 6);
+	const QVector<qreal>& coefficients = lineFilter.getCoefficients();
+	QCOMPARE(coefficients.size(), 13);
+	
+	qreal sum = 0.0;
+	for (int i = 0; i < coefficients.size(); i++) {
+		sum += coefficients.at(i);
+		QVERIFY(qAbs(coefficients.at(i) - coefficients.at(coefficients.size()-1-i)) < 1e-15);
+	}
+	QVERIFY(qAbs(sum - 1.0) < 1e-12);
+	QVERIFY(coefficients.at(6) > coefficients.at(5));
+	
+	//unknown filter types and a half width of 0 disable the filter
+	lineFilter.setFilter(FILTER_GAUSSIAN, 0);
+	QVERIFY(!lineFilter.isActive());
+	lineFilter.setFilter(static_cast<LINE_FILTER>(42), 3);
+	QCOMPARE(lineFilter.getType(), FILTER_NONE);
+}
+
+void TestLineFilter::testFilterSuppressesSpike()
+{
+	//a single sample spike is higher than the broad peak, only the filtered line shows the broad peak as maximum
+	const unsigned int samplesPerLine = 40;
+	QVector<unsigned char> frame(samplesPerLine, 10);
+	frame[8] = 200;
+	for (int i = 25; i <= 31; i++) {
+		frame[i] = 150;
+	}
+	
+	PeakFinder peakFinder;
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.minThreshold = 0.0;
+	params.roi = QRect(0, 0, samplesPerLine, 1);
+	params.lineFilter = FILTER_NONE;
+	params.lineFilterHalfWidth = 3;
+	peakFinder.setParams(params);
+	
+	QSignalSpy spy(&peakFinder, &PeakFinder::peakPositionFound);
+	peakFinder.findPeak(frame.data(), 8, samplesPerLine, 1);
+	
+	params.lineFilter = FILTER_BOXCAR;
+	peakFinder.setParams(params);
+	peakFinder.findPeak(frame.data(), 8, samplesPerLine, 1);
+	
+	QCOMPARE(spy.count(), 2);
+	QCOMPARE(spy.at(0).at(0).toDouble(), 8.0);
+	QCOMPARE(spy.at(1).at(0).toDouble(), 28.0);
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef TEST_LINEFILTER_H
+#define TEST_LINEFILTER_H
+
+#include <QtTest>
+#include "linefilter.h"
+#include "peakfinder.h"
+#include "testpattern.h"
+
+class TestLineFilter : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void testKernelsMatchScalar_data();
+	void testKernelsMatchScalar();
+	void testConstantLine();
+	void testPolynomialPreserved();
+	void testGaussianCoefficients();
+	void testFilterSuppressesSpike();
+};
+
+#endif // TEST_LINEFILTER_H
\ No newline at end of file
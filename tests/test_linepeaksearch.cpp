@@ -0,0 +1,80 @@
+#include "test_linepeaksearch.h"
+
+void TestLinePeakSearch::testKernelsMatchScalar_data()
+{
+	QTest::addColumn<int>("bitDepth");
+	QTest::newRow("8 bit") << 8;
+	QTest::newRow("12 bit") << 12;
+	QTest::newRow("16 bit") << 16;
+	QTest::newRow("32 bit") << 32;
+}
+
+void TestLinePeakSearch::testKernelsMatchScalar()
+{
+	QFETCH(int, bitDepth);
+	
+	//odd roi width so vector kernels have to process remaining samples with the scalar loop. Small value range, so
+	//the maximum occurs several times per line and the first occurrence has to be found
+	const unsigned int samplesPerLine = 211;
+	const unsigned int linesPerFrame = 97;
+	QByteArray frame = TestPattern::frame(bitDepth, samplesPerLine, linesPerFrame, 61);
+	QRect roi(5, 3, 177, 90);
+	
+	QVector<int> expected(roi.height());
+	int expectedCount = LinePeakSearch::findLinePeaks(frame.constData(), bitDepth, samplesPerLine, roi, 0, expected.data(), KERNEL_SCALAR);
+	QCOMPARE(expectedCount, roi.height());
+	
+	QList<SIMD_KERNEL> kernels = {KERNEL_SSE2, KERNEL_AVX2, KERNEL_AVX512};
+	for (SIMD_KERNEL kernel : kernels) {
+		if (!CpuFeatures::isSupported(kernel)) {
+			qDebug() << "Kernel not supported on this CPU:" << kernel;
+			continue;
+		}
+		QVector<int> positions(roi.height(), -2);
+		int count = LinePeakSearch::findLinePeaks(frame.constData(), bitDepth, samplesPerLine, roi, 0, positions.data(), kernel);
+		QCOMPARE(count, expectedCount);
+		QCOMPARE(positions, expected);
+	}
+}
+
+void TestLinePeakSearch::testThreshold()
+{
+	//second line stays below threshold, peak of first line is found at its first occurrence
+	quint16 frame[2*40] = {};
+	frame[17] = 900;
+	frame[33] = 900;
+	frame[40 + 20] = 300;
+	QRect roi(0, 0, 40, 2);
+	
+	QList<SIMD_KERNEL> kernels = {KERNEL_SCALAR, KERNEL_SSE2, KERNEL_AVX2, KERNEL_AVX512};
+	for (SIMD_KERNEL kernel : kernels) {
+		if (!CpuFeatures::isSupported(kernel)) {
+			continue;
+		}
+		int positions[2];
+		QCOMPARE(LinePeakSearch::findLinePeaks(frame, 16, 40, roi, 500, positions, kernel), 1);
+		QCOMPARE(positions[0], 17);
+		QCOMPARE(positions[1], -1);
+	}
+}
+
+void TestLinePeakSearch::testSurfaceStatistics()
+{
+	//tilted flat surface with one line without peak
+	SurfaceProfile profile;
+	profile.firstLine = 10;
+	profile.positions = {100, 102, -1, 106, 108};
+	profile.updateStatistics();
+	
+	QCOMPARE(profile.validLines, 4);
+	QVERIFY(qAbs(profile.mean - 104.0) < 1e-9);
+	QVERIFY(qAbs(profile.slope - 2.0) < 1e-9);
+	QVERIFY(qAbs(profile.rms) < 1e-9);
+	
+	//deviation of +-1 around a horizontal surface
+	profile.positions = {51, 49, 49, 51};
+	profile.updateStatistics();
+	QVERIFY(qAbs(profile.mean - 50.0) < 1e-9);
+	QVERIFY(qAbs(profile.slope) < 1e-9);
+	QVERIFY(qAbs(profile.rms - 1.0) < 1e-9);
+}
\ No newline at end of file
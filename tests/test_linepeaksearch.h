@@ -0,0 +1,20 @@
+#ifndef TEST_LINEPEAKSEARCH_H
+#define TEST_LINEPEAKSEARCH_H
+
+#include <QtTest>
+#include "linepeaksearch.h"
+#include "surfaceprofile.h"
+#include "testpattern.h"
+
+class TestLinePeakSearch : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void testKernelsMatchScalar_data();
+	void testKernelsMatchScalar();
+	void testThreshold();
+	void testSurfaceStatistics();
+};
+
+#endif // TEST_LINEPEAKSEARCH_H
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "test_multipeaksearch.h"
+
+void TestMultiPeakSearch::testProminence()
+{
+	MultiPeakSearch search;
+	
+	//left base of the first peak is the border of the line, the second peak is limited by the valley to the first one
+	qreal line[7] = {0, 10, 2, 5, 1, 3, 2};
+	int peakCount = search.findPeaks(line, 7, 0, 5, 1, 0);
+	
+	QCOMPARE(peakCount, 3);
+	QCOMPARE(search.getPeaks().at(0).position, 1);
+	QCOMPARE(search.getPeaks().at(0).prominence, 9.0);
+	QCOMPARE(search.getPeaks().at(1).position, 3);
+	QCOMPARE(search.getPeaks().at(1).prominence, 3.0);
+	QCOMPARE(search.getPeaks().at(2).position, 5);
+	QCOMPARE(search.getPeaks().at(2).prominence, 1.0);
+	
+	//small side lobe is removed by the prominence limit
+	peakCount = search.findPeaks(line, 7, 0, 5, 1, 2);
+	QCOMPARE(peakCount, 2);
+	QCOMPARE(search.getPeaks().at(1).position, 3);
+}
+
+void TestMultiPeakSearch::testStrongestPeaks()
+{
+	MultiPeakSearch search;
+	
+	//only the two highest peaks are kept, result is ordered by position
+	qreal line[11] = {0, 3, 0, 9, 0, 4, 0, 7, 0, 2, 0};
+	int peakCount = search.findPeaks(line, 11, 0, 2, 1, 0);
+	
+	QCOMPARE(peakCount, 2);
+	QCOMPARE(search.getPeaks().at(0).position, 3);
+	QCOMPARE(search.getPeaks().at(0).height, 9.0);
+	QCOMPARE(search.getPeaks().at(1).position, 7);
+	QCOMPARE(search.getPeaks().at(1).height, 7.0);
+}
+
+void TestMultiPeakSearch::testMinDistance()
+{
+	MultiPeakSearch search;
+	
+	//peak at 3 is too close to the higher one at 5 and still suppresses the peak at 1
+	qreal line[11] = {0, 4, 0, 6, 0, 8, 0, 0, 0, 5, 0};
+	int peakCount = search.findPeaks(line, 11, 0, 5, 3, 0);
+	
+	QCOMPARE(peakCount, 2);
+	QCOMPARE(search.getPeaks().at(0).position, 5);
+	QCOMPARE(search.getPeaks().at(1).position, 9);
+	
+	//all peaks are at least 2 samples apart
+	peakCount = search.findPeaks(line, 11, 0, 5, 2, 0);
+	QCOMPARE(peakCount, 4);
+}
+
+void TestMultiPeakSearch::testThresholdAndPlateau()
+{
+	MultiPeakSearch search;
+	
+	//flat peak is located at the center of the plateau, rising edge into a higher plateau is no peak
+	qreal line[12] = {0, 2, 6, 6, 6, 1, 1, 3, 3, 4, 0, 0};
+	int peakCount = search.findPeaks(line, 12, 0, 5, 1, 0);
+	
+	QCOMPARE(peakCount, 2);
+	QCOMPARE(search.getPeaks().at(0).position, 3);
+	QCOMPARE(search.getPeaks().at(1).position, 9);
+	
+	//peaks at or below threshold are ignored
+	peakCount = search.findPeaks(line, 12, 4, 5, 1, 0);
+	QCOMPARE(peakCount, 1);
+	QCOMPARE(search.getPeaks().at(0).position, 3);
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#ifndef TEST_MULTIPEAKSEARCH_H
+#define TEST_MULTIPEAKSEARCH_H
+
+#include <QtTest>
+#include "multipeaksearch.h"
+
+class TestMultiPeakSearch : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void testProminence();
+	void testStrongestPeaks();
+	void testMinDistance();
+	void testThresholdAndPlateau();
+};
+
+#endif // TEST_MULTIPEAKSEARCH_H
\ No newline at end of file
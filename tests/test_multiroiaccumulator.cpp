@@ -0,0 +1,151 @@
+#include "test_multiroiaccumulator.h"
+
+void TestMultiRoiAccumulator::testMatchesColumnAccumulator_data()
+{
+	QTest::addColumn<int>("bitDepth");
+	QTest::addColumn<int>("kernel");
+	QTest::newRow("8 bit scalar") << 8 << static_cast<int>(KERNEL_SCALAR);
+	QTest::newRow("8 bit avx2") << 8 << static_cast<int>(KERNEL_AVX2);
+	QTest::newRow("16 bit scalar") << 16 << static_cast<int>(KERNEL_SCALAR);
+	QTest::newRow("16 bit sse2") << 16 << static_cast<int>(KERNEL_SSE2);
+	QTest::newRow("32 bit scalar") << 32 << static_cast<int>(KERNEL_SCALAR);
+	QTest::newRow("32 bit avx512") << 32 << static_cast<int>(KERNEL_AVX512);
+}
+
+void TestMultiRoiAccumulator::testMatchesColumnAccumulator()
+{
+	QFETCH(int, bitDepth);
+	QFETCH(int, kernel);
+	if (!CpuFeatures::isSupported(static_cast<SIMD_KERNEL>(kernel))) {
+		QSKIP("Kernel not supported by this cpu");
+	}
+	
+	const unsigned int samplesPerLine = 120;
+	const unsigned int linesPerFrame = 90;
+	QByteArray frame = TestPattern::frame(bitDepth, samplesPerLine, linesPerFrame);
+	
+	//overlapping, nested, touching and separate rois, every roi has to get the same sums as if it was accumulated alone
+	QVector<QRect> rois = {QRect(10, 5, 60, 40), QRect(30, 20, 70, 50), QRect(35, 25, 10, 5), QRect(70, 5, 20, 10), QRect(0, 80, 120, 10), QRect(100, 0, 1, 90)};
+	MultiRoiAccumulator accumulator;
+	accumulator.accumulate(frame.constData(), bitDepth, samplesPerLine, rois, static_cast<SIMD_KERNEL>(kernel));
+	QCOMPARE(accumulator.getRoiCount(), rois.size());
+	for (int i = 0; i < rois.size(); i++) {
+		const QRect& roi = rois.at(i);
+		QVector<quint64> expected(roi.width());
+		ColumnAccumulator::accumulate(frame.constData(), bitDepth, samplesPerLine, roi, expected.data(), KERNEL_SCALAR);
+		QVector<quint64> sums(roi.width());
+		memcpy(sums.data(), accumulator.getColumnSums(i), static_cast<size_t>(roi.width())*sizeof(quint64));
+		QCOMPARE(sums, expected);
+	}
+}
+
+void TestMultiRoiAccumulator::testEmptyRois()
+{
+	//empty rois keep their index, so the sums of the other rois are still found at the same position
+	QVector<quint8> frame(20*10, 3);
+	QVector<QRect> rois = {QRect(), QRect(2, 1, 5, 4), QRect(0, 0, 0, 10)};
+	MultiRoiAccumulator accumulator;
+	accumulator.accumulate(frame.constData(), 8, 20, rois);
+	QCOMPARE(accumulator.getRoiCount(), 3);
+	QCOMPARE(accumulator.getColumnSums(1)[0], static_cast<quint64>(12));
+	QCOMPARE(accumulator.getColumnSums(1)[4], static_cast<quint64>(12));
+	
+	accumulator.accumulate(frame.constData(), 8, 20, QVector<QRect>());
+	QCOMPARE(accumulator.getRoiCount(), 0);
+}
+
+void TestMultiRoiAccumulator::testBatchedRoiPeaks()
+{
+	//reference surface in the upper half and sample surface in the lower half of the frame
+	const unsigned int samplesPerLine = 60;
+	const unsigned int linesPerFrame = 40;
+	QVector<unsigned char> frame(samplesPerLine*linesPerFrame, 10);
+	for (unsigned int y = 0; y < 20; y++) {
+		frame[y*samplesPerLine + 15] = 200;
+	}
+	for (unsigned int y = 20; y < linesPerFrame; y++) {
+		frame[y*samplesPerLine + 42] = 200;
+	}
+	
+	qRegisterMetaType<QVector<RoiPeak>>("QVector<RoiPeak>");
+	PeakFinder peakFinder;
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.minThreshold = 0.0;
+	params.roi = QRect(0, 0, samplesPerLine, 20);
+	params.roiName = "reference";
+	NamedRoi sample;
+	sample.name = "sample";
+	sample.rect = QRect(30, 20, 30, 20);
+	NamedRoi outside;
+	outside.name = "outside";
+	outside.rect = QRect(100, 100, 10, 10);
+	params.additionalRois = {sample, outside};
+	peakFinder.setParams(params);
+	
+	QSignalSpy spy(&peakFinder, &PeakFinder::roiPeaksFound);
+	QVector<unsigned char> frames = frame + frame;
+	peakFinder.findPeaks(frames.data(), 8, samplesPerLine, linesPerFrame, 2);
+	
+	//one message for the whole batch with the results of all rois
+	QCOMPARE(spy.count(), 1);
+	QVector<RoiPeak> peaks = spy.at(0).at(0).value<QVector<RoiPeak>>();
+	QCOMPARE(peaks.size(), 3);
+	QCOMPARE(peaks.at(0).name, QString("reference"));
+	QCOMPARE(peaks.at(0).position, 15.0);
+	QCOMPARE(peaks.at(1).name, QString("sample"));
+	QCOMPARE(peaks.at(1).roi, QRect(30, 20, 30, 20));
+	QCOMPARE(peaks.at(1).position, 42.0);
+	QCOMPARE(peaks.at(1).value, 200.0);
+	QCOMPARE(peaks.at(2).name, QString("outside"));
+	QCOMPARE(peaks.at(2).position, -1.0);
+	
+	//robust row aggregation can not share column sums, but has to give the same positions
+	params.rowAggregation = AGGREGATION_MEDIAN;
+	peakFinder.setParams(params);
+	peakFinder.findPeak(frame.data(), 8, samplesPerLine, linesPerFrame);
+	QCOMPARE(spy.count(), 2);
+	peaks = spy.at(1).at(0).value<QVector<RoiPeak>>();
+	QCOMPARE(peaks.at(0).position, 15.0);
+	QCOMPARE(peaks.at(1).position, 42.0);
+}
+
+void TestMultiRoiAccumulator::testBatchedRoiPeaksFromIntegralTable()
+{
+	const unsigned int samplesPerLine = 60;
+	const unsigned int linesPerFrame = 40;
+	QVector<unsigned char> frame(samplesPerLine*linesPerFrame, 10);
+	for (unsigned int y = 20; y < linesPerFrame; y++) {
+		frame[y*samplesPerLine + 42] = 200;
+		frame[y*samplesPerLine + 7] = 150;
+	}
+	
+	qRegisterMetaType<QVector<RoiPeak>>("QVector<RoiPeak>");
+	PeakFinder peakFinder;
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.minThreshold = 0.0;
+	params.roi = QRect(0, 20, samplesPerLine, 20);
+	params.roiName = "main";
+	params.integralTableEnabled = true;
+	NamedRoi left;
+	left.name = "left";
+	left.rect = QRect(0, 0, 20, 40);
+	params.additionalRois = {left};
+	peakFinder.setParams(params);
+	
+	QSignalSpy spy(&peakFinder, &PeakFinder::roiPeaksFound);
+	peakFinder.findPeak(frame.data(), 8, samplesPerLine, linesPerFrame);
+	frame.fill(0);
+	
+	//moving an additional roi reads it out of the integral table of the last frame
+	params.additionalRois[0].rect = QRect(30, 20, 30, 20);
+	peakFinder.setParams(params);
+	
+	QTRY_COMPARE(spy.count(), 2);
+	QCOMPARE(spy.at(0).at(0).value<QVector<RoiPeak>>().at(1).position, 7.0);
+	QVector<RoiPeak> peaks = spy.at(1).at(0).value<QVector<RoiPeak>>();
+	QCOMPARE(peaks.at(0).position, 42.0);
+	QCOMPARE(peaks.at(1).name, QString("left"));
+	QCOMPARE(peaks.at(1).position, 42.0);
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef TEST_MULTIROIACCUMULATOR_H
+#define TEST_MULTIROIACCUMULATOR_H
+
+#include <QtTest>
+#include "multiroiaccumulator.h"
+#include "columnaccumulator.h"
+#include "peakfinder.h"
+#include "testpattern.h"
+
+class TestMultiRoiAccumulator : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void testMatchesColumnAccumulator_data();
+	void testMatchesColumnAccumulator();
+	void testEmptyRois();
+	void testBatchedRoiPeaks();
+	void testBatchedRoiPeaksFromIntegralTable();
+};
+
+#endif // TEST_MULTIROIACCUMULATOR_H
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "test_noisefloorestimator.h"
+#include <algorithm>
+
+static double sortedMedian(QVector<qreal> values)
+{
+	std::sort(values.begin(), values.end());
+	int n = values.size();
+	return n % 2 != 0 ? values.at(n/2) : 0.5*(values.at(n/2-1) + values.at(n/2));
+}
+
+void TestNoiseFloorEstimator::testOddAndEvenLength()
+{
+	NoiseFloorEstimator estimator;
+	
+	//median 3, deviations 2 1 0 1 97 with median 1
+	qreal oddLine[5] = {1, 2, 3, 4, 100};
+	QCOMPARE(estimator.estimate(oddLine, 5, 2.0), 5.0);
+	QCOMPARE(estimator.getMedian(), 3.0);
+	QCOMPARE(estimator.getMad(), 1.0);
+	
+	//median 3.5, deviations 2.5 0.5 0.5 1.5 with median 1
+	qreal evenLine[4] = {1, 4, 3, 5};
+	QCOMPARE(estimator.estimate(evenLine, 4, 3.0), 6.5);
+	QCOMPARE(estimator.getMedian(), 3.5);
+	QCOMPARE(estimator.getMad(), 1.0);
+	
+	//input line is not reordered
+	QCOMPARE(evenLine[1], 4.0);
+	QCOMPARE(estimator.estimate(nullptr, 0, 3.0), 0.0);
+}
+
+void TestNoiseFloorEstimator::testMatchesSortedReference()
+{
+	NoiseFloorEstimator estimator;
+	quint32 seed = 12345;
+	for (int length = 1; length < 300; length += 7) {
+		QVector<qreal> line(length);
+		for (int i = 0; i < length; i++) {
+			seed = seed*1664525u + 1013904223u;
+			line[i] = static_cast<qreal>((seed >> 8) % 1000);
+		}
+		double median = sortedMedian(line);
+		QVector<qreal> deviations(length);
+		for (int i = 0; i < length; i++) {
+			deviations[i] = qAbs(line.at(i) - median);
+		}
+		double mad = sortedMedian(deviations);
+		
+		QCOMPARE(estimator.estimate(line.constData(), length, 4.0), median + 4.0*mad);
+		QCOMPARE(estimator.getMedian(), median);
+		QCOMPARE(estimator.getMad(), mad);
+	}
+}
+
+void TestNoiseFloorEstimator::testAdaptiveThresholdFollowsGain()
+{
+	//same frame at two gains: noise of 8 to 12 around a median of 10 with a peak at 40, a fixed threshold between the two peak heights
+	//only accepts the peak of the stronger frame while the adaptive threshold accepts both
+	const unsigned int samplesPerLine = 64;
+	const unsigned int linesPerFrame = 4;
+	QVector<quint16> lowGain(samplesPerLine*linesPerFrame);
+	QVector<quint16> highGain(samplesPerLine*linesPerFrame);
+	for (unsigned int i = 0; i < samplesPerLine*linesPerFrame; i++) {
+		quint16 value = (i % samplesPerLine) == 40 ? 60 : static_cast<quint16>(8 + (i*7) % 5);
+		lowGain[i] = value;
+		highGain[i] = static_cast<quint16>(value*20);
+	}
+	
+	PeakFinder peakFinder;
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.roi = QRect(0, 0, samplesPerLine, linesPerFrame);
+	params.thresholdMode = THRESHOLD_FIXED;
+	params.minThreshold = 100.0;
+	params.noiseFactor = DEFAULT_NOISE_FACTOR;
+	peakFinder.setParams(params);
+	
+	QSignalSpy spy(&peakFinder, &PeakFinder::peakPositionFound);
+	QSignalSpy thresholdSpy(&peakFinder, &PeakFinder::thresholdEstimated);
+	peakFinder.findPeak(lowGain.data(), 16, samplesPerLine, linesPerFrame);
+	peakFinder.findPeak(highGain.data(), 16, samplesPerLine, linesPerFrame);
+	QCOMPARE(spy.count(), 2);
+	QCOMPARE(spy.at(0).at(0).toDouble(), -1.0);
+	QCOMPARE(spy.at(1).at(0).toDouble(), 40.0);
+	QCOMPARE(thresholdSpy.count(), 0);
+	
+	params.thresholdMode = THRESHOLD_ADAPTIVE;
+	peakFinder.setParams(params);
+	spy.clear();
+	peakFinder.findPeak(lowGain.data(), 16, samplesPerLine, linesPerFrame);
+	peakFinder.findPeak(highGain.data(), 16, samplesPerLine, linesPerFrame);
+	QCOMPARE(spy.count(), 2);
+	QCOMPARE(spy.at(0).at(0).toDouble(), 40.0);
+	QCOMPARE(spy.at(1).at(0).toDouble(), 40.0);
+	
+	//estimated threshold scales with the gain and lies between noise and peak
+	QCOMPARE(thresholdSpy.count(), 2);
+	double lowThreshold = thresholdSpy.at(0).at(0).toDouble();
+	double highThreshold = thresholdSpy.at(1).at(0).toDouble();
+	QVERIFY(lowThreshold > 10.0 && lowThreshold < 60.0);
+	QVERIFY(qAbs(highThreshold - 20.0*lowThreshold) < 1e-6);
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#ifndef TEST_NOISEFLOORESTIMATOR_H
+#define TEST_NOISEFLOORESTIMATOR_H
+
+#include <QtTest>
+#include "noisefloorestimator.h"
+#include "peakfinder.h"
+
+class TestNoiseFloorEstimator : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void testOddAndEvenLength();
+	void testMatchesSortedReference();
+	void testAdaptiveThresholdFollowsGain();
+};
+
+#endif // TEST_NOISEFLOORESTIMATOR_H
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "test_peakfinder.h"
+#include "columnaccumulator.h"
 
 void TestPeakFinder::testFindMaxValuePosition()
 {
@@ -101,4 +102,437 @@ void TestPeakFinder::testThreshold()
 	//verify only the peak >= threshold was found (should be position 2, value 5)
 	int peakPos = spy.at(0).at(0).toInt();
 	QCOMPARE(peakPos, 2);
+}
+
+void TestPeakFinder::testFindPeaksBatch()
+{
+	PeakFinder peakFinder;
+	
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.minThreshold = 0.0;
+	params.roi = QRect(0, 0, 5, 1);
+	params.showMinThreshold = false;
+	params.autoScalingEnabled = true;
+	peakFinder.setParams(params);
+	
+	QSignalSpy spy(&peakFinder, &PeakFinder::peakPositionFound);
+	
+	//three 5x1 frames with peaks at different positions
+	unsigned char frames[15] = {
+		1, 3, 5, 2, 4,
+		9, 3, 5, 2, 4,
+		1, 3, 5, 2, 8
+	};
+	
+	peakFinder.findPeaks(frames, 8, 5, 1, 3);
+	
+	//whole batch is processed in one call and only one result is emitted
+	QCOMPARE(spy.count(), 1);
+	
+	//emitted position belongs to the last frame of the batch
+	int peakPos = spy.at(0).at(0).toInt();
+	QCOMPARE(peakPos, 4);
+}
+
+void TestPeakFinder::testFindPeaksInFrames()
+{
+	PeakFinder peakFinder;
+	
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.minThreshold = 6.0;
+	params.roi = QRect(0, 0, 5, 1);
+	params.showMinThreshold = false;
+	params.autoScalingEnabled = true;
+	peakFinder.setParams(params);
+	
+	QSignalSpy spy(&peakFinder, &PeakFinder::peakPositionFound);
+	
+	//three 5x1 frames, the second one has no peak above the threshold
+	unsigned char frames[15] = {
+		1, 3, 9, 2, 4,
+		1, 3, 5, 2, 4,
+		1, 3, 5, 2, 8
+	};
+	double positions[3];
+	double amplitudes[3];
+	quint8 flags[3];
+	
+	int foundPeaks = peakFinder.findPeaksInFrames(FrameView::fullFrame(frames, 8, 5, 1), 3, 5, positions, amplitudes, flags);
+	
+	//all frames are written to the outputs and nothing is emitted
+	QCOMPARE(foundPeaks, 2);
+	QCOMPARE(spy.count(), 0);
+	QCOMPARE(positions[0], 2.0);
+	QCOMPARE(positions[1], -1.0);
+	QCOMPARE(positions[2], 4.0);
+	QCOMPARE(amplitudes[0], 9.0);
+	QCOMPARE(amplitudes[1], 0.0);
+	QCOMPARE(amplitudes[2], 8.0);
+	QCOMPARE(static_cast<int>(flags[0]), PEAK_FLAG_FOUND);
+	QCOMPARE(static_cast<int>(flags[1]), 0);
+	QCOMPARE(static_cast<int>(flags[2]), PEAK_FLAG_FOUND);
+}
+
+void TestPeakFinder::testColumnSumsMatchFrame()
+{
+	PeakFinder peakFinder;
+	
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.minThreshold = 0.0;
+	params.roi = QRect(1, 0, 4, 2);
+	params.showMinThreshold = false;
+	params.autoScalingEnabled = true;
+	peakFinder.setParams(params);
+	
+	QSignalSpy lineSpy(&peakFinder, &PeakFinder::averagedLineCalculated);
+	QSignalSpy peakSpy(&peakFinder, &PeakFinder::peakPositionFound);
+	
+	//5x2 frame, 16-bit test data
+	unsigned short frame[10] = {
+		100, 300, 500, 200, 400,
+		900, 100, 700, 200, 100
+	};
+	
+	//reduce ROI while "copying" and compare result with regular frame analysis
+	QRect roi = PeakFinder::clampRoi(params.roi, 5, 2);
+	quint64 columnSums[4];
+	ColumnAccumulator::accumulate(frame, 16, 5, roi, columnSums);
+	QCOMPARE(columnSums[1], quint64(1200));
+	
+	peakFinder.findPeak(frame, 16, 5, 2);
+	peakFinder.findPeaksInColumnSums(columnSums, roi, 5, 1);
+	
+	QCOMPARE(lineSpy.count(), 2);
+	QCOMPARE(lineSpy.at(0).at(0).value<QVector<qreal>>(), lineSpy.at(1).at(0).value<QVector<qreal>>());
+	QCOMPARE(peakSpy.at(0).at(0).toInt(), 2);
+	QCOMPARE(peakSpy.at(1).at(0).toInt(), 2);
+}
+
+void TestPeakFinder::testColumnSumsBatch()
+{
+	//slot with the column sums of three frames and no frame data, as provided by the fused ingest
+	const unsigned int samplesPerLine = 5;
+	const unsigned int linesPerFrame = 2;
+	unsigned short frames[30] = {
+		100, 300, 500, 200, 400,
+		900, 100, 700, 200, 100,
+		100, 100, 100, 900, 100,
+		100, 100, 100, 900, 100,
+		100, 100, 100, 100, 100,
+		100, 100, 100, 100, 100
+	};
+	QRect roi(1, 0, 4, 2);
+	quint64 columnSums[12];
+	for (int i = 0; i < 3; i++) {
+		ColumnAccumulator::accumulate(frames + i*samplesPerLine*linesPerFrame, 16, samplesPerLine, roi, columnSums + i*roi.width());
+	}
+	FrameSlot slot;
+	slot.data = nullptr;
+	slot.bitDepth = 16;
+	slot.samplesPerLine = samplesPerLine;
+	slot.linesPerFrame = linesPerFrame;
+	slot.frameCount = 3;
+	slot.columnSums = columnSums;
+	slot.roi = roi;
+	slot.region = QRect();
+	slot.stride = samplesPerLine;
+	slot.bytesPerFrame = samplesPerLine*linesPerFrame*2;
+	slot.hasFrameData = false;
+	slot.hasColumnSums = true;
+	slot.timestampNs = 1000;
+	slot.bufferNr = 7;
+	slot.firstFrameNr = 3;
+	slot.dataFrameNr = -1;
+
+	qRegisterMetaType<FrameSlot*>("FrameSlot*");
+	qRegisterMetaType<PeakBatch>("PeakBatch");
+	PeakFinder peakFinder;
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.minThreshold = 150.0;
+	params.roi = roi;
+	peakFinder.setParams(params);
+
+	//every frame of the slot is part of the batch, not only the last one
+	QSignalSpy batchSpy(&peakFinder, &PeakFinder::peakBatchFound);
+	peakFinder.processFrameSlot(&slot);
+	QCOMPARE(batchSpy.count(), 1);
+	PeakBatch batch = batchSpy.at(0).at(0).value<PeakBatch>();
+	QCOMPARE(batch.frameCount, 3);
+	QCOMPARE(batch.positions.size(), 3);
+	QCOMPARE(batch.bufferNr, 7);
+	QCOMPARE(batch.firstFrameNr, 3);
+	QCOMPARE(batch.positions.at(0), 2.0);
+	QCOMPARE(batch.positions.at(1), 3.0);
+	QCOMPARE(batch.positions.at(2), -1.0);
+	QCOMPARE(batch.amplitudes.at(0), 600.0);
+	QCOMPARE(batch.amplitudes.at(1), 900.0);
+	QCOMPARE(batch.flags.at(0), quint8(PEAK_FLAG_FOUND));
+	QCOMPARE(batch.flags.at(2), quint8(0));
+}
+
+void TestPeakFinder::testRoiOnlyViewMatchesFrame()
+{
+	PeakFinder peakFinder;
+	
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.minThreshold = 0.0;
+	params.roi = QRect(1, 1, 3, 2);
+	params.showMinThreshold = false;
+	params.autoScalingEnabled = true;
+	peakFinder.setParams(params);
+	
+	QSignalSpy lineSpy(&peakFinder, &PeakFinder::averagedLineCalculated);
+	QSignalSpy peakSpy(&peakFinder, &PeakFinder::peakPositionFound);
+	
+	//5x3 frame, 8-bit test data
+	unsigned char frame[15] = {
+		9, 9, 9, 9, 9,
+		1, 2, 8, 3, 9,
+		9, 4, 6, 5, 1
+	};
+	
+	//compact copy of the roi with one sample of padding per line
+	unsigned char roiOnly[8] = {
+		2, 8, 3, 0,
+		4, 6, 5, 0
+	};
+	FrameView view = FrameView::fullFrame(roiOnly, 8, 5, 3);
+	view.stride = 4;
+	view.region = QRect(1, 1, 3, 2);
+	
+	peakFinder.findPeak(frame, 8, 5, 3);
+	peakFinder.findPeaksInViews(view, 1, 0);
+	
+	QCOMPARE(lineSpy.count(), 2);
+	QCOMPARE(lineSpy.at(0).at(0).value<QVector<qreal>>(), lineSpy.at(1).at(0).value<QVector<qreal>>());
+	QCOMPARE(peakSpy.at(0).at(0).toInt(), 2);
+	QCOMPARE(peakSpy.at(1).at(0).toInt(), 2);
+}
+
+void TestPeakFinder::testSubsamplePeakPosition()
+{
+	PeakFinder peakFinder;
+	
+	PeakDetectorParameters params;
+	params.feature = PARABOLIC_FIT;
+	params.centroidHalfWidth = 1;
+	params.minThreshold = 0.0;
+	params.roi = QRect(0, 0, 5, 1);
+	params.showMinThreshold = false;
+	params.autoScalingEnabled = true;
+	peakFinder.setParams(params);
+	
+	QSignalSpy spy(&peakFinder, &PeakFinder::peakPositionFound);
+	
+	//maximum at 2, right neighbor larger than left one, so peak lies right of 2
+	unsigned char frame[5] = {1, 4, 8, 6, 1};
+	
+	peakFinder.findPeak(frame, 8, 5, 1);
+	params.feature = CENTROID;
+	peakFinder.setParams(params);
+	peakFinder.findPeak(frame, 8, 5, 1);
+	
+	QCOMPARE(spy.count(), 2);
+	QVERIFY(qAbs(spy.at(0).at(0).toDouble() - (2.0 + 0.5*(4.0-6.0)/(4.0-16.0+6.0))) < 1e-9);
+	QVERIFY(qAbs(spy.at(1).at(0).toDouble() - (0.0*1.0 + 4.0*2.0 + 2.0*3.0)/6.0) < 1e-9);
+}
+
+void TestPeakFinder::testSurfaceProfile()
+{
+	qRegisterMetaType<SurfaceProfile>("SurfaceProfile");
+	PeakFinder peakFinder;
+	
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.minThreshold = 0.0;
+	params.roi = QRect(2, 1, 10, 3);
+	params.showMinThreshold = false;
+	params.autoScalingEnabled = true;
+	params.multiPeakEnabled = false;
+	params.surfaceTrackingEnabled = true;
+	peakFinder.setParams(params);
+	
+	QSignalSpy spy(&peakFinder, &PeakFinder::surfaceProfileFound);
+	
+	//surface tilted by one sample per line, the peak in line 0 is outside of the roi
+	unsigned char frame[4*12] = {};
+	for (int y = 0; y < 4; y++) {
+		frame[y*12 + 4 + y] = 200;
+	}
+	peakFinder.findPeak(frame, 8, 12, 4);
+	
+	QCOMPARE(spy.count(), 1);
+	SurfaceProfile profile = spy.at(0).at(0).value<SurfaceProfile>();
+	QCOMPARE(profile.firstLine, 1);
+	QCOMPARE(profile.positions, QVector<double>({5, 6, 7}));
+	QCOMPARE(profile.validLines, 3);
+	QVERIFY(qAbs(profile.slope - 1.0) < 1e-9);
+}
+
+void TestPeakFinder::testReanalyzeLastFrame()
+{
+	//two peaks in different rows, the frame buffer is cleared after the analysis so only the kept copy can be reanalyzed
+	const unsigned int samplesPerLine = 50;
+	const unsigned int linesPerFrame = 40;
+	QVector<unsigned char> frame(samplesPerLine*linesPerFrame, 10);
+	for (unsigned int y = 0; y < 20; y++) {
+		frame[y*samplesPerLine + 12] = 200;
+	}
+	for (unsigned int y = 20; y < linesPerFrame; y++) {
+		frame[y*samplesPerLine + 37] = 150;
+	}
+	
+	PeakFinder peakFinder;
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.minThreshold = 0.0;
+	params.roi = QRect(0, 0, samplesPerLine, 20);
+	peakFinder.setParams(params);
+	
+	QSignalSpy spy(&peakFinder, &PeakFinder::peakPositionFound);
+	peakFinder.findPeak(frame.data(), 8, samplesPerLine, linesPerFrame);
+	frame.fill(0);
+	
+	//a burst of roi changes while dragging results in a single reanalysis with the final roi
+	for (int i = 0; i < 50; i++) {
+		peakFinder.setRoi(QRect(0, i % 20, samplesPerLine, 20));
+	}
+	peakFinder.setRoi(QRect(0, 20, samplesPerLine, 20));
+	QCOMPARE(spy.count(), 1);
+	QTRY_COMPARE(spy.count(), 2);
+	QTest::qWait(3*REANALYSIS_DELAY_MS);
+	QCOMPARE(spy.count(), 2);
+	QCOMPARE(spy.at(0).at(0).toDouble(), 12.0);
+	QCOMPARE(spy.at(1).at(0).toDouble(), 37.0);
+	
+	//a threshold above the peak removes it, changes that do not affect the analysis are ignored
+	params.roi = QRect(0, 20, samplesPerLine, 20);
+	params.minThreshold = 160.0;
+	peakFinder.setParams(params);
+	QTRY_COMPARE(spy.count(), 3);
+	QCOMPARE(spy.at(2).at(0).toDouble(), -1.0);
+	params.windowState = QByteArray("geometry");
+	peakFinder.setParams(params);
+	QTest::qWait(3*REANALYSIS_DELAY_MS);
+	QCOMPARE(spy.count(), 3);
+}
+
+void TestPeakFinder::testPeakResult()
+{
+	//slot with two frames of a full rate buffer, the result belongs to the second frame
+	const unsigned int samplesPerLine = 32;
+	const unsigned int linesPerFrame = 8;
+	QVector<unsigned char> frames(2*samplesPerLine*linesPerFrame, 10);
+	for (unsigned int i = 0; i < 2*linesPerFrame; i++) {
+		frames[i*samplesPerLine + 20] = 110;
+	}
+	FrameSlot slot;
+	slot.data = reinterpret_cast<char*>(frames.data());
+	slot.bitDepth = 8;
+	slot.samplesPerLine = samplesPerLine;
+	slot.linesPerFrame = linesPerFrame;
+	slot.frameCount = 2;
+	slot.columnSums = nullptr;
+	slot.region = QRect(0, 0, samplesPerLine, linesPerFrame);
+	slot.stride = samplesPerLine;
+	slot.bytesPerFrame = samplesPerLine*linesPerFrame;
+	slot.hasFrameData = true;
+	slot.hasColumnSums = false;
+	slot.timestampNs = 123456789;
+	slot.bufferNr = 3;
+	slot.firstFrameNr = 0;
+	slot.dataFrameNr = 1;
+	
+	qRegisterMetaType<PeakResult>("PeakResult");
+	PeakFinder peakFinder;
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.minThreshold = 0.0;
+	params.roi = QRect(0, 0, samplesPerLine, linesPerFrame);
+	peakFinder.setParams(params);
+	
+	QSignalSpy spy(&peakFinder, &PeakFinder::peakResultFound);
+	peakFinder.processFrameSlot(&slot);
+	QCOMPARE(spy.count(), 1);
+	PeakResult result = spy.at(0).at(0).value<PeakResult>();
+	QCOMPARE(result.timestampNs, static_cast<qint64>(123456789));
+	QCOMPARE(result.bufferNr, 3);
+	QCOMPARE(result.frameNr, 1);
+	QCOMPARE(result.position, 20.0);
+	QCOMPARE(result.amplitude, 110.0);
+	
+	//one sample of 110 among 31 samples of 10: mean 13.125, standard deviation 17.4, snr 5.57
+	QVERIFY(qAbs(result.snr - 5.568) < 0.01);
+	QVERIFY(result.computeNs > 0);
+}
+
+void TestPeakFinder::testKeepLastFrameSlot()
+{
+	//two single frame slots with different peaks, each slot is kept for a reanalysis until the next one arrives
+	const unsigned int samplesPerLine = 32;
+	const unsigned int linesPerFrame = 8;
+	QVector<unsigned char> frames(2*samplesPerLine*linesPerFrame, 10);
+	for (unsigned int y = 0; y < linesPerFrame; y++) {
+		frames[y*samplesPerLine + 5] = 200;
+		frames[(linesPerFrame+y)*samplesPerLine + 25] = 200;
+	}
+	FrameSlot frameSlots[2];
+	for (int i = 0; i < 2; i++) {
+		frameSlots[i].data = reinterpret_cast<char*>(frames.data()) + i*samplesPerLine*linesPerFrame;
+		frameSlots[i].bitDepth = 8;
+		frameSlots[i].samplesPerLine = samplesPerLine;
+		frameSlots[i].linesPerFrame = linesPerFrame;
+		frameSlots[i].frameCount = 1;
+		frameSlots[i].columnSums = nullptr;
+		frameSlots[i].region = QRect(0, 0, samplesPerLine, linesPerFrame);
+		frameSlots[i].stride = samplesPerLine;
+		frameSlots[i].bytesPerFrame = samplesPerLine*linesPerFrame;
+		frameSlots[i].hasFrameData = true;
+		frameSlots[i].hasColumnSums = false;
+		frameSlots[i].timestampNs = 1000 + i;
+		frameSlots[i].bufferNr = i;
+		frameSlots[i].firstFrameNr = 2;
+		frameSlots[i].dataFrameNr = 2;
+	}
+
+	qRegisterMetaType<FrameSlot*>("FrameSlot*");
+	qRegisterMetaType<PeakResult>("PeakResult");
+	PeakFinder peakFinder;
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.minThreshold = 0.0;
+	params.roi = QRect(0, 0, samplesPerLine, linesPerFrame);
+	peakFinder.setParams(params);
+
+	QSignalSpy releaseSpy(&peakFinder, &PeakFinder::frameSlotReleased);
+	QSignalSpy resultSpy(&peakFinder, &PeakFinder::peakResultFound);
+	peakFinder.processFrameSlot(&frameSlots[0]);
+	QCOMPARE(releaseSpy.count(), 0);
+	peakFinder.processFrameSlot(&frameSlots[1]);
+	QCOMPARE(releaseSpy.count(), 1);
+	QCOMPARE(releaseSpy.at(0).at(0).value<FrameSlot*>(), &frameSlots[0]);
+
+	//reanalysis reads the kept slot and publishes the result for its frame
+	params.roi = QRect(16, 0, 16, linesPerFrame);
+	peakFinder.setParams(params);
+	QVERIFY(peakFinder.reanalyzeLastFrame());
+	PeakResult result = resultSpy.last().at(0).value<PeakResult>();
+	QCOMPARE(result.position, 25.0);
+	QCOMPARE(result.bufferNr, 1);
+	QCOMPARE(result.frameNr, 2);
+
+	//producer takes the slot back, the frame is copied so it can still be reanalyzed
+	peakFinder.releaseLastFrame();
+	QCOMPARE(releaseSpy.count(), 2);
+	QCOMPARE(releaseSpy.at(1).at(0).value<FrameSlot*>(), &frameSlots[1]);
+	frames.fill(0);
+	QVERIFY(peakFinder.reanalyzeLastFrame());
+	QCOMPARE(resultSpy.last().at(0).value<PeakResult>().position, 25.0);
+	peakFinder.releaseLastFrame();
+	QCOMPARE(releaseSpy.count(), 2);
 }
\ No newline at end of file
@@ -12,6 +12,16 @@ private slots:
 	void testFindMaxValuePosition();
 	void testEmptyInput();
 	void testThreshold();
+	void testFindPeaksBatch();
+	void testFindPeaksInFrames();
+	void testColumnSumsMatchFrame();
+	void testColumnSumsBatch();
+	void testRoiOnlyViewMatchesFrame();
+	void testSubsamplePeakPosition();
+	void testSurfaceProfile();
+	void testReanalyzeLastFrame();
+	void testPeakResult();
+	void testKeepLastFrameSlot();
 };
 
 #endif // TEST_PEAKFINDER_H
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "test_peakinterpolation.h"
+
+void TestPeakInterpolation::testParabolicFit()
+{
+	//samples of the parabola 100 - (x-4.3)^2, the fit has to find the vertex exactly
+	qreal line[9];
+	for (int i = 0; i < 9; i++) {
+		line[i] = 100.0 - (i-4.3)*(i-4.3);
+	}
+	QVERIFY(qAbs(PeakInterpolation::parabolic(line, 9, 4) - 4.3) < 1e-9);
+}
+
+void TestPeakInterpolation::testGaussianFit()
+{
+	//samples of a gaussian centered at 5.75, the fit in log space has to find the center exactly
+	qreal line[12];
+	for (int i = 0; i < 12; i++) {
+		line[i] = 1000.0*qExp(-(i-5.75)*(i-5.75)/(2.0*1.5*1.5));
+	}
+	QVERIFY(qAbs(PeakInterpolation::gaussian(line, 12, 6) - 5.75) < 1e-9);
+	
+	//parabolic fit of the same peak is biased
+	QVERIFY(qAbs(PeakInterpolation::parabolic(line, 12, 6) - 5.75) > 1e-3);
+}
+
+void TestPeakInterpolation::testCentroid()
+{
+	//background of 10 is removed before the centroid is calculated
+	qreal line[9] = {10, 10, 10, 20, 40, 40, 20, 10, 10};
+	QVERIFY(qAbs(PeakInterpolation::centroid(line, 9, 4, 3) - 4.5) < 1e-9);
+	
+	//window is clipped at the border of the line
+	qreal border[4] = {50, 30, 10, 10};
+	QVERIFY(qAbs(PeakInterpolation::centroid(border, 4, 0, 2) - 1.0/3.0) < 1e-9);
+}
+
+void TestPeakInterpolation::testFallbackToIntegerPosition()
+{
+	qreal line[5] = {1, 5, 3, 3, 3};
+	
+	//maximum at border of the line
+	QCOMPARE(PeakInterpolation::parabolic(line, 5, 0), 0.0);
+	QCOMPARE(PeakInterpolation::gaussian(line, 5, 4), 4.0);
+	
+	//flat neighborhood
+	QCOMPARE(PeakInterpolation::parabolic(line, 5, 3), 3.0);
+	
+	//gaussian fit needs positive values
+	qreal negative[3] = {-1, 5, 3};
+	QCOMPARE(PeakInterpolation::gaussian(negative, 3, 1), 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#ifndef TEST_PEAKINTERPOLATION_H
+#define TEST_PEAKINTERPOLATION_H
+
+#include <QtTest>
+#include "peakinterpolation.h"
+
+class TestPeakInterpolation : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void testParabolicFit();
+	void testGaussianFit();
+	void testCentroid();
+	void testFallbackToIntegerPosition();
+};
+
+#endif // TEST_PEAKINTERPOLATION_H
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "test_peaktracker.h"
+
+void TestPeakTracker::testConstantVelocity()
+{
+	PeakTracker tracker;
+	tracker.setGains(0.5, 0.2);
+	QVERIFY(!tracker.isLocked());
+	
+	//peak moves 2 samples per frame, filter has to converge to position and velocity
+	tracker.acquire(10);
+	QVERIFY(tracker.isLocked());
+	for (int i = 1; i <= 50; i++) {
+		tracker.update(10 + 2*i);
+	}
+	QVERIFY(qAbs(tracker.getPosition() - 110.0) < 1e-3);
+	QVERIFY(qAbs(tracker.getVelocity() - 2.0) < 1e-3);
+	QVERIFY(qAbs(tracker.predict() - 112.0) < 1e-3);
+}
+
+void TestPeakTracker::testLossOfLock()
+{
+	PeakTracker tracker;
+	tracker.acquire(40);
+	tracker.update(42);
+	double velocity = tracker.getVelocity();
+	
+	//tracker coasts along the prediction while the peak is missing
+	for (int i = 0; i < TRACKING_MAX_MISSES; i++) {
+		double predictedPosition = tracker.predict();
+		tracker.miss();
+		QVERIFY(tracker.isLocked());
+		QCOMPARE(tracker.getPosition(), predictedPosition);
+		QCOMPARE(tracker.getVelocity(), velocity);
+	}
+	tracker.miss();
+	QVERIFY(!tracker.isLocked());
+	
+	//next measurement acquires the peak again
+	tracker.update(7);
+	QVERIFY(tracker.isLocked());
+	QCOMPARE(tracker.getPosition(), 7.0);
+	QCOMPARE(tracker.getVelocity(), 0.0);
+}
+
+void TestPeakTracker::testWindowIgnoresArtifact()
+{
+	PeakFinder peakFinder;
+	
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.minThreshold = 0.0;
+	params.roi = QRect(0, 0, 64, 1);
+	params.showMinThreshold = false;
+	params.autoScalingEnabled = true;
+	params.multiPeakEnabled = false;
+	params.surfaceTrackingEnabled = false;
+	params.trackingEnabled = true;
+	params.trackingWindowHalfWidth = 5;
+	params.trackingAlpha = 0.5;
+	params.trackingBeta = 0.1;
+	peakFinder.setParams(params);
+	
+	QSignalSpy positionSpy(&peakFinder, &PeakFinder::peakPositionFound);
+	QSignalSpy trackingSpy(&peakFinder, &PeakFinder::peakTracked);
+	
+	//peak moves slowly to the right, a brighter artifact appears far away in the last frame
+	unsigned char frame[64];
+	for (int i = 0; i < 4; i++) {
+		memset(frame, 1, sizeof(frame));
+		frame[10 + i] = 100;
+		if (i == 3) {
+			frame[50] = 250;
+		}
+		peakFinder.findPeak(frame, 8, 64, 1);
+	}
+	
+	QCOMPARE(positionSpy.count(), 4);
+	QCOMPARE(trackingSpy.count(), 4);
+	QCOMPARE(positionSpy.at(3).at(0).toDouble(), 13.0);
+	QVERIFY(trackingSpy.at(3).at(2).toBool());
+	QVERIFY(qAbs(trackingSpy.at(3).at(0).toDouble() - 13.0) < 1.0);
+	
+	//without tracking the artifact is found
+	params.trackingEnabled = false;
+	peakFinder.setParams(params);
+	peakFinder.findPeak(frame, 8, 64, 1);
+	QCOMPARE(positionSpy.at(4).at(0).toDouble(), 50.0);
+}
\ No newline at end of file
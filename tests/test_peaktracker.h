@@ -0,0 +1,18 @@
+#ifndef TEST_PEAKTRACKER_H
+#define TEST_PEAKTRACKER_H
+
+#include <QtTest>
+#include "peaktracker.h"
+#include "peakfinder.h"
+
+class TestPeakTracker : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void testConstantVelocity();
+	void testLossOfLock();
+	void testWindowIgnoresArtifact();
+};
+
+#endif // TEST_PEAKTRACKER_H
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "test_rowaggregator.h"
+#include <algorithm>
+
+namespace {
+	//frame with a small value range in half of the columns, so many ranks share the same value, and the full range of the bit depth in the others
+	QByteArray createFrame(int bitDepth, int samplesPerLine, int linesPerFrame) {
+		int bytesPerSample = bitDepth/8;
+		QByteArray frame(samplesPerLine*linesPerFrame*bytesPerSample, 0);
+		quint32 state = 12345;
+		for (int i = 0; i < samplesPerLine*linesPerFrame; i++) {
+			state = state*1664525u + 1013904223u;
+			quint32 value = (i % samplesPerLine) % 2 == 0 ? (state >> 8) % 5 : state >> (32-bitDepth);
+			memcpy(frame.data() + i*bytesPerSample, &value, bytesPerSample);
+		}
+		return frame;
+	}
+
+	quint32 sampleAt(const QByteArray& frame, int bitDepth, int index) {
+		quint32 value = 0;
+		memcpy(&value, frame.constData() + index*(bitDepth/8), bitDepth/8);
+		return value;
+	}
+}
+
+void TestRowAggregator::testMatchesSortedColumns_data()
+{
+	QTest::addColumn<int>("bitDepth");
+	QTest::addColumn<int>("mode");
+	QList<int> bitDepths = {8, 16, 32};
+	for (int bitDepth : bitDepths) {
+		QTest::newRow(qPrintable(QString("%1 bit median").arg(bitDepth))) << bitDepth << static_cast<int>(AGGREGATION_MEDIAN);
+		QTest::newRow(qPrintable(QString("%1 bit trimmed mean").arg(bitDepth))) << bitDepth << static_cast<int>(AGGREGATION_TRIMMED_MEAN);
+		QTest::newRow(qPrintable(QString("%1 bit mean").arg(bitDepth))) << bitDepth << static_cast<int>(AGGREGATION_MEAN);
+	}
+}
+
+void TestRowAggregator::testMatchesSortedColumns()
+{
+	QFETCH(int, bitDepth);
+	QFETCH(int, mode);
+	
+	//even and odd number of rows, the median of an even number of rows is the mean of the two middle values
+	const int samplesPerLine = 37;
+	const int linesPerFrame = 60;
+	QByteArray frame = createFrame(bitDepth, samplesPerLine, linesPerFrame);
+	QList<QRect> rois = {QRect(2, 3, 33, 50), QRect(0, 1, 37, 51)};
+	RowAggregator aggregator;
+	for (const QRect& roi : rois) {
+		QVector<qreal> line(roi.width());
+		aggregator.aggregate(frame.constData(), bitDepth, samplesPerLine, roi, static_cast<ROW_AGGREGATION>(mode), 0.2, line.data());
+		
+		int trimmed = RowAggregator::trimmedRows(roi.height(), static_cast<ROW_AGGREGATION>(mode), 0.2);
+		for (int x = 0; x < roi.width(); x++) {
+			QVector<quint32> column;
+			for (int y = roi.y(); y < roi.y() + roi.height(); y++) {
+				column.append(sampleAt(frame, bitDepth, y*samplesPerLine + roi.x() + x));
+			}
+			std::sort(column.begin(), column.end());
+			qreal sum = 0;
+			for (int i = trimmed; i < column.size() - trimmed; i++) {
+				sum += column.at(i);
+			}
+			qreal expected = sum / (column.size() - 2*trimmed);
+			QVERIFY(qAbs(line.at(x) - expected) <= 1e-9*qMax(1.0, expected));
+		}
+	}
+}
+
+void TestRowAggregator::testMaxProjectionKernels_data()
+{
+	QTest::addColumn<int>("bitDepth");
+	QTest::newRow("8 bit") << 8;
+	QTest::newRow("16 bit") << 16;
+	QTest::newRow("32 bit") << 32;
+}
+
+void TestRowAggregator::testMaxProjectionKernels()
+{
+	QFETCH(int, bitDepth);
+	
+	//roi wider than the widest strip and not a multiple of it, so the scalar loop has to process the remaining columns
+	const int samplesPerLine = 211;
+	const int linesPerFrame = 40;
+	QByteArray frame = createFrame(bitDepth, samplesPerLine, linesPerFrame);
+	QRect roi(5, 3, 200, 35);
+	
+	QVector<qreal> expected(roi.width());
+	for (int x = 0; x < roi.width(); x++) {
+		for (int y = roi.y(); y < roi.y() + roi.height(); y++) {
+			expected[x] = qMax(expected.at(x), static_cast<qreal>(sampleAt(frame, bitDepth, y*samplesPerLine + roi.x() + x)));
+		}
+	}
+	
+	RowAggregator aggregator;
+	QList<SIMD_KERNEL> kernels = {KERNEL_SCALAR, KERNEL_SSE2, KERNEL_AVX2, KERNEL_AVX512};
+	for (SIMD_KERNEL kernel : kernels) {
+		if (!CpuFeatures::isSupported(kernel)) {
+			qDebug() << "Kernel not supported on this CPU:" << kernel;
+			continue;
+		}
+		QVector<qreal> line(roi.width(), -1);
+		aggregator.aggregate(frame.constData(), bitDepth, samplesPerLine, roi, AGGREGATION_MAX, 0, line.data(), kernel);
+		QCOMPARE(line, expected);
+	}
+}
+
+void TestRowAggregator::testTrimmedRows()
+{
+	QCOMPARE(RowAggregator::trimmedRows(10, AGGREGATION_MEAN, 0.3), 0);
+	QCOMPARE(RowAggregator::trimmedRows(10, AGGREGATION_MEDIAN, 0.0), 4);
+	QCOMPARE(RowAggregator::trimmedRows(11, AGGREGATION_MEDIAN, 0.0), 5);
+	QCOMPARE(RowAggregator::trimmedRows(10, AGGREGATION_TRIMMED_MEAN, 0.25), 2);
+	
+	//at least one rank is kept
+	QCOMPARE(RowAggregator::trimmedRows(10, AGGREGATION_TRIMMED_MEAN, 0.5), 4);
+	QCOMPARE(RowAggregator::trimmedRows(1, AGGREGATION_MEDIAN, 0.0), 0);
+}
+
+void TestRowAggregator::testMedianIgnoresSaturatedLine()
+{
+	//peak at sample 20 in all lines, one saturated line has its maximum at sample 5 and dominates the mean
+	const unsigned int samplesPerLine = 32;
+	const unsigned int linesPerFrame = 9;
+	QVector<quint16> frame(samplesPerLine*linesPerFrame, 100);
+	for (unsigned int y = 0; y < linesPerFrame; y++) {
+		frame[y*samplesPerLine + 20] = 1000;
+	}
+	for (unsigned int x = 0; x < samplesPerLine; x++) {
+		frame[4*samplesPerLine + x] = 4095;
+	}
+	frame[4*samplesPerLine + 5] = 65535;
+	
+	PeakFinder peakFinder;
+	PeakDetectorParameters params;
+	params.feature = MAXVALUE;
+	params.minThreshold = 0.0;
+	params.roi = QRect(0, 0, samplesPerLine, linesPerFrame);
+	params.rowAggregation = AGGREGATION_MEAN;
+	peakFinder.setParams(params);
+	
+	QSignalSpy spy(&peakFinder, &PeakFinder::peakPositionFound);
+	peakFinder.findPeak(frame.data(), 16, samplesPerLine, linesPerFrame);
+	
+	params.rowAggregation = AGGREGATION_MEDIAN;
+	peakFinder.setParams(params);
+	peakFinder.findPeak(frame.data(), 16, samplesPerLine, linesPerFrame);
+	
+	QCOMPARE(spy.count(), 2);
+	QCOMPARE(spy.at(0).at(0).toDouble(), 5.0);
+	QCOMPARE(spy.at(1).at(0).toDouble(), 20.0);
+}
\ No newline at end of file
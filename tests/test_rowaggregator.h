@@ -0,0 +1,21 @@
+#ifndef TEST_ROWAGGREGATOR_H
+#define TEST_ROWAGGREGATOR_H
+
+#include <QtTest>
+#include "rowaggregator.h"
+#include "peakfinder.h"
+
+class TestRowAggregator : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void testMatchesSortedColumns_data();
+	void testMatchesSortedColumns();
+	void testMaxProjectionKernels_data();
+	void testMaxProjectionKernels();
+	void testTrimmedRows();
+	void testMedianIgnoresSaturatedLine();
+};
+
+#endif // TEST_ROWAGGREGATOR_H
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "test_syntheticframegenerator.h"
+
+void TestSyntheticFrameGenerator::testBufferLayout()
+{
+	SyntheticFrameParameters params = SyntheticFrameParameters::defaults(12, 64, 16);
+	params.framesPerBuffer = 3;
+	params.buffersPerVolume = 2;
+	SyntheticFrameGenerator generator(params);
+	
+	//12-bit samples are stored in two bytes, like in the buffers of processedDataReceived
+	QCOMPARE(generator.getBytesPerSample(), static_cast<size_t>(2));
+	QCOMPARE(generator.getBytesPerFrame(), static_cast<size_t>(64*16*2));
+	QByteArray buffer = generator.generateBuffer();
+	QCOMPARE(static_cast<size_t>(buffer.size()), generator.getBytesPerBuffer());
+	QCOMPARE(generator.getFrameNr(), static_cast<quint64>(3));
+	QCOMPARE(generator.getCurrentBufferNr(), 0u);
+	generator.generateBuffer();
+	QCOMPARE(generator.getCurrentBufferNr(), 1u);
+	generator.generateBuffer();
+	QCOMPARE(generator.getCurrentBufferNr(), 0u);
+	
+	//second frame of the buffer is the same as a frame that is generated on its own
+	QByteArray frame(static_cast<int>(generator.getBytesPerFrame()), 0);
+	generator.generateFrame(1, frame.data());
+	QCOMPARE(buffer.mid(frame.size(), frame.size()), frame);
+	
+	const quint16* samples = reinterpret_cast<const quint16*>(buffer.constData());
+	for (int i = 0; i < buffer.size()/2; i++) {
+		QVERIFY(samples[i] <= 4095);
+	}
+}
+
+void TestSyntheticFrameGenerator::testDeterministicFrames()
+{
+	SyntheticFrameParameters params = SyntheticFrameParameters::defaults(16, 128, 32);
+	SyntheticFrameGenerator first(params);
+	SyntheticFrameGenerator second(params);
+	QByteArray firstBuffer = first.generateBuffer();
+	QCOMPARE(second.generateBuffer(), firstBuffer);
+	
+	//frames differ by their speckle and noise, a different seed gives different frames
+	QVERIFY(first.generateBuffer() != firstBuffer);
+	params.seed = 2;
+	SyntheticFrameGenerator third(params);
+	QVERIFY(third.generateBuffer() != firstBuffer);
+	
+	//reset restarts the sequence
+	first.reset();
+	QCOMPARE(first.generateBuffer(), firstBuffer);
+}
+
+void TestSyntheticFrameGenerator::testSaturation()
+{
+	SyntheticFrameParameters params = SyntheticFrameParameters::defaults(8, 64, 4);
+	params.reflectors[0].depth = 20.0;
+	params.reflectors[0].amplitude = 3.0;
+	params.noiseSigma = 0.0;
+	params.speckleContrast = 0.0;
+	SyntheticFrameGenerator generator(params);
+	QByteArray buffer = generator.generateBuffer();
+	const quint8* samples = reinterpret_cast<const quint8*>(buffer.constData());
+	
+	//reflector is clipped to a plateau, the background is the noise floor
+	for (int y = 0; y < 4; y++) {
+		QCOMPARE(samples[y*64 + 19], static_cast<quint8>(255));
+		QCOMPARE(samples[y*64 + 20], static_cast<quint8>(255));
+		QCOMPARE(samples[y*64 + 21], static_cast<quint8>(255));
+		QCOMPARE(samples[y*64], static_cast<quint8>(qRound(0.1*255)));
+	}
+}
+
+void TestSyntheticFrameGenerator::testMotionTrajectory()
+{
+	SyntheticFrameParameters params = SyntheticFrameParameters::defaults(16, 256, 8);
+	params.motionAmplitude = 10.0;
+	params.motionPeriod = 4.0;
+	SyntheticFrameGenerator generator(params);
+	QCOMPARE(generator.groundTruthPeak(3), 64.0);
+	
+	params.motion = MOTION_LINEAR;
+	generator.setParameters(params);
+	QCOMPARE(generator.groundTruthPeak(2), 69.0);
+	
+	params.motion = MOTION_SINE;
+	generator.setParameters(params);
+	QVERIFY(qAbs(generator.groundTruthPeak(1) - 74.0) < 1e-9);
+	QVERIFY(qAbs(generator.groundTruthPeak(3) - 54.0) < 1e-9);
+	
+	params.motion = MOTION_STEP;
+	generator.setParameters(params);
+	QCOMPARE(generator.groundTruthPeak(3), 64.0);
+	QCOMPARE(generator.groundTruthPeak(4), 74.0);
+	QCOMPARE(generator.groundTruthPeak(8), 64.0);
+	
+	//strongest reflector defines the peak
+	SyntheticReflector weak;
+	weak.depth = 200.0;
+	weak.amplitude = 0.3;
+	weak.width = 2.0;
+	params.reflectors.append(weak);
+	params.motion = MOTION_NONE;
+	generator.setParameters(params);
+	QCOMPARE(generator.groundTruthPeak(0), 64.0);
+	QCOMPARE(generator.reflectorDepth(1, 0), 200.0);
+}
+
+void TestSyntheticFrameGenerator::testGroundTruthPeak_data()
+{
+	QTest::addColumn<int>("bitDepth");
+	QTest::newRow("8 bit") << 8;
+	QTest::newRow("12 bit") << 12;
+	QTest::newRow("16 bit") << 16;
+	QTest::newRow("32 bit") << 32;
+}
+
+void TestSyntheticFrameGenerator::testGroundTruthPeak()
+{
+	QFETCH(int, bitDepth);
+	
+	SyntheticFrameParameters frameParams = SyntheticFrameParameters::defaults(bitDepth, 512, 128);
+	frameParams.framesPerBuffer = 4;
+	frameParams.motion = MOTION_SINE;
+	frameParams.motionAmplitude = 20.0;
+	frameParams.motionPeriod = 10.0;
+	SyntheticFrameGenerator generator(frameParams);
+	
+	PeakFinder peakFinder;
+	PeakDetectorParameters params;
+	params.feature = GAUSSIAN_FIT;
+	params.minThreshold = 0.0;
+	params.roi = QRect(0, 0, 512, 128);
+	peakFinder.setParams(params);
+	
+	//the averaged speckle pattern follows the moving reflector with sub-sample accuracy
+	double positions[4];
+	double amplitudes[4];
+	quint8 flags[4];
+	for (int buffer = 0; buffer < 5; buffer++) {
+		QByteArray data = generator.generateBuffer();
+		FrameView view = FrameView::fullFrame(data.constData(), bitDepth, 512, 128);
+		QCOMPARE(peakFinder.findPeaksInFrames(view, 4, generator.getBytesPerFrame(), positions, amplitudes, flags), 4);
+		for (int i = 0; i < 4; i++) {
+			double groundTruth = generator.groundTruthPeak(generator.getFrameNr() - 4 + i);
+			QVERIFY2(qAbs(positions[i] - groundTruth) < 0.5, qPrintable(QString("position %1, ground truth %2").arg(positions[i]).arg(groundTruth)));
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#ifndef TEST_SYNTHETICFRAMEGENERATOR_H
+#define TEST_SYNTHETICFRAMEGENERATOR_H
+
+#include <QtTest>
+#include "syntheticframegenerator.h"
+#include "peakfinder.h"
+
+class TestSyntheticFrameGenerator : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void testBufferLayout();
+	void testDeterministicFrames();
+	void testSaturation();
+	void testMotionTrajectory();
+	void testGroundTruthPeak_data();
+	void testGroundTruthPeak();
+};
+
+#endif // TEST_SYNTHETICFRAMEGENERATOR_H
\ No newline at end of file
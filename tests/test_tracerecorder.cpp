@@ -0,0 +1,126 @@
+#include "test_tracerecorder.h"
+#include <QThreadPool>
+#include <QRunnable>
+
+//traces the given number of scopes in a thread of the pool
+class TracingTask : public QRunnable
+{
+public:
+	TracingTask(int scopes) : scopes(scopes) {}
+	void run() override {
+		for (int i = 0; i < this->scopes; i++) {
+			TRACE_SCOPE("TracingTask::run");
+		}
+	}
+
+private:
+	int scopes;
+};
+
+void TestTraceRecorder::testDisabledRecordsNothing()
+{
+	TraceRecorder::setEnabled(true);
+	TraceRecorder::setEnabled(false);
+	QVERIFY(!TraceRecorder::isEnabled());
+	{
+		TRACE_SCOPE("disabled");
+	}
+	QCOMPARE(TraceRecorder::getEventCount(), Q_UINT64_C(0));
+}
+
+void TestTraceRecorder::testNestedScopes()
+{
+	TraceRecorder::setEnabled(true);
+	{
+		TRACE_SCOPE("outer");
+		{
+			TRACE_SCOPE("inner");
+		}
+	}
+	QCOMPARE(TraceRecorder::getThreadCount(), 1);
+	QCOMPARE(TraceRecorder::getEventCount(), Q_UINT64_C(4));
+	
+	//events appear in recording order, inner scope is closed before the outer one
+	QString json;
+	{
+		QTextStream stream(&json);
+		TraceRecorder::writeChromeTrace(stream);
+	}
+	QVERIFY(json.startsWith("{\"traceEvents\":["));
+	QVERIFY(json.contains("\"ph\":\"M\""));
+	int outerBegin = json.indexOf("{\"name\":\"outer\",\"ph\":\"B\"");
+	int innerBegin = json.indexOf("{\"name\":\"inner\",\"ph\":\"B\"");
+	int innerEnd = json.indexOf("{\"name\":\"inner\",\"ph\":\"E\"");
+	int outerEnd = json.indexOf("{\"name\":\"outer\",\"ph\":\"E\"");
+	QVERIFY(outerBegin >= 0);
+	QVERIFY(innerBegin > outerBegin);
+	QVERIFY(innerEnd > innerBegin);
+	QVERIFY(outerEnd > innerEnd);
+	QVERIFY(json.trimmed().endsWith("}"));
+}
+
+void TestTraceRecorder::testRingKeepsLatestEvents()
+{
+	TraceRecorder::setEnabled(true);
+	for (int i = 0; i < TRACE_EVENTS_PER_THREAD; i++) {
+		TRACE_SCOPE("old");
+	}
+	TRACE_SCOPE("latest");
+	QCOMPARE(TraceRecorder::getEventCount(), static_cast<quint64>(TRACE_EVENTS_PER_THREAD));
+	QString json;
+	{
+		QTextStream stream(&json);
+		TraceRecorder::writeChromeTrace(stream);
+	}
+	QVERIFY(json.contains("{\"name\":\"latest\",\"ph\":\"B\""));
+}
+
+void TestTraceRecorder::testRingPerThread()
+{
+	TraceRecorder::setEnabled(true);
+	QThreadPool pool;
+	pool.setMaxThreadCount(3);
+	for (int i = 0; i < 3; i++) {
+		pool.start(new TracingTask(100));
+	}
+	pool.waitForDone();
+	
+	//pool threads may run more than one task, every thread that traced has its own ring
+	QVERIFY(TraceRecorder::getThreadCount() >= 1);
+	QVERIFY(TraceRecorder::getThreadCount() <= 3);
+	QCOMPARE(TraceRecorder::getEventCount(), Q_UINT64_C(600));
+}
+
+void TestTraceRecorder::testScopeAcrossSessions()
+{
+	//a scope that is still open when tracing is disabled or enabled again does not leave an unmatched end event
+	TraceRecorder::setEnabled(true);
+	{
+		TRACE_SCOPE("disabled");
+		TraceRecorder::setEnabled(false);
+	}
+	QCOMPARE(TraceRecorder::getEventCount(), Q_UINT64_C(1));
+	{
+		TRACE_SCOPE("previous");
+		TraceRecorder::setEnabled(true);
+		TraceRecorder::setEnabled(false);
+		TraceRecorder::setEnabled(true);
+		{
+			TRACE_SCOPE("current");
+		}
+	}
+	QCOMPARE(TraceRecorder::getEventCount(), Q_UINT64_C(2));
+	QString json;
+	{
+		QTextStream stream(&json);
+		TraceRecorder::writeChromeTrace(stream);
+	}
+	QVERIFY(!json.contains("\"disabled\""));
+	QVERIFY(!json.contains("\"previous\""));
+	QVERIFY(json.contains("{\"name\":\"current\",\"ph\":\"E\""));
+}
+
+void TestTraceRecorder::cleanup()
+{
+	TraceRecorder::setEnabled(false);
+}
\ No newline at end of file
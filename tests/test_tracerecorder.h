@@ -0,0 +1,20 @@
+#ifndef TEST_TRACERECORDER_H
+#define TEST_TRACERECORDER_H
+
+#include <QtTest>
+#include "tracerecorder.h"
+
+class TestTraceRecorder : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void testDisabledRecordsNothing();
+	void testNestedScopes();
+	void testRingKeepsLatestEvents();
+	void testRingPerThread();
+	void testScopeAcrossSessions();
+	void cleanup();
+};
+
+#endif // TEST_TRACERECORDER_H
\ No newline at end of file
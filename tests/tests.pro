@@ -2,22 +2,48 @@ QT += core gui widgets testlib
 TARGET = peakdetector-tests
 TEMPLATE = app
 
-# Path to plugin source
-SRCDIR = $$shell_path($$PWD/../src)
-
-INCLUDEPATH += \
-	$$SRCDIR
+include($$PWD/../src/processing.pri)
+include($$PWD/common/common.pri)
 
 SOURCES += \
 	main.cpp \
 	test_peakfinder.cpp \
 	test_bitdepthconverter.cpp \
-	$$SRCDIR/peakfinder.cpp \
-	$$SRCDIR/bitdepthconverter.cpp
+	test_frameringbuffer.cpp \
+	test_decimationscheduler.cpp \
+	test_columnaccumulator.cpp \
+	test_cpufeatures.cpp \
+	test_peakinterpolation.cpp \
+	test_multipeaksearch.cpp \
+	test_linepeaksearch.cpp \
+	test_peaktracker.cpp \
+	test_linefilter.cpp \
+	test_rowaggregator.cpp \
+	test_columnintegraltable.cpp \
+	test_multiroiaccumulator.cpp \
+	test_noisefloorestimator.cpp \
+	test_latencymonitor.cpp \
+	test_tracerecorder.cpp \
+	test_syntheticframegenerator.cpp \
+	common/testpattern.cpp
 
 HEADERS += \
 	test_peakfinder.h \
 	test_bitdepthconverter.h \
-	$$SRCDIR/peakfinder.h \
-	$$SRCDIR/bitdepthconverter.h \
-	$$SRCDIR/peakdetectorparameters.h
+	test_frameringbuffer.h \
+	test_decimationscheduler.h \
+	test_columnaccumulator.h \
+	test_cpufeatures.h \
+	test_peakinterpolation.h \
+	test_multipeaksearch.h \
+	test_linepeaksearch.h \
+	test_peaktracker.h \
+	test_linefilter.h \
+	test_rowaggregator.h \
+	test_columnintegraltable.h \
+	test_multiroiaccumulator.h \
+	test_noisefloorestimator.h \
+	test_latencymonitor.h \
+	test_tracerecorder.h \
+	test_syntheticframegenerator.h \
+	common/testpattern.h